@@ -0,0 +1,235 @@
+/*
+ * Display Idle Manager Component
+ *
+ * Drives the LCD backlight through LEDC PWM and turns the display dark after a
+ * period without touch input. The inactivity check is a single LVGL timer whose
+ * period is stretched to the remaining timeout, so it costs one wakeup per
+ * timeout rather than a periodic poll, and it is paused while the display is dark.
+ */
+
+#include "display_idle.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "driver/ledc.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+
+static const char *TAG = "display_idle";
+
+#define DISPLAY_IDLE_LEDC_MODE      LEDC_LOW_SPEED_MODE
+#define DISPLAY_IDLE_LEDC_TIMER     LEDC_TIMER_0
+#define DISPLAY_IDLE_LEDC_CHANNEL   LEDC_CHANNEL_0
+#define DISPLAY_IDLE_LEDC_RES       LEDC_TIMER_13_BIT
+#define DISPLAY_IDLE_LEDC_FREQ_HZ   5000
+#define DISPLAY_IDLE_DUTY_MAX       ((1 << 13) - 1)
+#define DISPLAY_IDLE_TIMEOUT_MS     (CONFIG_EXAMPLE_LCD_IDLE_TIMEOUT_S * 1000)
+
+static bool backlight_ready = false;
+static lv_display_t *idle_disp = NULL;
+static lv_timer_t *idle_timer = NULL;
+static display_idle_suspend_cb_t suspend_cb = NULL;
+static void *suspend_cb_arg = NULL;
+
+static volatile bool is_dark = false;
+static uint32_t dim_count = 0;
+static int64_t dark_start_us = 0;
+static int64_t dark_total_us = 0;
+static int64_t init_us = 0;
+
+static uint32_t percent_to_duty(uint32_t percent)
+{
+    if (percent > 100) {
+        percent = 100;
+    }
+    return (DISPLAY_IDLE_DUTY_MAX * percent) / 100;
+}
+
+/**
+ * @brief Configure the backlight pin as an LEDC PWM output (starts with the backlight off)
+ */
+esp_err_t display_idle_backlight_init(int gpio_num, int on_level)
+{
+    ledc_timer_config_t timer_config = {
+        .speed_mode = DISPLAY_IDLE_LEDC_MODE,
+        .duty_resolution = DISPLAY_IDLE_LEDC_RES,
+        .timer_num = DISPLAY_IDLE_LEDC_TIMER,
+        .freq_hz = DISPLAY_IDLE_LEDC_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    esp_err_t ret = ledc_timer_config(&timer_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure LEDC timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ledc_channel_config_t channel_config = {
+        .gpio_num = gpio_num,
+        .speed_mode = DISPLAY_IDLE_LEDC_MODE,
+        .channel = DISPLAY_IDLE_LEDC_CHANNEL,
+        .timer_sel = DISPLAY_IDLE_LEDC_TIMER,
+        .duty = 0,
+        .hpoint = 0,
+        .flags.output_invert = on_level ? 0 : 1,
+    };
+    ret = ledc_channel_config(&channel_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure LEDC channel: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to install LEDC fade: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    init_us = esp_timer_get_time();
+    backlight_ready = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief Set the backlight brightness immediately
+ */
+void display_idle_backlight_set(uint32_t percent)
+{
+    if (!backlight_ready) {
+        return;
+    }
+    // Cancel a fade in progress, otherwise it would keep overwriting the duty
+    ledc_fade_stop(DISPLAY_IDLE_LEDC_MODE, DISPLAY_IDLE_LEDC_CHANNEL);
+    ledc_set_duty_and_update(DISPLAY_IDLE_LEDC_MODE, DISPLAY_IDLE_LEDC_CHANNEL, percent_to_duty(percent), 0);
+}
+
+/**
+ * @brief Fade out the backlight and let clients suspend their UI work
+ */
+static void display_idle_go_dark(void)
+{
+    is_dark = true;
+    dim_count++;
+    dark_start_us = esp_timer_get_time();
+
+    if (backlight_ready) {
+        ledc_set_fade_with_time(DISPLAY_IDLE_LEDC_MODE, DISPLAY_IDLE_LEDC_CHANNEL, 0, CONFIG_EXAMPLE_LCD_IDLE_FADE_MS);
+        ledc_fade_start(DISPLAY_IDLE_LEDC_MODE, DISPLAY_IDLE_LEDC_CHANNEL, LEDC_FADE_NO_WAIT);
+    }
+    if (suspend_cb != NULL) {
+        suspend_cb(true, suspend_cb_arg);
+    }
+
+    int64_t uptime_us = dark_start_us - init_us;
+    ESP_LOGI(TAG, "Display dark (#%" PRIu32 "), dark %" PRId64 " s of %" PRId64 " s uptime so far",
+             dim_count, dark_total_us / 1000000, uptime_us / 1000000);
+}
+
+/**
+ * @brief Restore the backlight and resume client UI work
+ */
+static void display_idle_wake(void)
+{
+    int64_t dark_us = esp_timer_get_time() - dark_start_us;
+    dark_total_us += dark_us;
+    is_dark = false;
+
+    display_idle_backlight_set(CONFIG_EXAMPLE_LCD_BACKLIGHT_DUTY_PCT);
+    if (suspend_cb != NULL) {
+        suspend_cb(false, suspend_cb_arg);
+    }
+    if (idle_disp != NULL) {
+        lv_display_trigger_activity(idle_disp);
+    }
+    if (idle_timer != NULL) {
+        lv_timer_set_period(idle_timer, DISPLAY_IDLE_TIMEOUT_MS);
+        lv_timer_reset(idle_timer);
+        lv_timer_resume(idle_timer);
+    }
+
+    ESP_LOGI(TAG, "Display awake after %" PRId64 " ms dark", dark_us / 1000);
+}
+
+/**
+ * @brief LVGL timer - goes dark once the display has been inactive for the timeout
+ */
+static void idle_timer_cb(lv_timer_t *timer)
+{
+    uint32_t inactive_ms = lv_display_get_inactive_time(idle_disp);
+    if (inactive_ms >= DISPLAY_IDLE_TIMEOUT_MS) {
+        lv_timer_pause(timer);
+        display_idle_go_dark();
+    } else {
+        // Touched since the timer was armed - sleep for the rest of the timeout only
+        lv_timer_set_period(timer, DISPLAY_IDLE_TIMEOUT_MS - inactive_ms);
+    }
+}
+
+/**
+ * @brief Start watching the display for inactivity
+ */
+esp_err_t display_idle_start(lv_display_t *disp)
+{
+    idle_disp = disp;
+    if (DISPLAY_IDLE_TIMEOUT_MS == 0) {
+        ESP_LOGI(TAG, "Idle dimming disabled");
+        return ESP_OK;
+    }
+
+    idle_timer = lv_timer_create(idle_timer_cb, DISPLAY_IDLE_TIMEOUT_MS, NULL);
+    if (idle_timer == NULL) {
+        ESP_LOGE(TAG, "Failed to create idle timer");
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Display goes dark after %d s without touch", CONFIG_EXAMPLE_LCD_IDLE_TIMEOUT_S);
+    return ESP_OK;
+}
+
+/**
+ * @brief Register the suspend/resume callback (one client)
+ */
+void display_idle_set_suspend_callback(display_idle_suspend_cb_t cb, void *arg)
+{
+    suspend_cb = cb;
+    suspend_cb_arg = arg;
+}
+
+/**
+ * @brief Report a touch press; wakes a dark display
+ */
+bool display_idle_touch(void)
+{
+    if (!is_dark) {
+        return false;
+    }
+    display_idle_wake();
+    return true;
+}
+
+/**
+ * @brief Check whether the display is currently dark
+ */
+bool display_idle_is_dark(void)
+{
+    return is_dark;
+}
+
+/**
+ * @brief Get idle statistics
+ */
+void display_idle_get_stats(display_idle_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    int64_t dark_us = dark_total_us;
+    if (is_dark) {
+        dark_us += now - dark_start_us;
+    }
+    stats->dark = is_dark;
+    stats->dim_count = dim_count;
+    stats->dark_ms = (uint64_t)(dark_us / 1000);
+    stats->uptime_ms = (uint64_t)((now - init_us) / 1000);
+}
@@ -0,0 +1,95 @@
+/*
+ * Display Idle Manager Component Header
+ *
+ * Drives the LCD backlight through LEDC PWM and turns the display dark after a
+ * period without touch input. While dark, registered clients suspend their
+ * periodic UI work so LVGL has nothing to render; the first touch restores the
+ * backlight and resumes rendering.
+ */
+
+#ifndef DISPLAY_IDLE_H
+#define DISPLAY_IDLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Called from LVGL context when the display goes dark (true) or wakes up (false)
+ */
+typedef void (*display_idle_suspend_cb_t)(bool suspended, void *arg);
+
+/**
+ * @brief Idle statistics (since boot)
+ */
+typedef struct {
+    bool dark;              // Display is currently dark
+    uint32_t dim_count;     // Number of times the display went dark
+    uint64_t dark_ms;       // Total time spent dark, including the current period
+    uint64_t uptime_ms;     // Time since display_idle_backlight_init()
+} display_idle_stats_t;
+
+/**
+ * @brief Configure the backlight pin as an LEDC PWM output (starts with the backlight off)
+ *
+ * @param gpio_num Backlight GPIO
+ * @param on_level GPIO level that turns the backlight on
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t display_idle_backlight_init(int gpio_num, int on_level);
+
+/**
+ * @brief Set the backlight brightness immediately
+ *
+ * @param percent Brightness in percent (0-100)
+ */
+void display_idle_backlight_set(uint32_t percent);
+
+/**
+ * @brief Start watching the display for inactivity
+ *
+ * Creates an LVGL timer, so call it before the LVGL task starts or with the LVGL lock held.
+ * Does nothing when CONFIG_EXAMPLE_LCD_IDLE_TIMEOUT_S is 0.
+ *
+ * @param disp Display whose input devices count as activity
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the timer could not be created
+ */
+esp_err_t display_idle_start(lv_display_t *disp);
+
+/**
+ * @brief Register the suspend/resume callback (one client)
+ *
+ * @param cb Callback function (can be NULL)
+ * @param arg User data for callback
+ */
+void display_idle_set_suspend_callback(display_idle_suspend_cb_t cb, void *arg);
+
+/**
+ * @brief Report a touch press (LVGL context, from the input device read callback)
+ *
+ * @return true if the press woke a dark display and should not reach the widgets
+ */
+bool display_idle_touch(void);
+
+/**
+ * @brief Check whether the display is currently dark
+ */
+bool display_idle_is_dark(void);
+
+/**
+ * @brief Get idle statistics
+ *
+ * @param stats Output structure
+ */
+void display_idle_get_stats(display_idle_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_IDLE_H
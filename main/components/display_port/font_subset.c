@@ -0,0 +1,151 @@
+/*
+ * Font Subset Component
+ *
+ * Wraps the build-generated font_subset_14 (see main/CMakeLists.txt) in a copy
+ * whose bitmap callback keeps the decoded A8 bitmap of each glyph. The
+ * built-in format stores glyphs at 4 bpp and expands them into a draw buffer
+ * each time a letter is drawn; with the cache a countdown tick only decodes a
+ * glyph the first time it appears.
+ */
+
+#include "font_subset.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "lvgl.h"
+#include "esp_log.h"
+
+static const char *TAG = "font_subset";
+
+static font_subset_stats_t cache_stats;
+
+#if CONFIG_EXAMPLE_LVGL_FONT_SUBSET
+extern const lv_font_t font_subset_14;
+
+typedef struct {
+    uint32_t glyph_id;
+    lv_draw_buf_t *bitmap;  // A8, box_w x box_h of the glyph
+} font_subset_cache_entry_t;
+
+static lv_font_t cached_font;
+static bool cached_font_ready = false;
+static font_subset_cache_entry_t glyph_cache[FONT_SUBSET_CACHE_SLOTS];
+
+/**
+ * @brief Bitmap callback - serve decoded glyphs from the cache, decode into it on a miss
+ */
+static const void *cached_get_glyph_bitmap(lv_font_glyph_dsc_t *g_dsc, lv_draw_buf_t *draw_buf)
+{
+    uint32_t glyph_id = g_dsc->gid.index;
+    if (g_dsc->box_w == 0 || g_dsc->box_h == 0) {
+        return lv_font_get_bitmap_fmt_txt(g_dsc, draw_buf);
+    }
+
+    // One slot per glyph id, so glyphs never evict each other; ids past the
+    // table (a subset grown without resizing it) are decoded every time
+    if (glyph_id >= FONT_SUBSET_CACHE_SLOTS) {
+        cache_stats.misses++;
+        return lv_font_get_bitmap_fmt_txt(g_dsc, draw_buf);
+    }
+    font_subset_cache_entry_t *entry = &glyph_cache[glyph_id];
+    if (entry->bitmap != NULL && entry->glyph_id == glyph_id) {
+        cache_stats.hits++;
+        return entry->bitmap;
+    }
+    cache_stats.misses++;
+
+    if (entry->bitmap != NULL &&
+        (entry->bitmap->header.w != g_dsc->box_w || entry->bitmap->header.h != g_dsc->box_h)) {
+        lv_draw_buf_destroy(entry->bitmap);
+        entry->bitmap = NULL;
+    }
+    if (entry->bitmap == NULL) {
+        entry->bitmap = lv_draw_buf_create(g_dsc->box_w, g_dsc->box_h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+        if (entry->bitmap == NULL) {
+            // Out of LVGL heap - decode into the caller's buffer as usual
+            return lv_font_get_bitmap_fmt_txt(g_dsc, draw_buf);
+        }
+    }
+    entry->glyph_id = glyph_id;
+    return lv_font_get_bitmap_fmt_txt(g_dsc, entry->bitmap);
+}
+#endif
+
+/**
+ * @brief Get the font for numeric/status labels
+ */
+const lv_font_t *font_subset_get(void)
+{
+#if CONFIG_EXAMPLE_LVGL_FONT_SUBSET
+    if (!cached_font_ready) {
+        cached_font = font_subset_14;
+        cached_font.get_glyph_bitmap = cached_get_glyph_bitmap;
+        cached_font.fallback = &lv_font_montserrat_14;
+        cached_font_ready = true;
+    }
+    return &cached_font;
+#else
+    return &lv_font_montserrat_14;
+#endif
+}
+
+/**
+ * @brief Count glyphs and flash bytes of a built-in format font
+ */
+static void font_footprint(const lv_font_t *font, uint32_t *glyphs, uint32_t *bytes)
+{
+    const lv_font_fmt_txt_dsc_t *dsc = (const lv_font_fmt_txt_dsc_t *)font->dsc;
+    uint32_t glyph_count = 0;
+    for (uint16_t i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t *cmap = &dsc->cmaps[i];
+        bool sparse = cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL;
+        uint32_t end = cmap->glyph_id_start + (sparse ? cmap->list_length : cmap->range_length);
+        if (end > glyph_count) {
+            glyph_count = end;
+        }
+    }
+
+    // Glyph 0 is reserved; the bitmap ends after the glyph stored last
+    uint32_t bitmap_bytes = 0;
+    for (uint32_t gid = 1; gid < glyph_count; gid++) {
+        const lv_font_fmt_txt_glyph_dsc_t *g = &dsc->glyph_dsc[gid];
+        uint32_t end = g->bitmap_index + (g->box_w * g->box_h * dsc->bpp + 7) / 8;
+        if (end > bitmap_bytes) {
+            bitmap_bytes = end;
+        }
+    }
+
+    *glyphs = glyph_count > 0 ? glyph_count - 1 : 0;
+    *bytes = bitmap_bytes + glyph_count * sizeof(lv_font_fmt_txt_glyph_dsc_t);
+}
+
+/**
+ * @brief Log glyph count and flash footprint of the subset and of lv_font_montserrat_14
+ */
+void font_subset_log_flash_usage(void)
+{
+    uint32_t glyphs = 0;
+    uint32_t bytes = 0;
+    font_footprint(&lv_font_montserrat_14, &glyphs, &bytes);
+    ESP_LOGI(TAG, "montserrat_14: %" PRIu32 " glyphs, %" PRIu32 " bytes bitmap + descriptors", glyphs, bytes);
+#if CONFIG_EXAMPLE_LVGL_FONT_SUBSET
+    font_footprint(&font_subset_14, &glyphs, &bytes);
+    ESP_LOGI(TAG, "font_subset_14: %" PRIu32 " glyphs, %" PRIu32 " bytes bitmap + descriptors, %d-slot glyph cache",
+             glyphs, bytes, FONT_SUBSET_CACHE_SLOTS);
+    if (glyphs >= FONT_SUBSET_CACHE_SLOTS) {
+        ESP_LOGW(TAG, "Glyph cache smaller than the subset, raise FONT_SUBSET_CACHE_SLOTS to %" PRIu32, glyphs + 1);
+    }
+#endif
+}
+
+/**
+ * @brief Get glyph cache counters
+ */
+void font_subset_get_stats(font_subset_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    *stats = cache_stats;
+}
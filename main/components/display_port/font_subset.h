@@ -0,0 +1,59 @@
+/*
+ * Font Subset Component Header
+ *
+ * Compact 14 px font holding only the characters the numeric labels use
+ * (countdown, current reading, IP address), generated at build time, with a
+ * cache holding the decoded bitmap of every glyph it has drawn, so a digit
+ * change does not expand the same glyphs again on every redraw.
+ */
+
+#ifndef FONT_SUBSET_H
+#define FONT_SUBSET_H
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One slot per glyph id of the subset: 22 glyphs plus the reserved id 0.
+// Keep in step with font_subset_range in main/CMakeLists.txt.
+#define FONT_SUBSET_CACHE_SLOTS 23
+
+/**
+ * @brief Glyph cache counters
+ */
+typedef struct {
+    uint32_t hits;      // Bitmaps served from the cache
+    uint32_t misses;    // Bitmaps decoded from flash
+} font_subset_stats_t;
+
+/**
+ * @brief Get the font for numeric/status labels
+ * 
+ * Returns the cached subset font when CONFIG_EXAMPLE_LVGL_FONT_SUBSET is enabled,
+ * lv_font_montserrat_14 otherwise. Characters missing from the subset fall back
+ * to lv_font_montserrat_14. LVGL context only.
+ * 
+ * @return const lv_font_t* Font to use for numeric labels
+ */
+const lv_font_t *font_subset_get(void);
+
+/**
+ * @brief Log glyph count and flash footprint of the subset and of lv_font_montserrat_14
+ */
+void font_subset_log_flash_usage(void);
+
+/**
+ * @brief Get glyph cache counters
+ * 
+ * @param stats Output structure
+ */
+void font_subset_get_stats(font_subset_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FONT_SUBSET_H
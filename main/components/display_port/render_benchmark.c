@@ -0,0 +1,169 @@
+/*
+ * Render Benchmark Component
+ *
+ * Boot-time benchmark screen that times full-screen redraws and small
+ * incremental updates with the active LVGL render buffer configuration.
+ * The screen mimics the dashboard (six buttons with countdown bars) so the
+ * numbers are comparable between the partial, PSRAM and direct modes.
+ */
+
+#include "render_benchmark.h"
+#include <stdint.h>
+#include <inttypes.h>
+#include "lvgl.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "font_subset.h"
+
+static const char *TAG = "render_bench";
+
+#define RENDER_BENCHMARK_FULL_ROUNDS   10
+#define RENDER_BENCHMARK_INCR_ROUNDS   30
+#define RENDER_BENCHMARK_TILES         6
+#define RENDER_BENCHMARK_LABEL_ROUNDS  30
+
+typedef struct {
+    int64_t total_us;
+    int64_t max_us;
+    uint32_t rounds;
+} render_benchmark_result_t;
+
+static lv_obj_t *bench_screen = NULL;
+static lv_obj_t *prev_screen = NULL;
+
+/**
+ * @brief Render and flush everything that is invalid, and record how long it took
+ */
+static void refresh_timed(lv_display_t *disp, render_benchmark_result_t *result)
+{
+    int64_t start = esp_timer_get_time();
+    lv_refr_now(disp);
+    int64_t elapsed = esp_timer_get_time() - start;
+    result->total_us += elapsed;
+    result->rounds++;
+    if (elapsed > result->max_us) {
+        result->max_us = elapsed;
+    }
+}
+
+/**
+ * @brief Build dashboard-like content: a grid of buttons with bars, plus a counter label
+ */
+static lv_obj_t *create_content(lv_obj_t *screen)
+{
+    lv_obj_set_style_bg_color(screen, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_PART_MAIN);
+
+    static const lv_align_t aligns[RENDER_BENCHMARK_TILES] = {
+        LV_ALIGN_TOP_LEFT, LV_ALIGN_TOP_RIGHT, LV_ALIGN_LEFT_MID,
+        LV_ALIGN_RIGHT_MID, LV_ALIGN_BOTTOM_LEFT, LV_ALIGN_BOTTOM_RIGHT,
+    };
+    for (int i = 0; i < RENDER_BENCHMARK_TILES; i++) {
+        int32_t x = (i % 2 == 0) ? 20 : -20;
+        int32_t y = (i < 2) ? 20 : (i < 4 ? 0 : -20);
+
+        lv_obj_t *button = lv_button_create(screen);
+        lv_obj_set_size(button, 100, 50);
+        lv_obj_align(button, aligns[i], x, y);
+        lv_obj_t *label = lv_label_create(button);
+        lv_label_set_text_fmt(label, "Relay %d", i + 1);
+        lv_obj_center(label);
+
+        lv_obj_t *bar = lv_bar_create(screen);
+        lv_obj_set_size(bar, 100, 6);
+        lv_obj_align_to(bar, button, LV_ALIGN_OUT_BOTTOM_MID, 0, 4);
+        lv_bar_set_value(bar, 30 + i * 10, LV_ANIM_OFF);
+    }
+
+    lv_obj_t *counter = lv_label_create(screen);
+    lv_obj_set_style_text_color(counter, lv_color_white(), LV_PART_MAIN);
+    lv_label_set_text(counter, "0");
+    lv_obj_align(counter, LV_ALIGN_CENTER, 0, -40);
+    return counter;
+}
+
+/**
+ * @brief Time countdown-style text changes on a label using the given font
+ */
+static int64_t label_redraw_avg_us(lv_display_t *disp, lv_obj_t *label, const lv_font_t *font)
+{
+    render_benchmark_result_t result = {0};
+    lv_obj_set_style_text_font(label, font, LV_PART_MAIN);
+    lv_refr_now(disp);
+    for (int i = 0; i < RENDER_BENCHMARK_LABEL_ROUNDS; i++) {
+        lv_label_set_text_fmt(label, "%02d:%02d  %d.%02d A", 29 - i / 60, 59 - i % 60, i % 10, i);
+        refresh_timed(disp, &result);
+    }
+    return result.total_us / result.rounds;
+}
+
+/**
+ * @brief Show the benchmark screen, time redraws and display/log the results
+ */
+void render_benchmark_run(lv_display_t *disp, const char *config_name)
+{
+    if (disp == NULL || bench_screen != NULL) {
+        return;
+    }
+
+    prev_screen = lv_display_get_screen_active(disp);
+    bench_screen = lv_obj_create(NULL);
+    lv_obj_t *counter = create_content(bench_screen);
+    lv_screen_load(bench_screen);
+    lv_refr_now(disp);  // first render allocates glyph and style caches, not timed
+
+    render_benchmark_result_t full = {0};
+    for (int i = 0; i < RENDER_BENCHMARK_FULL_ROUNDS; i++) {
+        lv_obj_invalidate(bench_screen);
+        refresh_timed(disp, &full);
+    }
+
+    render_benchmark_result_t incremental = {0};
+    for (int i = 1; i <= RENDER_BENCHMARK_INCR_ROUNDS; i++) {
+        lv_label_set_text_fmt(counter, "%d", i);
+        refresh_timed(disp, &incremental);
+    }
+
+    // Numeric label redraw with the default font vs. the label font (the cached subset when enabled)
+    int64_t label_default_us = label_redraw_avg_us(disp, counter, &lv_font_montserrat_14);
+    int64_t label_subset_us = label_redraw_avg_us(disp, counter, font_subset_get());
+    font_subset_stats_t font_stats;
+    font_subset_get_stats(&font_stats);
+    ESP_LOGI(TAG, "[%s] label redraw: montserrat_14 avg %" PRId64 " us, label font avg %" PRId64 " us "
+             "(glyph cache %" PRIu32 " hits, %" PRIu32 " misses)",
+             config_name, label_default_us, label_subset_us, font_stats.hits, font_stats.misses);
+
+    int64_t full_avg = full.total_us / full.rounds;
+    int64_t incr_avg = incremental.total_us / incremental.rounds;
+    ESP_LOGI(TAG, "[%s] full redraw: avg %" PRId64 " us, max %" PRId64 " us (%" PRIu32 " rounds)",
+             config_name, full_avg, full.max_us, full.rounds);
+    ESP_LOGI(TAG, "[%s] incremental update: avg %" PRId64 " us, max %" PRId64 " us (%" PRIu32 " rounds)",
+             config_name, incr_avg, incremental.max_us, incremental.rounds);
+
+    lv_obj_t *results = lv_label_create(bench_screen);
+    lv_obj_set_style_text_color(results, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_align(results, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+    lv_label_set_text_fmt(results, "%s\nfull: %" PRId32 " us (max %" PRId32 ")\nincr: %" PRId32 " us (max %" PRId32 ")"
+                          "\nlabel: %" PRId32 " / %" PRId32 " us",
+                          config_name, (int32_t)full_avg, (int32_t)full.max_us,
+                          (int32_t)incr_avg, (int32_t)incremental.max_us,
+                          (int32_t)label_default_us, (int32_t)label_subset_us);
+    lv_obj_align(results, LV_ALIGN_CENTER, 0, 10);
+    lv_refr_now(disp);
+}
+
+/**
+ * @brief Return to the previous screen and delete the benchmark screen
+ */
+void render_benchmark_close(void)
+{
+    if (bench_screen == NULL) {
+        return;
+    }
+    if (prev_screen != NULL) {
+        lv_screen_load(prev_screen);
+    }
+    lv_obj_delete(bench_screen);
+    bench_screen = NULL;
+    prev_screen = NULL;
+}
@@ -0,0 +1,40 @@
+/*
+ * Render Benchmark Component Header
+ *
+ * Boot-time benchmark screen that times full-screen redraws, small
+ * incremental updates and numeric label redraws with the active LVGL render
+ * buffer configuration.
+ */
+
+#ifndef RENDER_BENCHMARK_H
+#define RENDER_BENCHMARK_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RENDER_BENCHMARK_SHOW_MS 3000  // How long app_main leaves the results on screen
+
+/**
+ * @brief Show the benchmark screen, time redraws and display/log the results
+ * 
+ * Renders synchronously with lv_refr_now(), so call it with the LVGL lock held.
+ * The benchmark screen stays active until render_benchmark_close().
+ * 
+ * @param disp Display to benchmark
+ * @param config_name Render buffer configuration shown in the results (e.g. "partial, internal")
+ */
+void render_benchmark_run(lv_display_t *disp, const char *config_name);
+
+/**
+ * @brief Return to the previous screen and delete the benchmark screen (LVGL lock held)
+ */
+void render_benchmark_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_BENCHMARK_H
@@ -0,0 +1,179 @@
+/*
+ * RGB565 Byte Swap Component
+ *
+ * Converts LVGL's little-endian RGB565 draw buffers into the big-endian
+ * byte order expected by SPI LCD controllers, right before the DMA transfer.
+ * On the ESP32-S3 the bulk of the buffer is handled by a PIE vector kernel
+ * (32 bytes per iteration); head/tail pixels and other chips use the portable
+ * word-at-a-time kernel in rgb565_swap_portable.c.
+ */
+
+#include "rgb565_swap.h"
+#include "rgb565_swap_portable.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "lvgl.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_cpu.h"
+
+static const char *TAG = "rgb565_swap";
+
+#define RGB565_SWAP_TEST_PX         (320 * 20 + 7)  // largest band plus an odd tail
+#define RGB565_SWAP_BENCH_ROUNDS    50
+#define RGB565_SWAP_TEST_ALIGN      16  // same alignment the DMA draw buffers get
+
+#if CONFIG_EXAMPLE_LCD_RGB565_SWAP_PIE
+#define RGB565_SWAP_PIE_BLOCK_PX    16  // pixels handled per vector iteration
+#define RGB565_SWAP_PIE_ALIGN       16  // EE.VLD/VST.128 ignore the low 4 address bits
+
+extern void rgb565_swap_pie(uint16_t *buf, uint32_t blocks);
+#endif
+
+static bool use_pie = false;
+
+#if CONFIG_EXAMPLE_LCD_RGB565_SWAP_PIE
+/**
+ * @brief Vector kernel - portable head up to 16-byte alignment, PIE body, portable tail
+ */
+static void rgb565_swap_vector(void *buf, uint32_t px_count)
+{
+    uint16_t *buf16 = (uint16_t *)buf;
+
+    uint32_t head_px = ((RGB565_SWAP_PIE_ALIGN - ((uintptr_t)buf16 & (RGB565_SWAP_PIE_ALIGN - 1))) & (RGB565_SWAP_PIE_ALIGN - 1)) / 2;
+    if (head_px > px_count) {
+        head_px = px_count;
+    }
+    if (head_px > 0) {
+        rgb565_swap_portable(buf16, head_px);
+        buf16 += head_px;
+        px_count -= head_px;
+    }
+
+    uint32_t blocks = px_count / RGB565_SWAP_PIE_BLOCK_PX;
+    if (blocks > 0) {
+        rgb565_swap_pie(buf16, blocks);
+        buf16 += blocks * RGB565_SWAP_PIE_BLOCK_PX;
+        px_count -= blocks * RGB565_SWAP_PIE_BLOCK_PX;
+    }
+
+    if (px_count > 0) {
+        rgb565_swap_portable(buf16, px_count);
+    }
+}
+#endif
+
+/**
+ * @brief Check one kernel against lv_draw_sw_rgb565_swap() at every start offset
+ */
+static bool verify_kernel(void (*kernel)(void *, uint32_t), uint16_t *test, uint16_t *ref, uint32_t px_count)
+{
+    for (uint32_t offset = 0; offset < 8; offset++) {
+        uint32_t n = px_count - offset;
+        for (uint32_t i = 0; i < px_count; i++) {
+            test[i] = (uint16_t)(i * 2654435761u >> 7);
+        }
+        memcpy(ref, test, px_count * sizeof(uint16_t));
+        lv_draw_sw_rgb565_swap(ref + offset, n);
+        kernel(test + offset, n);
+        if (memcmp(test, ref, px_count * sizeof(uint16_t)) != 0) {
+            ESP_LOGE(TAG, "Kernel mismatch at start offset %" PRIu32 " (%" PRIu32 " px)", offset, n);
+            return false;
+        }
+    }
+    return true;
+}
+
+#if CONFIG_EXAMPLE_LCD_RGB565_SWAP_BENCHMARK
+/**
+ * @brief Time one kernel over a band and log cycles per pixel
+ */
+static void benchmark_kernel(const char *name, void (*kernel)(void *, uint32_t), uint16_t *buf, uint32_t width, uint32_t lines)
+{
+    uint32_t px_count = width * lines;
+    kernel(buf, px_count);  // warm the cache
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < RGB565_SWAP_BENCH_ROUNDS; i++) {
+        kernel(buf, px_count);
+    }
+    uint32_t cycles = (esp_cpu_get_cycle_count() - start) / RGB565_SWAP_BENCH_ROUNDS;
+    ESP_LOGI(TAG, "%-10s %3" PRIu32 "x%-2" PRIu32 " band: %6" PRIu32 " cycles, %" PRIu32 ".%02" PRIu32 " cycles/px",
+             name, width, lines, cycles, cycles / px_count, (cycles * 100 / px_count) % 100);
+}
+
+static void lvgl_reference_kernel(void *buf, uint32_t px_count)
+{
+    lv_draw_sw_rgb565_swap(buf, px_count);
+}
+#endif
+
+/**
+ * @brief Select the swap kernel for this chip
+ */
+esp_err_t rgb565_swap_init(void)
+{
+    uint16_t *test = heap_caps_aligned_alloc(RGB565_SWAP_TEST_ALIGN, RGB565_SWAP_TEST_PX * sizeof(uint16_t), MALLOC_CAP_DMA);
+    uint16_t *ref = heap_caps_malloc(RGB565_SWAP_TEST_PX * sizeof(uint16_t), MALLOC_CAP_DEFAULT);
+    if (test == NULL || ref == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate swap test buffers, using portable kernel");
+        heap_caps_free(test);
+        heap_caps_free(ref);
+        use_pie = false;
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (!verify_kernel(rgb565_swap_portable, test, ref, RGB565_SWAP_TEST_PX)) {
+        ESP_LOGE(TAG, "Portable kernel failed verification");
+    }
+
+#if CONFIG_EXAMPLE_LCD_RGB565_SWAP_PIE
+    use_pie = verify_kernel(rgb565_swap_vector, test, ref, RGB565_SWAP_TEST_PX);
+    if (!use_pie) {
+        ESP_LOGW(TAG, "PIE kernel is not bit-exact, falling back to portable kernel");
+    }
+#endif
+
+#if CONFIG_EXAMPLE_LCD_RGB565_SWAP_BENCHMARK
+    static const uint32_t band_widths[] = {240, 320};
+    for (size_t i = 0; i < sizeof(band_widths) / sizeof(band_widths[0]); i++) {
+        benchmark_kernel("lvgl", lvgl_reference_kernel, test, band_widths[i], 20);
+        benchmark_kernel("portable", rgb565_swap_portable, test, band_widths[i], 20);
+#if CONFIG_EXAMPLE_LCD_RGB565_SWAP_PIE
+        if (use_pie) {
+            benchmark_kernel("pie", rgb565_swap_vector, test, band_widths[i], 20);
+        }
+#endif
+    }
+#endif
+
+    heap_caps_free(test);
+    heap_caps_free(ref);
+    ESP_LOGI(TAG, "Using %s RGB565 swap kernel", rgb565_swap_get_kernel_name());
+    return ESP_OK;
+}
+
+/**
+ * @brief Swap the two bytes of every RGB565 pixel in place
+ */
+void rgb565_swap(void *buf, uint32_t px_count)
+{
+#if CONFIG_EXAMPLE_LCD_RGB565_SWAP_PIE
+    if (use_pie) {
+        rgb565_swap_vector(buf, px_count);
+        return;
+    }
+#endif
+    rgb565_swap_portable(buf, px_count);
+}
+
+/**
+ * @brief Get the name of the active kernel (for logging)
+ */
+const char *rgb565_swap_get_kernel_name(void)
+{
+    return use_pie ? "pie" : "portable";
+}
@@ -0,0 +1,49 @@
+/*
+ * RGB565 Byte Swap Component Header
+ * 
+ * Converts LVGL's little-endian RGB565 draw buffers into the big-endian
+ * byte order expected by SPI LCD controllers, right before the DMA transfer.
+ */
+
+#ifndef RGB565_SWAP_H
+#define RGB565_SWAP_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Select the swap kernel for this chip
+ * 
+ * Verifies the vector kernel bit-for-bit against lv_draw_sw_rgb565_swap() and
+ * falls back to the portable kernel on any mismatch. When
+ * CONFIG_EXAMPLE_LCD_RGB565_SWAP_BENCHMARK is enabled, also times every kernel
+ * over typical band sizes and logs the result.
+ * 
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the test buffer could not be allocated
+ */
+esp_err_t rgb565_swap_init(void);
+
+/**
+ * @brief Swap the two bytes of every RGB565 pixel in place
+ * 
+ * @param buf Pixel buffer (2-byte aligned)
+ * @param px_count Number of pixels in the buffer
+ */
+void rgb565_swap(void *buf, uint32_t px_count);
+
+/**
+ * @brief Get the name of the active kernel (for logging)
+ * 
+ * @return const char* "pie" or "portable"
+ */
+const char *rgb565_swap_get_kernel_name(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RGB565_SWAP_H
@@ -0,0 +1,46 @@
+/*
+ * RGB565 Byte Swap - Portable Kernel
+ *
+ * Word-at-a-time swap used on chips without PIE and for the head and tail
+ * pixels of the vector kernel. Plain C with no ESP-IDF dependencies, so
+ * main/tools/rgb565_swap_bench.c can check and time it on the host.
+ */
+
+#include "rgb565_swap_portable.h"
+
+/**
+ * @brief Portable kernel - swaps two pixels per 32-bit word
+ */
+void rgb565_swap_portable(void *buf, uint32_t px_count)
+{
+    uint16_t *buf16 = (uint16_t *)buf;
+
+    // Align to a 32-bit boundary so the word loop never straddles
+    if (((uintptr_t)buf16 & 0x3) && px_count > 0) {
+        *buf16 = (uint16_t)((*buf16 >> 8) | (*buf16 << 8));
+        buf16++;
+        px_count--;
+    }
+
+    uint32_t *buf32 = (uint32_t *)buf16;
+    uint32_t words = px_count / 2;
+    while (words >= 4) {
+        buf32[0] = ((buf32[0] & 0xff00ff00) >> 8) | ((buf32[0] & 0x00ff00ff) << 8);
+        buf32[1] = ((buf32[1] & 0xff00ff00) >> 8) | ((buf32[1] & 0x00ff00ff) << 8);
+        buf32[2] = ((buf32[2] & 0xff00ff00) >> 8) | ((buf32[2] & 0x00ff00ff) << 8);
+        buf32[3] = ((buf32[3] & 0xff00ff00) >> 8) | ((buf32[3] & 0x00ff00ff) << 8);
+        buf32 += 4;
+        words -= 4;
+    }
+    while (words > 0) {
+        *buf32 = ((*buf32 & 0xff00ff00) >> 8) | ((*buf32 & 0x00ff00ff) << 8);
+        buf32++;
+        words--;
+    }
+
+    // Odd pixel at the end
+    if (px_count & 0x1) {
+        buf16 = (uint16_t *)buf32;
+        *buf16 = (uint16_t)((*buf16 >> 8) | (*buf16 << 8));
+    }
+}
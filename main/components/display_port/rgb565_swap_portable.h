@@ -0,0 +1,26 @@
+/*
+ * RGB565 Byte Swap - Portable Kernel Header
+ */
+
+#ifndef RGB565_SWAP_PORTABLE_H
+#define RGB565_SWAP_PORTABLE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Swap the two bytes of every RGB565 pixel in place, two pixels per 32-bit word
+ *
+ * @param buf Pixel buffer (2-byte aligned)
+ * @param px_count Number of pixels in the buffer
+ */
+void rgb565_swap_portable(void *buf, uint32_t px_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RGB565_SWAP_PORTABLE_H
@@ -0,0 +1,364 @@
+/*
+ * Screen Capture Component
+ *
+ * A capture invalidates the active screen and redraws it once with
+ * lv_refr_now(). Every band that reaches the flush callback is encoded to QOI
+ * (RGB565 expanded to RGB888) before it is byte-swapped and sent to the LCD,
+ * and the encoded bytes go through a small stream buffer to the reader task.
+ * QOI keeps its state between pixels, so the image can be encoded band by
+ * band and no more than one band plus SCREEN_CAPTURE_STREAM_SIZE bytes is
+ * ever held. The dashboard is mostly flat colour, which QOI reduces to
+ * runs and index hits.
+ */
+
+#include "screen_capture.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/stream_buffer.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+
+static const char *TAG = "screen_capture";
+
+#define QOI_OP_INDEX    0x00
+#define QOI_OP_DIFF     0x40
+#define QOI_OP_LUMA     0x80
+#define QOI_OP_RUN      0xC0
+#define QOI_OP_RGB      0xFE
+#define QOI_MAX_RUN     62
+#define CAPTURE_OUT_SIZE 256
+
+// Provided by the LVGL port in spi_lcd_touch_example_main.c
+extern void example_lvgl_port_request_timer(lv_timer_t *timer);
+
+static lv_display_t *cap_disp = NULL;
+static lv_timer_t *cap_timer = NULL;
+static SemaphoreHandle_t cap_busy = NULL;
+static StreamBufferHandle_t cap_stream = NULL;
+
+static volatile bool cap_active = false;   // Flush callback should encode
+static volatile bool cap_failed = false;   // Stop producing (bad area order, slow or gone reader)
+static volatile bool cap_done = false;     // LVGL side finished, the stream gets no more data
+static volatile bool cap_requested = false; // A reader waits for the next timer run
+
+// Encoder state, LVGL context only
+static int32_t cap_width;
+static int32_t cap_height;
+static int32_t cap_next_row;
+static uint32_t qoi_index[64];
+static uint32_t qoi_prev;                  // Previous pixel as 0xRRGGBB
+static uint16_t qoi_prev_565;
+static uint32_t qoi_run;
+static uint8_t cap_out[CAPTURE_OUT_SIZE];
+static size_t cap_out_len;
+static uint32_t cap_bytes;
+static int64_t cap_encode_us;
+
+/**
+ * @brief Push the staged bytes to the reader
+ */
+static void capture_flush_out(void)
+{
+    size_t sent = 0;
+    while (!cap_failed && sent < cap_out_len) {
+        size_t n = xStreamBufferSend(cap_stream, cap_out + sent, cap_out_len - sent,
+                                     pdMS_TO_TICKS(SCREEN_CAPTURE_SEND_TIMEOUT_MS));
+        if (n == 0) {
+            // Don't stall the UI for a slow client
+            ESP_LOGW(TAG, "Reader too slow, capture aborted");
+            cap_failed = true;
+        }
+        sent += n;
+    }
+    cap_bytes += cap_out_len;
+    cap_out_len = 0;
+}
+
+static inline void capture_put(uint8_t byte)
+{
+    cap_out[cap_out_len++] = byte;
+    if (cap_out_len == CAPTURE_OUT_SIZE) {
+        capture_flush_out();
+    }
+}
+
+static void capture_put_u32be(uint32_t value)
+{
+    capture_put((uint8_t)(value >> 24));
+    capture_put((uint8_t)(value >> 16));
+    capture_put((uint8_t)(value >> 8));
+    capture_put((uint8_t)value);
+}
+
+/**
+ * @brief Start a QOI image: header and fresh encoder state
+ */
+static void qoi_begin(int32_t width, int32_t height)
+{
+    // Not a valid 0xRRGGBB value, so an unused slot never matches (decoders start with alpha 0 there)
+    memset(qoi_index, 0xFF, sizeof(qoi_index));
+    qoi_prev = 0x000000;
+    qoi_prev_565 = 0x0000;
+    qoi_run = 0;
+
+    capture_put('q');
+    capture_put('o');
+    capture_put('i');
+    capture_put('f');
+    capture_put_u32be((uint32_t)width);
+    capture_put_u32be((uint32_t)height);
+    capture_put(3);     // RGB
+    capture_put(0);     // sRGB with linear alpha
+}
+
+/**
+ * @brief Encode one pixel that differs from the previous one
+ */
+static void qoi_put_pixel(uint32_t rgb)
+{
+    uint8_t r = (uint8_t)(rgb >> 16);
+    uint8_t g = (uint8_t)(rgb >> 8);
+    uint8_t b = (uint8_t)rgb;
+    uint32_t hash = (r * 3 + g * 5 + b * 7 + 255 * 11) % 64;
+
+    if (qoi_index[hash] == rgb) {
+        capture_put(QOI_OP_INDEX | hash);
+    } else {
+        qoi_index[hash] = rgb;
+        int8_t dr = (int8_t)(r - (uint8_t)(qoi_prev >> 16));
+        int8_t dg = (int8_t)(g - (uint8_t)(qoi_prev >> 8));
+        int8_t db = (int8_t)(b - (uint8_t)qoi_prev);
+        int8_t dr_dg = (int8_t)(dr - dg);
+        int8_t db_dg = (int8_t)(db - dg);
+
+        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+            capture_put(QOI_OP_DIFF | (uint8_t)((dr + 2) << 4) | (uint8_t)((dg + 2) << 2) | (uint8_t)(db + 2));
+        } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+            capture_put(QOI_OP_LUMA | (uint8_t)(dg + 32));
+            capture_put((uint8_t)((dr_dg + 8) << 4) | (uint8_t)(db_dg + 8));
+        } else {
+            capture_put(QOI_OP_RGB);
+            capture_put(r);
+            capture_put(g);
+            capture_put(b);
+        }
+    }
+    qoi_prev = rgb;
+}
+
+/**
+ * @brief Encode one RGB565 pixel (runs are compared on the 16-bit value)
+ */
+static inline void qoi_encode_565(uint16_t px)
+{
+    if (px == qoi_prev_565) {
+        if (++qoi_run == QOI_MAX_RUN) {
+            capture_put(QOI_OP_RUN | (QOI_MAX_RUN - 1));
+            qoi_run = 0;
+        }
+        return;
+    }
+    if (qoi_run > 0) {
+        capture_put(QOI_OP_RUN | (uint8_t)(qoi_run - 1));
+        qoi_run = 0;
+    }
+    qoi_prev_565 = px;
+
+    // Expand to 8 bits per channel by replicating the top bits
+    uint32_t r = (px >> 11) & 0x1F;
+    uint32_t g = (px >> 5) & 0x3F;
+    uint32_t b = px & 0x1F;
+    qoi_put_pixel((((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2)));
+}
+
+/**
+ * @brief Finish the image: pending run and end marker
+ */
+static void qoi_end(void)
+{
+    if (qoi_run > 0) {
+        capture_put(QOI_OP_RUN | (uint8_t)(qoi_run - 1));
+        qoi_run = 0;
+    }
+    for (int i = 0; i < 7; i++) {
+        capture_put(0x00);
+    }
+    capture_put(0x01);
+    capture_flush_out();
+}
+
+/**
+ * @brief LVGL timer - redraws the screen once with encoding enabled
+ */
+static void capture_timer_cb(lv_timer_t *timer)
+{
+    lv_timer_pause(timer);
+    // A late run for a reader that already gave up has nobody to send to
+    if (!cap_requested) {
+        return;
+    }
+    cap_requested = false;
+
+    cap_width = lv_display_get_horizontal_resolution(cap_disp);
+    cap_height = lv_display_get_vertical_resolution(cap_disp);
+    cap_next_row = 0;
+    cap_out_len = 0;
+    cap_bytes = 0;
+    cap_encode_us = 0;
+
+    int64_t start_us = esp_timer_get_time();
+    qoi_begin(cap_width, cap_height);
+
+    // The flush callback sees the whole screen, top to bottom, in full-width bands
+    cap_active = true;
+    lv_obj_invalidate(lv_display_get_screen_active(cap_disp));
+    lv_refr_now(cap_disp);
+    cap_active = false;
+
+    if (!cap_failed && cap_next_row != cap_height) {
+        ESP_LOGW(TAG, "Capture incomplete: %" PRId32 " of %" PRId32 " rows", cap_next_row, cap_height);
+        cap_failed = true;
+    }
+    if (!cap_failed) {
+        qoi_end();
+        uint32_t total_us = (uint32_t)(esp_timer_get_time() - start_us);
+        uint32_t raw_bytes = (uint32_t)(cap_width * cap_height * sizeof(uint16_t));
+        ESP_LOGI(TAG, "Captured %" PRId32 "x%" PRId32 ": %" PRIu32 " bytes QOI (%" PRIu32 "%% of RGB565), "
+                 "%" PRIu32 " us incl. %" PRIu32 " us encoding, frame period %d ms",
+                 cap_width, cap_height, cap_bytes, (cap_bytes * 100) / raw_bytes,
+                 total_us, (uint32_t)cap_encode_us, LV_DEF_REFR_PERIOD);
+    }
+    cap_done = true;
+}
+
+/**
+ * @brief Prepare screen capture for a display
+ */
+esp_err_t screen_capture_init(lv_display_t *disp)
+{
+    cap_disp = disp;
+    cap_busy = xSemaphoreCreateMutex();
+    if (cap_busy == NULL) {
+        ESP_LOGE(TAG, "Failed to create capture mutex");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Runs only when screen_capture_stream() asks the LVGL task for it
+    cap_timer = lv_timer_create(capture_timer_cb, 0, NULL);
+    if (cap_timer == NULL) {
+        ESP_LOGE(TAG, "Failed to create capture timer");
+        return ESP_ERR_NO_MEM;
+    }
+    lv_timer_pause(cap_timer);
+    return ESP_OK;
+}
+
+/**
+ * @brief Check whether a capture is being rendered
+ */
+bool screen_capture_is_active(void)
+{
+    return cap_active;
+}
+
+/**
+ * @brief Encode the rows of a flushed area
+ */
+void screen_capture_add_rows(const lv_area_t *area, const uint8_t *px, size_t stride)
+{
+    if (!cap_active || cap_failed) {
+        return;
+    }
+    // QOI is a single top-to-bottom pass, so bands must be full width and in order
+    if (area->x1 != 0 || area->x2 != cap_width - 1 || area->y1 != cap_next_row) {
+        ESP_LOGW(TAG, "Unexpected flush area (%" PRId32 ",%" PRId32 ")-(%" PRId32 ",%" PRId32 "), capture aborted",
+                 area->x1, area->y1, area->x2, area->y2);
+        cap_failed = true;
+        return;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        const uint16_t *row = (const uint16_t *)(px + (size_t)(y - area->y1) * stride);
+        for (int32_t x = 0; x < cap_width; x++) {
+            qoi_encode_565(row[x]);
+        }
+    }
+    cap_next_row = area->y2 + 1;
+    cap_encode_us += esp_timer_get_time() - start_us;
+}
+
+/**
+ * @brief Capture the screen and stream it as a QOI image
+ */
+esp_err_t screen_capture_stream(screen_capture_write_cb_t write_cb, void *ctx)
+{
+    if (cap_timer == NULL || write_cb == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xSemaphoreTake(cap_busy, 0) != pdTRUE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // The run of an abandoned capture is still rendering; resetting the stream now would mix them
+    if (cap_active) {
+        xSemaphoreGive(cap_busy);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Allocated on first use and kept; the LVGL side never blocks on a deleted buffer
+    if (cap_stream == NULL) {
+        cap_stream = xStreamBufferCreate(SCREEN_CAPTURE_STREAM_SIZE, 1);
+        if (cap_stream == NULL) {
+            xSemaphoreGive(cap_busy);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    xStreamBufferReset(cap_stream);
+    cap_failed = false;
+    cap_done = false;
+    cap_requested = true;
+    example_lvgl_port_request_timer(cap_timer);
+
+    uint8_t buf[512];
+    esp_err_t ret = ESP_OK;
+    uint32_t idle_ms = 0;
+    bool timed_out = false;
+    while (!(cap_done && xStreamBufferIsEmpty(cap_stream))) {
+        size_t n = xStreamBufferReceive(cap_stream, buf, sizeof(buf), pdMS_TO_TICKS(100));
+        if (n > 0) {
+            idle_ms = 0;
+            if (ret == ESP_OK) {
+                ret = write_cb(ctx, buf, n);
+                if (ret != ESP_OK) {
+                    cap_failed = true;  // Client gone - keep draining until the LVGL side stops
+                }
+            }
+            continue;
+        }
+        idle_ms += 100;
+        if (!timed_out && idle_ms >= SCREEN_CAPTURE_TIMEOUT_MS && !cap_done) {
+            ESP_LOGW(TAG, "No capture data for %d ms", SCREEN_CAPTURE_TIMEOUT_MS);
+            timed_out = true;
+            cap_failed = true;
+            ret = ESP_ERR_TIMEOUT;
+        } else if (idle_ms >= 5 * SCREEN_CAPTURE_TIMEOUT_MS) {
+            // LVGL task never ran the capture - cancel the request so a late run sends nothing
+            ESP_LOGE(TAG, "LVGL task did not finish the capture");
+            cap_requested = false;
+            cap_failed = true;
+            ret = ESP_ERR_TIMEOUT;
+            break;
+        }
+    }
+
+    if (ret == ESP_OK && cap_failed) {
+        ret = ESP_FAIL;
+    }
+    xSemaphoreGive(cap_busy);
+    return ret;
+}
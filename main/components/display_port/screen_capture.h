@@ -0,0 +1,71 @@
+/*
+ * Screen Capture Component Header
+ *
+ * Captures what the LCD shows as a QOI image without a frame-sized buffer:
+ * the screen is redrawn once and every band is encoded as it passes through
+ * the flush callback, while the caller streams the encoded bytes out.
+ */
+
+#ifndef SCREEN_CAPTURE_H
+#define SCREEN_CAPTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCREEN_CAPTURE_STREAM_SIZE      4096  // Encoded bytes buffered between LVGL and the reader
+#define SCREEN_CAPTURE_SEND_TIMEOUT_MS  50    // Longest the LVGL task waits for a slow reader before giving up
+#define SCREEN_CAPTURE_TIMEOUT_MS       2000  // Reader gives up after this long without data
+
+/**
+ * @brief Called by screen_capture_stream() for each piece of the encoded image
+ */
+typedef esp_err_t (*screen_capture_write_cb_t)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Prepare screen capture for a display
+ *
+ * Creates an LVGL timer, so call it before the LVGL task starts or with the LVGL lock held.
+ *
+ * @param disp Display to capture
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM on allocation failure
+ */
+esp_err_t screen_capture_init(lv_display_t *disp);
+
+/**
+ * @brief Check whether a capture is being rendered (flush callback, LVGL context)
+ */
+bool screen_capture_is_active(void);
+
+/**
+ * @brief Encode the rows of a flushed area (flush callback, before the byte swap)
+ *
+ * @param area Flushed area in screen coordinates
+ * @param px First pixel of the area, native RGB565
+ * @param stride Bytes between the rows of the area
+ */
+void screen_capture_add_rows(const lv_area_t *area, const uint8_t *px, size_t stride);
+
+/**
+ * @brief Capture the screen and stream it as a QOI image (any task except the LVGL task)
+ *
+ * Blocks until the image has been written or the capture failed.
+ *
+ * @param write_cb Receives the encoded bytes in order
+ * @param ctx User data for write_cb
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if a capture is already running,
+ *         ESP_ERR_TIMEOUT or ESP_FAIL if the capture was aborted, or the error of write_cb
+ */
+esp_err_t screen_capture_stream(screen_capture_write_cb_t write_cb, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCREEN_CAPTURE_H
@@ -0,0 +1,142 @@
+/*
+ * UI Metrics Component
+ *
+ * Always-on, lock-free counters and fixed-bucket histograms for the LVGL
+ * pipeline. Every counter is a 32-bit atomic updated with relaxed ordering,
+ * which the ESP32-S3 does natively (S32C1I), so recording a sample is a few
+ * instructions plus a bucket search and is safe from the SPI done ISR.
+ */
+
+#include "ui_metrics.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define UI_METRICS_MAX_BUCKETS 10  // Including the +Inf bucket
+
+typedef struct {
+    const char *name;
+    const uint32_t *bounds;         // Upper bounds (inclusive), the last bucket is +Inf
+    uint8_t bound_count;
+} ui_metric_desc_t;
+
+typedef struct {
+    atomic_uint_fast32_t count;
+    atomic_uint_fast32_t sum;
+    atomic_uint_fast32_t max;
+    atomic_uint_fast32_t buckets[UI_METRICS_MAX_BUCKETS];
+} ui_histogram_t;
+
+static const uint32_t time_bounds_us[] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000};
+static const uint32_t area_bounds_px[] = {256, 1024, 4096, 9600, 19200, 38400, 76800};
+static const uint32_t byte_bounds[] = {1024, 4096, 19200, 38400, 76800, 153600};
+
+#define BOUNDS(b) (b), (uint8_t)(sizeof(b) / sizeof((b)[0]))
+
+static const ui_metric_desc_t metric_desc[UI_METRIC_COUNT] = {
+    [UI_METRIC_TIMER_HANDLER_US] = {"timer_handler_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_LOCK_HOLD_US]     = {"lock_hold_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_FRAME_US]         = {"frame_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_RENDER_US]        = {"render_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_FLUSH_US]         = {"flush_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_SPI_WAIT_US]      = {"spi_wait_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_FLUSH_BYTES]      = {"flush_bytes", BOUNDS(byte_bounds)},
+    [UI_METRIC_INVALID_AREA_PX]  = {"invalid_area_px", BOUNDS(area_bounds_px)},
+    [UI_METRIC_TOUCH_LATENCY_US] = {"touch_latency_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_TOUCH_BUS_WAIT_US] = {"touch_bus_wait_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_PUSH_LATENCY_US]  = {"push_latency_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_API_US]           = {"api_us", BOUNDS(time_bounds_us)},
+    [UI_METRIC_API_DURING_OTA_US] = {"api_during_ota_us", BOUNDS(time_bounds_us)},
+};
+
+static ui_histogram_t histograms[UI_METRIC_COUNT];
+
+/**
+ * @brief Record one sample (lock-free, safe from any task or ISR)
+ */
+void ui_metrics_record(ui_metric_t metric, uint32_t value)
+{
+    if (metric >= UI_METRIC_COUNT) {
+        return;
+    }
+    const ui_metric_desc_t *desc = &metric_desc[metric];
+    ui_histogram_t *h = &histograms[metric];
+
+    uint8_t bucket = 0;
+    while (bucket < desc->bound_count && value > desc->bounds[bucket]) {
+        bucket++;
+    }
+    atomic_fetch_add_explicit(&h->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum, value, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+
+    uint_fast32_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    while (value > max &&
+           !atomic_compare_exchange_weak_explicit(&h->max, &max, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Estimate a percentile from a metric's histogram
+ */
+uint32_t ui_metrics_percentile(ui_metric_t metric, uint32_t pct)
+{
+    if (metric >= UI_METRIC_COUNT || pct == 0 || pct > 100) {
+        return 0;
+    }
+    const ui_metric_desc_t *desc = &metric_desc[metric];
+    ui_histogram_t *h = &histograms[metric];
+
+    // Ranked over the buckets themselves, which "count" may be ahead of
+    uint32_t buckets[UI_METRICS_MAX_BUCKETS];
+    uint64_t total = 0;
+    for (uint8_t i = 0; i <= desc->bound_count; i++) {
+        buckets[i] = (uint32_t)atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        total += buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = (total * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (uint8_t i = 0; i < desc->bound_count; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return desc->bounds[i];
+        }
+    }
+    return (uint32_t)atomic_load_explicit(&h->max, memory_order_relaxed);
+}
+
+/**
+ * @brief Write one metric as a JSON member
+ */
+void ui_metrics_write_json(ui_metric_t metric, json_writer_t *writer)
+{
+    if (metric >= UI_METRIC_COUNT) {
+        return;
+    }
+    const ui_metric_desc_t *desc = &metric_desc[metric];
+    ui_histogram_t *h = &histograms[metric];
+
+    json_key(writer, desc->name);
+    json_obj_begin(writer);
+    json_kv_int(writer, "count", (uint32_t)atomic_load_explicit(&h->count, memory_order_relaxed));
+    json_kv_int(writer, "sum", (uint32_t)atomic_load_explicit(&h->sum, memory_order_relaxed));
+    json_kv_int(writer, "max", (uint32_t)atomic_load_explicit(&h->max, memory_order_relaxed));
+    json_kv_int(writer, "p50", ui_metrics_percentile(metric, 50));
+    json_kv_int(writer, "p95", ui_metrics_percentile(metric, 95));
+    json_kv_int(writer, "p99", ui_metrics_percentile(metric, 99));
+    json_key(writer, "le");
+    json_arr_begin(writer);
+    for (uint8_t i = 0; i < desc->bound_count; i++) {
+        json_int(writer, desc->bounds[i]);
+    }
+    json_arr_end(writer);
+    json_key(writer, "buckets");
+    json_arr_begin(writer);
+    for (uint8_t i = 0; i <= desc->bound_count; i++) {
+        json_int(writer, (uint32_t)atomic_load_explicit(&h->buckets[i], memory_order_relaxed));
+    }
+    json_arr_end(writer);
+    json_obj_end(writer);
+}
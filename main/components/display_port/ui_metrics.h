@@ -0,0 +1,74 @@
+/*
+ * UI Metrics Component Header
+ *
+ * Always-on, lock-free counters and fixed-bucket histograms for the LVGL
+ * pipeline (timer handler, render, flush, SPI wait, lock hold time,
+ * invalidated area and touch latency), exported as JSON by the HTTP server.
+ */
+
+#ifndef UI_METRICS_H
+#define UI_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "json_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Recorded metrics
+ */
+typedef enum {
+    UI_METRIC_TIMER_HANDLER_US = 0, // One lv_timer_handler() call
+    UI_METRIC_LOCK_HOLD_US,         // LVGL API lock held (LVGL task and app_main)
+    UI_METRIC_FRAME_US,             // Refresh cycle, render and flush together
+    UI_METRIC_RENDER_US,            // Refresh cycle minus flush and SPI wait (drawing only)
+    UI_METRIC_FLUSH_US,             // Time in the flush callback per frame (swap/copy and queueing)
+    UI_METRIC_SPI_WAIT_US,          // Time LVGL blocked on SPI DMA per frame
+    UI_METRIC_FLUSH_BYTES,          // Bytes sent to the panel per frame
+    UI_METRIC_INVALID_AREA_PX,      // Pixels invalidated per frame (before LVGL merges areas)
+    UI_METRIC_TOUCH_LATENCY_US,     // Touch controller PENIRQ edge to the press reported to LVGL
+    UI_METRIC_TOUCH_BUS_WAIT_US,    // Touch read waiting for the pixel band on the shared SPI bus
+    UI_METRIC_PUSH_LATENCY_US,      // Relay change to the browser over /ws (send time plus half the ack round trip)
+    UI_METRIC_API_US,               // One /api/ request on the HTTP server task, routing to the last byte sent
+    UI_METRIC_API_DURING_OTA_US,    // The same, counted only while a firmware upload runs
+    UI_METRIC_COUNT
+} ui_metric_t;
+
+/**
+ * @brief Record one sample (lock-free, safe from any task or ISR)
+ * 
+ * @param metric Metric to update
+ * @param value Sample value in the metric's unit
+ */
+void ui_metrics_record(ui_metric_t metric, uint32_t value);
+
+/**
+ * @brief Estimate a percentile from a metric's histogram
+ * 
+ * @param metric Metric
+ * @param pct Percentile, 1..100
+ * @return uint32_t Upper bound of the bucket holding the percentile (the maximum
+ *         for the last bucket), 0 without samples
+ */
+uint32_t ui_metrics_percentile(ui_metric_t metric, uint32_t pct);
+
+/**
+ * @brief Write one metric as a JSON member:
+ * "name":{"count":..,"sum":..,"max":..,"p50":..,"p95":..,"p99":..,"le":[..],"buckets":[..]}
+ * 
+ * Counters are read without locking, so a sample recorded concurrently may show up
+ * in "count" but not yet in "buckets". Sums wrap at 2^32.
+ * 
+ * @param metric Metric to write
+ * @param writer Writer positioned inside an object
+ */
+void ui_metrics_write_json(ui_metric_t metric, json_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_METRICS_H
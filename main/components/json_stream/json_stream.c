@@ -0,0 +1,574 @@
+/*
+ * JSON Stream Component
+ *
+ * The reader is a jsmn-style tokenizer with a strict grammar: a small state
+ * of what may come next (key, colon, value, comma or close) replaces jsmn's
+ * lenient separator handling, so malformed bodies are rejected rather than
+ * half-read. A string or number is only turned into a token once its end has
+ * arrived; if the input stops inside one, the position stays at its start
+ * and it is scanned again after the next receive. Root values are limited to
+ * objects and arrays, so a complete document always ends on a bracket.
+ *
+ * The writer tracks only whether a comma is due, which is all a correct
+ * sequence of calls needs, and formats integers without printf.
+ */
+
+#include "json_stream.h"
+#include <string.h>
+
+// What the reader accepts next
+#define JSON_EXPECT_VALUE  0x01
+#define JSON_EXPECT_KEY    0x02
+#define JSON_EXPECT_COLON  0x04
+#define JSON_EXPECT_COMMA  0x08
+#define JSON_EXPECT_CLOSE  0x10
+
+static bool json_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool json_is_hex(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool json_is_primitive_char(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+/**
+ * @brief Start a new document
+ */
+void json_reader_init(json_reader_t *reader)
+{
+    reader->len = 0;
+    reader->pos = 0;
+    reader->count = 0;
+    reader->super = -1;
+    reader->expect = JSON_EXPECT_VALUE;
+    reader->status = JSON_PARTIAL;
+}
+
+/**
+ * @brief Take a token, attached to the current container or key
+ */
+static json_token_t *json_reader_alloc(json_reader_t *reader, json_type_t type, int start, int end)
+{
+    if (reader->count == JSON_READER_MAX_TOKENS) {
+        reader->status = JSON_ERR_NO_TOKENS;
+        return NULL;
+    }
+    json_token_t *token = &reader->tokens[reader->count++];
+    token->type = type;
+    token->start = (int16_t)start;
+    token->end = (int16_t)end;
+    token->size = 0;
+    token->parent = (int16_t)reader->super;
+    if (reader->super >= 0) {
+        reader->tokens[reader->super].size++;
+    }
+    return token;
+}
+
+/**
+ * @brief A value is complete: back to its container, or done at the root
+ */
+static void json_reader_value_done(json_reader_t *reader)
+{
+    if (reader->super >= 0 && reader->tokens[reader->super].type == JSON_TYPE_STRING) {
+        reader->super = reader->tokens[reader->super].parent;  // Key answered
+    }
+    if (reader->super < 0) {
+        reader->expect = 0;
+        reader->status = JSON_OK;
+    } else {
+        reader->expect = JSON_EXPECT_COMMA | JSON_EXPECT_CLOSE;
+    }
+}
+
+/**
+ * @brief Length of the string starting at the quote at pos, including both quotes
+ *
+ * @return size_t 0 if the input ends first, SIZE_MAX if the string is invalid
+ */
+static size_t json_reader_scan_string(const json_reader_t *reader, size_t pos)
+{
+    for (size_t i = pos + 1; i < reader->len; i++) {
+        char c = reader->input[i];
+        if (c == '"') {
+            return i + 1 - pos;
+        }
+        if ((unsigned char)c < 0x20) {
+            return SIZE_MAX;
+        }
+        if (c != '\\') {
+            continue;
+        }
+        if (++i == reader->len) {
+            return 0;
+        }
+        switch (reader->input[i]) {
+        case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+            break;
+        case 'u':
+            for (int h = 0; h < 4; h++) {
+                if (++i == reader->len) {
+                    return 0;
+                }
+                if (!json_is_hex(reader->input[i])) {
+                    return SIZE_MAX;
+                }
+            }
+            break;
+        default:
+            return SIZE_MAX;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Whether a primitive is true, false, null or a number
+ */
+static bool json_primitive_valid(const char *s, size_t len)
+{
+    if ((len == 4 && memcmp(s, "true", 4) == 0) || (len == 5 && memcmp(s, "false", 5) == 0) ||
+        (len == 4 && memcmp(s, "null", 4) == 0)) {
+        return true;
+    }
+    size_t i = (s[0] == '-') ? 1 : 0;
+    if (i == len || s[i] < '0' || s[i] > '9') {
+        return false;
+    }
+    // Digits, then at most a fraction and an exponent; strtod-grade checks are not needed for an API
+    for (; i < len; i++) {
+        char c = s[i];
+        if (!((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Tokenize from pos to the end of the input
+ */
+static json_status_t json_reader_run(json_reader_t *reader)
+{
+    while (reader->status == JSON_PARTIAL || reader->status == JSON_OK) {
+        while (reader->pos < reader->len && json_is_space(reader->input[reader->pos])) {
+            reader->pos++;
+        }
+        if (reader->pos == reader->len) {
+            break;
+        }
+        size_t pos = reader->pos;
+        char c = reader->input[pos];
+        uint8_t expect = reader->expect;
+
+        if (c == '{' || c == '[') {
+            if (!(expect & JSON_EXPECT_VALUE)) {
+                reader->status = JSON_ERR_INVALID;
+                break;
+            }
+            if (json_reader_alloc(reader, c == '{' ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY, (int)pos, -1) == NULL) {
+                break;
+            }
+            reader->super = reader->count - 1;
+            reader->expect = (c == '{' ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE) | JSON_EXPECT_CLOSE;
+            reader->pos++;
+        } else if (c == '}' || c == ']') {
+            json_type_t type = (c == '}') ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY;
+            if (!(expect & JSON_EXPECT_CLOSE) || reader->tokens[reader->super].type != type) {
+                reader->status = JSON_ERR_INVALID;
+                break;
+            }
+            reader->tokens[reader->super].end = (int16_t)(pos + 1);
+            reader->super = reader->tokens[reader->super].parent;
+            reader->pos++;
+            json_reader_value_done(reader);
+        } else if (c == ':') {
+            if (!(expect & JSON_EXPECT_COLON)) {
+                reader->status = JSON_ERR_INVALID;
+                break;
+            }
+            reader->expect = JSON_EXPECT_VALUE;
+            reader->pos++;
+        } else if (c == ',') {
+            if (!(expect & JSON_EXPECT_COMMA)) {
+                reader->status = JSON_ERR_INVALID;
+                break;
+            }
+            reader->expect = reader->tokens[reader->super].type == JSON_TYPE_OBJECT ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+            reader->pos++;
+        } else if (c == '"') {
+            // Keys and values only exist inside a container; a root string is rejected
+            if (!(expect & (JSON_EXPECT_KEY | JSON_EXPECT_VALUE)) || reader->super < 0) {
+                reader->status = JSON_ERR_INVALID;
+                break;
+            }
+            size_t len = json_reader_scan_string(reader, pos);
+            if (len == SIZE_MAX) {
+                reader->status = JSON_ERR_INVALID;
+                break;
+            }
+            if (len == 0) {
+                break;  // Rest of the string still to come
+            }
+            if (json_reader_alloc(reader, JSON_TYPE_STRING, (int)(pos + 1), (int)(pos + len - 1)) == NULL) {
+                break;
+            }
+            reader->pos += len;
+            if (expect & JSON_EXPECT_KEY) {
+                reader->super = reader->count - 1;
+                reader->expect = JSON_EXPECT_COLON;
+            } else {
+                json_reader_value_done(reader);
+            }
+        } else if (json_is_primitive_char(c)) {
+            // A root value is always a container, so a primitive always ends before the input does
+            if (!(expect & JSON_EXPECT_VALUE) || reader->super < 0) {
+                reader->status = JSON_ERR_INVALID;
+                break;
+            }
+            size_t end = pos;
+            while (end < reader->len && json_is_primitive_char(reader->input[end])) {
+                end++;
+            }
+            if (end == reader->len) {
+                break;  // Rest of the number still to come
+            }
+            if (!json_primitive_valid(&reader->input[pos], end - pos)) {
+                reader->status = JSON_ERR_INVALID;
+                break;
+            }
+            if (json_reader_alloc(reader, JSON_TYPE_PRIMITIVE, (int)pos, (int)end) == NULL) {
+                break;
+            }
+            reader->pos = end;
+            json_reader_value_done(reader);
+        } else {
+            reader->status = JSON_ERR_INVALID;
+        }
+    }
+    return reader->status;
+}
+
+/**
+ * @brief Free input space, so a receive can write straight into the reader
+ */
+char *json_reader_tail(json_reader_t *reader, size_t *room)
+{
+    *room = sizeof(reader->input) - reader->len;
+    return &reader->input[reader->len];
+}
+
+/**
+ * @brief Tokenize bytes written to json_reader_tail()
+ */
+json_status_t json_reader_advance(json_reader_t *reader, size_t len)
+{
+    if (len > sizeof(reader->input) - reader->len) {
+        reader->status = JSON_ERR_TOO_LARGE;
+        return reader->status;
+    }
+    reader->len += len;
+    return json_reader_run(reader);
+}
+
+/**
+ * @brief Copy bytes into the reader and tokenize them
+ */
+json_status_t json_reader_feed(json_reader_t *reader, const char *data, size_t len)
+{
+    size_t room;
+    char *tail = json_reader_tail(reader, &room);
+    if (len > room) {
+        reader->status = JSON_ERR_TOO_LARGE;
+        return reader->status;
+    }
+    memcpy(tail, data, len);
+    return json_reader_advance(reader, len);
+}
+
+/**
+ * @brief Value of an object member
+ */
+int json_reader_find(const json_reader_t *reader, int object, const char *key)
+{
+    if (reader->status != JSON_OK || object < 0 || object >= reader->count ||
+        reader->tokens[object].type != JSON_TYPE_OBJECT) {
+        return -1;
+    }
+    size_t key_len = strlen(key);
+    // Members follow their object in input order; a key's value is the next token
+    for (int i = object + 1; i < reader->count && reader->tokens[i].start < reader->tokens[object].end; i++) {
+        const json_token_t *token = &reader->tokens[i];
+        if (token->parent == object && (size_t)(token->end - token->start) == key_len &&
+            memcmp(&reader->input[token->start], key, key_len) == 0) {
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Read a token as true or false
+ */
+bool json_reader_get_bool(const json_reader_t *reader, int token, bool *value)
+{
+    if (token < 0 || token >= reader->count || reader->tokens[token].type != JSON_TYPE_PRIMITIVE) {
+        return false;
+    }
+    const char *s = &reader->input[reader->tokens[token].start];
+    if (s[0] == 't') {
+        *value = true;
+        return true;
+    }
+    if (s[0] == 'f') {
+        *value = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Read a token as an integer
+ */
+bool json_reader_get_int(const json_reader_t *reader, int token, int64_t *value)
+{
+    if (token < 0 || token >= reader->count || reader->tokens[token].type != JSON_TYPE_PRIMITIVE) {
+        return false;
+    }
+    const json_token_t *t = &reader->tokens[token];
+    const char *s = &reader->input[t->start];
+    size_t len = t->end - t->start;
+    bool negative = s[0] == '-';
+    size_t i = negative ? 1 : 0;
+    if (len - i > 18) {
+        return false;  // Would not fit
+    }
+    int64_t v = 0;
+    for (; i < len; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return false;  // Literal, fraction or exponent
+        }
+        v = v * 10 + (s[i] - '0');
+    }
+    *value = negative ? -v : v;
+    return true;
+}
+
+/**
+ * @brief Start a document
+ */
+void json_writer_init(json_writer_t *writer, char *buf, size_t size, json_sink_t sink, void *ctx)
+{
+    writer->buf = buf;
+    writer->size = size;
+    writer->len = 0;
+    writer->sink = sink;
+    writer->ctx = ctx;
+    writer->need_comma = false;
+    writer->flushed = false;
+    writer->failed = false;
+}
+
+/**
+ * @brief Give the buffered bytes to the sink
+ */
+bool json_writer_flush(json_writer_t *writer)
+{
+    if (writer->failed) {
+        return false;
+    }
+    if (writer->sink == NULL || writer->len == 0) {
+        return true;
+    }
+    writer->flushed = true;
+    if (!writer->sink(writer->ctx, writer->buf, writer->len)) {
+        writer->failed = true;
+        return false;
+    }
+    writer->len = 0;
+    return true;
+}
+
+/**
+ * @brief Append raw bytes, flushing when the buffer is full
+ */
+static void json_put(json_writer_t *writer, const char *data, size_t len)
+{
+    while (!writer->failed && len > 0) {
+        size_t room = writer->size - writer->len;
+        if (room == 0) {
+            if (writer->sink == NULL) {
+                writer->failed = true;  // Document does not fit the buffer
+                return;
+            }
+            json_writer_flush(writer);
+            continue;
+        }
+        size_t n = len < room ? len : room;
+        memcpy(writer->buf + writer->len, data, n);
+        writer->len += n;
+        data += n;
+        len -= n;
+    }
+}
+
+static void json_put_char(json_writer_t *writer, char c)
+{
+    if (writer->len < writer->size) {
+        writer->buf[writer->len++] = c;  // Common case
+    } else {
+        json_put(writer, &c, 1);
+    }
+}
+
+/**
+ * @brief Comma before a value or key, unless it is the first at its level
+ */
+static void json_separate(json_writer_t *writer)
+{
+    if (writer->need_comma) {
+        json_put_char(writer, ',');
+    }
+    writer->need_comma = true;
+}
+
+/**
+ * @brief Quoted, escaped string
+ */
+static void json_put_string(json_writer_t *writer, const char *s)
+{
+    static const char hex[] = "0123456789abcdef";
+    json_put_char(writer, '"');
+    while (*s != '\0') {
+        // Copy runs that need no escaping in one go
+        size_t run = 0;
+        while (s[run] != '\0' && s[run] != '"' && s[run] != '\\' && (unsigned char)s[run] >= 0x20) {
+            run++;
+        }
+        json_put(writer, s, run);
+        s += run;
+        if (*s == '\0') {
+            break;
+        }
+        char esc[6] = {'\\', *s, 0, 0, 0, 0};
+        size_t esc_len = 2;
+        switch (*s) {
+        case '"': case '\\':
+            break;
+        case '\n': esc[1] = 'n'; break;
+        case '\r': esc[1] = 'r'; break;
+        case '\t': esc[1] = 't'; break;
+        default:
+            esc[1] = 'u';
+            esc[2] = '0';
+            esc[3] = '0';
+            esc[4] = hex[(unsigned char)*s >> 4];
+            esc[5] = hex[*s & 0xf];
+            esc_len = 6;
+            break;
+        }
+        json_put(writer, esc, esc_len);
+        s++;
+    }
+    json_put_char(writer, '"');
+}
+
+void json_obj_begin(json_writer_t *writer)
+{
+    json_separate(writer);
+    json_put_char(writer, '{');
+    writer->need_comma = false;
+}
+
+void json_obj_end(json_writer_t *writer)
+{
+    json_put_char(writer, '}');
+    writer->need_comma = true;
+}
+
+void json_arr_begin(json_writer_t *writer)
+{
+    json_separate(writer);
+    json_put_char(writer, '[');
+    writer->need_comma = false;
+}
+
+void json_arr_end(json_writer_t *writer)
+{
+    json_put_char(writer, ']');
+    writer->need_comma = true;
+}
+
+/**
+ * @brief Object member name; the value follows with any value call
+ */
+void json_key(json_writer_t *writer, const char *key)
+{
+    json_separate(writer);
+    json_put_string(writer, key);
+    json_put_char(writer, ':');
+    writer->need_comma = false;
+}
+
+void json_str(json_writer_t *writer, const char *value)
+{
+    json_separate(writer);
+    json_put_string(writer, value);
+}
+
+void json_int(json_writer_t *writer, int64_t value)
+{
+    char digits[20];
+    size_t n = sizeof(digits);
+    uint64_t v = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    do {
+        digits[--n] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    if (value < 0) {
+        digits[--n] = '-';
+    }
+    json_separate(writer);
+    json_put(writer, &digits[n], sizeof(digits) - n);
+}
+
+void json_bool(json_writer_t *writer, bool value)
+{
+    json_separate(writer);
+    if (value) {
+        json_put(writer, "true", 4);
+    } else {
+        json_put(writer, "false", 5);
+    }
+}
+
+void json_null(json_writer_t *writer)
+{
+    json_separate(writer);
+    json_put(writer, "null", 4);
+}
+
+void json_kv_str(json_writer_t *writer, const char *key, const char *value)
+{
+    json_key(writer, key);
+    json_str(writer, value);
+}
+
+void json_kv_int(json_writer_t *writer, const char *key, int64_t value)
+{
+    json_key(writer, key);
+    json_int(writer, value);
+}
+
+void json_kv_bool(json_writer_t *writer, const char *key, bool value)
+{
+    json_key(writer, key);
+    json_bool(writer, value);
+}
@@ -0,0 +1,201 @@
+/*
+ * JSON Stream Component Header
+ *
+ * A tokenizing JSON reader and a streaming JSON writer for the HTTP API and
+ * the WebSocket push, both without heap allocation. The reader keeps the
+ * input and a fixed token pool in its own struct (callers put it on the
+ * stack) and is fed as the body arrives, one receive at a time. The writer
+ * formats into a caller-supplied buffer and hands it to a sink whenever it
+ * fills up, so a response of any length needs only that buffer.
+ *
+ * Plain C with no ESP-IDF dependencies, so main/tools/json_bench.c can build
+ * it on the host.
+ */
+
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JSON_READER_MAX_INPUT   256     // Longest document the reader accepts
+#define JSON_READER_MAX_TOKENS  32
+
+/**
+ * @brief Reader result
+ */
+typedef enum {
+    JSON_OK = 0,                // One complete object or array was read
+    JSON_PARTIAL,               // Valid so far, more input needed
+    JSON_ERR_INVALID,           // Not JSON, a root that is not an object or array, or more than one root value
+    JSON_ERR_NO_TOKENS,         // More than JSON_READER_MAX_TOKENS values and keys
+    JSON_ERR_TOO_LARGE,         // More than JSON_READER_MAX_INPUT bytes
+} json_status_t;
+
+/**
+ * @brief Token types
+ */
+typedef enum {
+    JSON_TYPE_OBJECT = 1,
+    JSON_TYPE_ARRAY,
+    JSON_TYPE_STRING,           // Key or value, without the quotes and not unescaped
+    JSON_TYPE_PRIMITIVE,        // Number, true, false or null
+} json_type_t;
+
+/**
+ * @brief One token: a span of the input
+ *
+ * As in jsmn, the parent of an object member's value is its key, and "size"
+ * counts an object's keys, an array's elements and a key's value (1).
+ */
+typedef struct {
+    uint8_t type;               // json_type_t
+    int16_t start;              // Offset of the first character
+    int16_t end;                // Offset past the last character, -1 while a container is open
+    int16_t size;
+    int16_t parent;             // Token index, -1 for the root
+} json_token_t;
+
+/**
+ * @brief Reader state, input and tokens (about 600 bytes, meant for the stack)
+ */
+typedef struct {
+    char input[JSON_READER_MAX_INPUT];
+    size_t len;                 // Bytes of input received
+    size_t pos;                 // Bytes of input tokenized
+    int count;                  // Tokens in use
+    int super;                  // Open container, or key waiting for its value; -1 at the root
+    uint8_t expect;             // What may come next (JSON_EXPECT_* in json_stream.c)
+    json_status_t status;
+    json_token_t tokens[JSON_READER_MAX_TOKENS];
+} json_reader_t;
+
+/**
+ * @brief Start a new document
+ */
+void json_reader_init(json_reader_t *reader);
+
+/**
+ * @brief Free input space, so a receive can write straight into the reader
+ *
+ * @param reader Reader
+ * @param room Output: bytes that fit
+ * @return char* Where the next bytes go
+ */
+char *json_reader_tail(json_reader_t *reader, size_t *room);
+
+/**
+ * @brief Tokenize bytes written to json_reader_tail()
+ *
+ * A string or number cut by the end of the input is read again once more
+ * input has arrived, so the input may be split anywhere.
+ *
+ * @param reader Reader
+ * @param len Bytes written, at most the room json_reader_tail() reported
+ * @return json_status_t JSON_PARTIAL until the root closes, then JSON_OK;
+ *         errors are sticky
+ */
+json_status_t json_reader_advance(json_reader_t *reader, size_t len);
+
+/**
+ * @brief Copy bytes into the reader and tokenize them
+ *
+ * @return json_status_t As for json_reader_advance(), or JSON_ERR_TOO_LARGE
+ */
+json_status_t json_reader_feed(json_reader_t *reader, const char *data, size_t len);
+
+/**
+ * @brief Value of an object member
+ *
+ * @param reader Reader that returned JSON_OK
+ * @param object Token index of the object, 0 for the root
+ * @param key Member name (compared as written, escapes are not decoded)
+ * @return int Token index of the value, -1 if the object has no such member
+ */
+int json_reader_find(const json_reader_t *reader, int object, const char *key);
+
+/**
+ * @brief Read a token as true or false
+ *
+ * @return bool false if the token is not a boolean
+ */
+bool json_reader_get_bool(const json_reader_t *reader, int token, bool *value);
+
+/**
+ * @brief Read a token as an integer
+ *
+ * @return bool false if the token is not an integer (fractions and exponents are rejected)
+ */
+bool json_reader_get_int(const json_reader_t *reader, int token, int64_t *value);
+
+/**
+ * @brief Writer sink: takes a full buffer (or the rest at the end)
+ *
+ * @param ctx Context given to json_writer_init()
+ * @param data Formatted JSON
+ * @param len Bytes
+ * @return bool false to stop the writer
+ */
+typedef bool (*json_sink_t)(void *ctx, const char *data, size_t len);
+
+/**
+ * @brief Writer state
+ */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;                 // Bytes in buf not yet given to the sink
+    json_sink_t sink;           // NULL: the document must fit buf
+    void *ctx;
+    bool need_comma;            // A value was written at this level
+    bool flushed;               // The sink has been called
+    bool failed;                // Sink error or buffer overflow; later calls do nothing
+} json_writer_t;
+
+/**
+ * @brief Start a document
+ *
+ * @param writer Writer
+ * @param buf Format buffer; with a sink, its size is the chunk size
+ * @param size Size of buf
+ * @param sink Where full buffers go, or NULL to format into buf only
+ * @param ctx Passed to the sink
+ */
+void json_writer_init(json_writer_t *writer, char *buf, size_t size, json_sink_t sink, void *ctx);
+
+void json_obj_begin(json_writer_t *writer);
+void json_obj_end(json_writer_t *writer);
+void json_arr_begin(json_writer_t *writer);
+void json_arr_end(json_writer_t *writer);
+
+/**
+ * @brief Object member name; the value follows with any value call
+ */
+void json_key(json_writer_t *writer, const char *key);
+
+void json_str(json_writer_t *writer, const char *value);    // Escaped as needed
+void json_int(json_writer_t *writer, int64_t value);
+void json_bool(json_writer_t *writer, bool value);
+void json_null(json_writer_t *writer);
+
+void json_kv_str(json_writer_t *writer, const char *key, const char *value);
+void json_kv_int(json_writer_t *writer, const char *key, int64_t value);
+void json_kv_bool(json_writer_t *writer, const char *key, bool value);
+
+/**
+ * @brief Give the buffered bytes to the sink
+ *
+ * @return bool false if the writer failed
+ */
+bool json_writer_flush(json_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_STREAM_H
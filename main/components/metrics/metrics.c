@@ -0,0 +1,276 @@
+/*
+ * Metrics Component
+ *
+ * A counter is one 32-bit atomic per core. The recording side adds to the
+ * slot of the core it runs on with relaxed ordering, so a task on core 0 and
+ * one on core 1 (or an ISR) never fight over the same word and no lock is
+ * taken; the reader sums the slots, which may be a sample or two behind.
+ *
+ * Values are formatted line by line into a small buffer that goes to the
+ * sink whenever the next line would not fit, so an exposition of any length
+ * costs one buffer on the caller's stack. Fractions are formatted from
+ * integers, keeping floating point out of the HTTP task.
+ */
+
+#include "metrics.h"
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "metrics";
+
+#define METRICS_MAX_TASKS 32    // Task snapshot size; more tasks skip the task families
+
+static const uint32_t latency_bounds_us[METRICS_LATENCY_BUCKETS] = {
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000, 5000000,
+};
+static const char *const latency_bounds_le[METRICS_LATENCY_BUCKETS] = {
+    "0.001", "0.0025", "0.005", "0.01", "0.025", "0.05", "0.1", "0.25", "1", "5",
+};
+
+/**
+ * @brief Add to a counter (lock-free, safe from any task or ISR)
+ */
+void metrics_counter_add(metrics_counter_t *counter, uint32_t value)
+{
+    atomic_fetch_add_explicit(&counter->core[esp_cpu_get_core_id()], value, memory_order_relaxed);
+}
+
+/**
+ * @brief Current total of a counter over all cores
+ */
+uint32_t metrics_counter_read(const metrics_counter_t *counter)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < METRICS_CORES; i++) {
+        total += (uint32_t)atomic_load_explicit(&counter->core[i], memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Record one latency sample
+ */
+void metrics_histogram_observe(metrics_histogram_t *histogram, uint32_t value_us)
+{
+    int bucket = 0;
+    while (bucket < METRICS_LATENCY_BUCKETS && value_us > latency_bounds_us[bucket]) {
+        bucket++;
+    }
+    metrics_counter_inc(&histogram->buckets[bucket]);
+    metrics_counter_add(&histogram->sum_us, value_us);
+}
+
+/**
+ * @brief Number of samples recorded in a histogram
+ */
+uint32_t metrics_histogram_count(const metrics_histogram_t *histogram)
+{
+    uint32_t count = 0;
+    for (int i = 0; i <= METRICS_LATENCY_BUCKETS; i++) {
+        count += metrics_counter_read(&histogram->buckets[i]);
+    }
+    return count;
+}
+
+/**
+ * @brief Start an exposition
+ */
+void metrics_writer_init(metrics_writer_t *writer, char *buf, size_t size, metrics_sink_t sink, void *ctx)
+{
+    memset(writer, 0, sizeof(metrics_writer_t));
+    writer->buf = buf;
+    writer->size = size;
+    writer->sink = sink;
+    writer->ctx = ctx;
+}
+
+/**
+ * @brief Give the buffered bytes to the sink
+ */
+bool metrics_writer_flush(metrics_writer_t *writer)
+{
+    if (writer->failed) {
+        return false;
+    }
+    if (writer->len > 0) {
+        if (!writer->sink(writer->ctx, writer->buf, writer->len)) {
+            writer->failed = true;
+            return false;
+        }
+        writer->len = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Append formatted text, flushing to the sink when the buffer is full
+ */
+void metrics_printf(metrics_writer_t *writer, const char *fmt, ...)
+{
+    if (writer->failed) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    size_t room = writer->size - writer->len;
+    int len = vsnprintf(writer->buf + writer->len, room, fmt, args);
+    va_end(args);
+    if (len >= 0 && (size_t)len < room) {
+        writer->len += len;
+        return;
+    }
+
+    // Did not fit behind what is buffered: send that, then format again at the start
+    if (len < 0 || !metrics_writer_flush(writer)) {
+        writer->failed = true;
+        return;
+    }
+    va_start(args, fmt);
+    len = vsnprintf(writer->buf, writer->size, fmt, args);
+    va_end(args);
+    if (len < 0 || (size_t)len >= writer->size) {
+        ESP_LOGW(TAG, "Line longer than the %u byte buffer", (unsigned)writer->size);
+        writer->failed = true;
+        return;
+    }
+    writer->len = len;
+}
+
+/**
+ * @brief Start a metric family: its # HELP and # TYPE lines
+ */
+void metrics_write_family(metrics_writer_t *writer, const char *name, const char *type, const char *help)
+{
+    metrics_printf(writer, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+/**
+ * @brief One sample line with an integer value
+ */
+void metrics_write_int(metrics_writer_t *writer, const char *name, const char *labels, int64_t value)
+{
+    if (labels != NULL) {
+        metrics_printf(writer, "%s{%s} %" PRId64 "\n", name, labels, value);
+    } else {
+        metrics_printf(writer, "%s %" PRId64 "\n", name, value);
+    }
+}
+
+/**
+ * @brief One sample line with a value in microseconds, written in seconds
+ */
+void metrics_write_seconds(metrics_writer_t *writer, const char *name, const char *labels, uint64_t value_us)
+{
+    uint64_t whole = value_us / 1000000;
+    uint32_t frac = (uint32_t)(value_us % 1000000);
+    if (labels != NULL) {
+        metrics_printf(writer, "%s{%s} %" PRIu64 ".%06" PRIu32 "\n", name, labels, whole, frac);
+    } else {
+        metrics_printf(writer, "%s %" PRIu64 ".%06" PRIu32 "\n", name, whole, frac);
+    }
+}
+
+/**
+ * @brief The _bucket, _sum and _count lines of one histogram
+ */
+void metrics_write_histogram(metrics_writer_t *writer, const char *name, const char *labels,
+                             const metrics_histogram_t *histogram)
+{
+    const char *sep = labels != NULL ? "," : "";
+    if (labels == NULL) {
+        labels = "";
+    }
+
+    // Buckets are read once, so the cumulative counts and _count agree with each other
+    uint32_t cumulative = 0;
+    for (int i = 0; i <= METRICS_LATENCY_BUCKETS; i++) {
+        cumulative += metrics_counter_read(&histogram->buckets[i]);
+        metrics_printf(writer, "%s_bucket{%s%sle=\"%s\"} %" PRIu32 "\n", name, labels, sep,
+                       i < METRICS_LATENCY_BUCKETS ? latency_bounds_le[i] : "+Inf", cumulative);
+    }
+
+    char sample[64];
+    snprintf(sample, sizeof(sample), "%s_sum", name);
+    metrics_write_seconds(writer, sample, labels[0] != '\0' ? labels : NULL, metrics_counter_read(&histogram->sum_us));
+    snprintf(sample, sizeof(sample), "%s_count", name);
+    metrics_write_int(writer, sample, labels[0] != '\0' ? labels : NULL, cumulative);
+}
+
+#if CONFIG_EXAMPLE_METRICS_TASK_STATS
+/**
+ * @brief CPU time and stack high-water mark of every task
+ */
+static void metrics_write_tasks(metrics_writer_t *writer)
+{
+    // Snapshot of about 1.5 KB; static because the HTTP task's stack is the tight resource
+    static TaskStatus_t tasks[METRICS_MAX_TASKS];
+    UBaseType_t count = uxTaskGetSystemState(tasks, METRICS_MAX_TASKS, NULL);
+    if (count == 0) {
+        ESP_LOGW(TAG, "More than %d tasks, task metrics skipped", METRICS_MAX_TASKS);
+        return;
+    }
+
+    // Names are not unique (every HTTP worker is "http_worker"), so the task number
+    // goes into the labels too; otherwise Prometheus drops the repeats as duplicates
+    char labels[64];
+    metrics_write_family(writer, "smartsocket_task_cpu_seconds_total", "counter",
+                         "CPU time spent in each task (run time counter, wraps with its width).");
+    for (UBaseType_t i = 0; i < count; i++) {
+        BaseType_t core = xTaskGetCoreID(tasks[i].xHandle);
+        unsigned id = (unsigned)tasks[i].xTaskNumber;
+        if (core == tskNO_AFFINITY) {
+            snprintf(labels, sizeof(labels), "task=\"%s\",id=\"%u\",core=\"any\"", tasks[i].pcTaskName, id);
+        } else {
+            snprintf(labels, sizeof(labels), "task=\"%s\",id=\"%u\",core=\"%d\"", tasks[i].pcTaskName, id, (int)core);
+        }
+        // The run time counter is clocked by esp_timer, so it counts microseconds
+        metrics_write_seconds(writer, "smartsocket_task_cpu_seconds_total", labels, tasks[i].ulRunTimeCounter);
+    }
+
+    metrics_write_family(writer, "smartsocket_task_stack_free_min_bytes", "gauge",
+                         "Least free stack each task has had (high-water mark).");
+    for (UBaseType_t i = 0; i < count; i++) {
+        snprintf(labels, sizeof(labels), "task=\"%s\",id=\"%u\"", tasks[i].pcTaskName, (unsigned)tasks[i].xTaskNumber);
+        // StackType_t is one byte on ESP-IDF, so the mark is already in bytes
+        metrics_write_int(writer, "smartsocket_task_stack_free_min_bytes", labels, tasks[i].usStackHighWaterMark);
+    }
+}
+#endif
+
+/**
+ * @brief Heap, uptime and per-task CPU time and stack
+ */
+void metrics_write_system(metrics_writer_t *writer)
+{
+    metrics_write_family(writer, "smartsocket_uptime_seconds", "gauge", "Time since boot.");
+    metrics_write_seconds(writer, "smartsocket_uptime_seconds", NULL, (uint64_t)esp_timer_get_time());
+
+    bool has_psram = heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+    metrics_write_family(writer, "smartsocket_heap_free_bytes", "gauge", "Free heap.");
+    metrics_write_int(writer, "smartsocket_heap_free_bytes", "memory=\"internal\"",
+                      heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+    if (has_psram) {
+        metrics_write_int(writer, "smartsocket_heap_free_bytes", "memory=\"psram\"",
+                          heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+    }
+    metrics_write_family(writer, "smartsocket_heap_min_free_bytes", "gauge", "Lowest free heap since boot.");
+    metrics_write_int(writer, "smartsocket_heap_min_free_bytes", "memory=\"internal\"",
+                      heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+    if (has_psram) {
+        metrics_write_int(writer, "smartsocket_heap_min_free_bytes", "memory=\"psram\"",
+                          heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+    }
+
+#if CONFIG_EXAMPLE_METRICS_TASK_STATS
+    metrics_write_tasks(writer);
+#endif
+}
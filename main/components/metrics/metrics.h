@@ -0,0 +1,163 @@
+/*
+ * Metrics Component Header
+ *
+ * Counters and latency histograms for the /metrics endpoint, and a writer
+ * for the Prometheus text exposition format that streams through a sink the
+ * same way json_writer_t does, so the response never has to fit in RAM.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_CORES             CONFIG_SOC_CPU_CORES_NUM
+#define METRICS_LATENCY_BUCKETS   10    // Finite buckets of a latency histogram; +Inf comes on top
+
+/**
+ * @brief Event counter with one slot per core
+ *
+ * Each core only adds to its own slot, so concurrent updates from both cores
+ * never contend on the same word. Readers sum the slots; the total wraps at
+ * 2^32, which Prometheus treats as a counter reset.
+ */
+typedef struct {
+    atomic_uint_fast32_t core[METRICS_CORES];
+} metrics_counter_t;
+
+/**
+ * @brief Latency histogram in microseconds, exported in seconds
+ *
+ * Bucket bounds are fixed (1 ms to 5 s). The request count is the sum of the
+ * buckets, so recording a sample is two counter updates.
+ */
+typedef struct {
+    metrics_counter_t buckets[METRICS_LATENCY_BUCKETS + 1];    // Not cumulative; the last one is +Inf
+    metrics_counter_t sum_us;                                  // Wraps after about 71 minutes of total latency
+} metrics_histogram_t;
+
+/**
+ * @brief Add to a counter (lock-free, safe from any task or ISR)
+ */
+void metrics_counter_add(metrics_counter_t *counter, uint32_t value);
+
+static inline void metrics_counter_inc(metrics_counter_t *counter)
+{
+    metrics_counter_add(counter, 1);
+}
+
+/**
+ * @brief Current total of a counter over all cores
+ */
+uint32_t metrics_counter_read(const metrics_counter_t *counter);
+
+/**
+ * @brief Record one latency sample (lock-free, safe from any task or ISR)
+ */
+void metrics_histogram_observe(metrics_histogram_t *histogram, uint32_t value_us);
+
+/**
+ * @brief Number of samples recorded in a histogram
+ */
+uint32_t metrics_histogram_count(const metrics_histogram_t *histogram);
+
+/**
+ * @brief Writer sink: takes a full buffer (or the rest at the end)
+ *
+ * @return bool false to stop the writer
+ */
+typedef bool (*metrics_sink_t)(void *ctx, const char *data, size_t len);
+
+/**
+ * @brief Writer state
+ */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;                 // Bytes in buf not yet given to the sink
+    metrics_sink_t sink;
+    void *ctx;
+    bool failed;                // Sink error or a line longer than buf; later calls do nothing
+} metrics_writer_t;
+
+/**
+ * @brief Start an exposition
+ *
+ * @param writer Writer
+ * @param buf Format buffer, also the chunk size; must hold the longest line
+ * @param size Size of buf
+ * @param sink Where full buffers go
+ * @param ctx Passed to the sink
+ */
+void metrics_writer_init(metrics_writer_t *writer, char *buf, size_t size, metrics_sink_t sink, void *ctx);
+
+/**
+ * @brief Append formatted text, flushing to the sink when the buffer is full
+ */
+void metrics_printf(metrics_writer_t *writer, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Start a metric family: its # HELP and # TYPE lines
+ *
+ * All samples of a family must follow before the next family starts.
+ *
+ * @param writer Writer
+ * @param name Metric name
+ * @param type "counter", "gauge" or "histogram"
+ * @param help One line of help text
+ */
+void metrics_write_family(metrics_writer_t *writer, const char *name, const char *type, const char *help);
+
+/**
+ * @brief One sample line with an integer value
+ *
+ * @param writer Writer
+ * @param name Metric name
+ * @param labels Label pairs without braces, e.g. "relay=\"1\"", or NULL
+ * @param value Value
+ */
+void metrics_write_int(metrics_writer_t *writer, const char *name, const char *labels, int64_t value);
+
+/**
+ * @brief One sample line with a value in microseconds, written in seconds
+ */
+void metrics_write_seconds(metrics_writer_t *writer, const char *name, const char *labels, uint64_t value_us);
+
+/**
+ * @brief The _bucket, _sum and _count lines of one histogram
+ *
+ * @param writer Writer
+ * @param name Family name, without the suffixes
+ * @param labels Label pairs without braces, or NULL
+ * @param histogram Histogram
+ */
+void metrics_write_histogram(metrics_writer_t *writer, const char *name, const char *labels,
+                             const metrics_histogram_t *histogram);
+
+/**
+ * @brief Heap, uptime and, with CONFIG_EXAMPLE_METRICS_TASK_STATS, per-task CPU time and stack
+ *
+ * Task stats use a static snapshot array, so call this from one task only.
+ */
+void metrics_write_system(metrics_writer_t *writer);
+
+/**
+ * @brief Give the buffered bytes to the sink
+ *
+ * @return bool false if the writer failed
+ */
+bool metrics_writer_flush(metrics_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
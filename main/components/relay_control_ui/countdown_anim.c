@@ -0,0 +1,255 @@
+/*
+ * Countdown Animation Driver
+ *
+ * Replaces the one-second lv_anim_t that every active relay used to start on
+ * each countdown tick. A single LVGL timer, capped at
+ * CONFIG_EXAMPLE_COUNTDOWN_ANIM_FPS, recomputes each bar from its absolute
+ * deadline. lv_bar_set_value() is only called when the value actually moves,
+ * and with the bar range set to its width in pixels that means at most one
+ * redraw per pixel of progress. Between frames the timer sleeps until the next
+ * bar step or colour threshold is due, and it pauses itself when no bar is active.
+ */
+
+#include "countdown_anim.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "lvgl.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "relay_theme.h"
+
+static const char *TAG = "countdown_anim";
+
+#define COUNTDOWN_ANIM_PERIOD_MS  (1000 / CONFIG_EXAMPLE_COUNTDOWN_ANIM_FPS)
+
+typedef enum {
+    ZONE_UNKNOWN = 0,
+    ZONE_OK,
+    ZONE_WARNING,
+    ZONE_CRITICAL,
+} countdown_zone_t;
+
+typedef struct {
+    lv_obj_t *bar;
+    ui_binding_t *binding;
+    int64_t start_us;
+    int64_t end_us;
+    countdown_zone_t zone;
+} countdown_entry_t;
+
+static countdown_entry_t entries[COUNTDOWN_ANIM_MAX_BARS];
+static uint32_t active_count = 0;
+static lv_timer_t *anim_timer = NULL;
+static bool suspended = false;
+static countdown_anim_stats_t anim_stats;
+
+/**
+ * @brief Apply the colour state of a zone (threshold crossings only)
+ */
+static void countdown_set_zone(countdown_entry_t *entry, countdown_zone_t zone)
+{
+    if (zone == entry->zone) {
+        return;
+    }
+    entry->zone = zone;
+    anim_stats.color_changes++;
+    ui_binding_set_state(entry->binding, RELAY_THEME_STATE_WARNING, zone == ZONE_WARNING);
+    ui_binding_set_state(entry->binding, RELAY_THEME_STATE_CRITICAL, zone == ZONE_CRITICAL);
+}
+
+/**
+ * @brief Earliest of a candidate time and the current best, ignoring times that have passed
+ */
+static int64_t countdown_earliest(int64_t best_us, int64_t candidate_us, int64_t now_us)
+{
+    return (candidate_us > now_us && candidate_us < best_us) ? candidate_us : best_us;
+}
+
+/**
+ * @brief Move one bar to the position for the given time
+ * 
+ * @return int64_t Time of the next step or threshold crossing of this bar, INT64_MAX when finished
+ */
+static int64_t countdown_update_entry(countdown_entry_t *entry, int64_t now_us)
+{
+    int64_t duration_us = entry->end_us - entry->start_us;
+    int64_t elapsed_us = now_us - entry->start_us;
+    if (elapsed_us < 0) {
+        elapsed_us = 0;
+    }
+    if (elapsed_us > duration_us) {
+        elapsed_us = duration_us;
+    }
+
+    int32_t min = lv_bar_get_min_value(entry->bar);
+    int32_t max = lv_bar_get_max_value(entry->bar);
+    int32_t value = min;
+    uint32_t remaining_pct = 100;
+    if (duration_us > 0) {
+        value = min + (int32_t)(((int64_t)(max - min) * elapsed_us) / duration_us);
+        remaining_pct = (uint32_t)(100 - (elapsed_us * 100) / duration_us);
+    }
+
+    if (lv_bar_get_value(entry->bar) != value) {
+        lv_bar_set_value(entry->bar, value, LV_ANIM_OFF);
+        anim_stats.bar_updates++;
+    }
+
+    if (remaining_pct <= COUNTDOWN_ANIM_CRITICAL_PCT) {
+        countdown_set_zone(entry, ZONE_CRITICAL);
+    } else if (remaining_pct <= COUNTDOWN_ANIM_WARNING_PCT) {
+        countdown_set_zone(entry, ZONE_WARNING);
+    } else {
+        countdown_set_zone(entry, ZONE_OK);
+    }
+
+    int64_t next_us = INT64_MAX;
+    if (duration_us > 0 && value < max) {
+        // Rounded up, so the wakeup is never before the value changes
+        int64_t step_us = ((int64_t)(value + 1 - min) * duration_us + (max - min) - 1) / (max - min);
+        next_us = countdown_earliest(next_us, entry->start_us + step_us, now_us);
+        next_us = countdown_earliest(next_us, entry->start_us + duration_us * (100 - COUNTDOWN_ANIM_WARNING_PCT) / 100, now_us);
+        next_us = countdown_earliest(next_us, entry->start_us + duration_us * (100 - COUNTDOWN_ANIM_CRITICAL_PCT) / 100, now_us);
+    }
+    return next_us;
+}
+
+/**
+ * @brief LVGL timer - one frame for all active bars
+ */
+static void countdown_anim_timer_cb(lv_timer_t *timer)
+{
+    if (active_count == 0 || suspended) {
+        lv_timer_pause(timer);
+        return;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    int64_t next_us = INT64_MAX;
+    anim_stats.frames++;
+    for (int i = 0; i < COUNTDOWN_ANIM_MAX_BARS; i++) {
+        if (entries[i].bar != NULL) {
+            int64_t entry_next_us = countdown_update_entry(&entries[i], now_us);
+            if (entry_next_us < next_us) {
+                next_us = entry_next_us;
+            }
+        }
+    }
+
+    if (next_us == INT64_MAX) {
+        // All bars full - the relays stop them when their timers expire
+        lv_timer_pause(timer);
+        return;
+    }
+    // Sleep until something visibly changes, but never run faster than the frame cap
+    int64_t delay_ms = (next_us - now_us + 999) / 1000;
+    lv_timer_set_period(timer, delay_ms > COUNTDOWN_ANIM_PERIOD_MS ? (uint32_t)delay_ms : COUNTDOWN_ANIM_PERIOD_MS);
+}
+
+/**
+ * @brief Wake the timer for an immediate frame
+ */
+static void countdown_anim_kick(void)
+{
+    if (anim_timer == NULL || suspended || active_count == 0) {
+        return;
+    }
+    lv_timer_resume(anim_timer);
+    lv_timer_ready(anim_timer);
+}
+
+/**
+ * @brief Start (or restart) animating a bar towards an absolute deadline
+ */
+void countdown_anim_start(lv_obj_t *bar, ui_binding_t *binding, int64_t start_us, int64_t end_us)
+{
+    if (bar == NULL || binding == NULL) {
+        return;
+    }
+
+    if (anim_timer == NULL) {
+        anim_timer = lv_timer_create(countdown_anim_timer_cb, COUNTDOWN_ANIM_PERIOD_MS, NULL);
+        if (anim_timer == NULL) {
+            ESP_LOGE(TAG, "Failed to create animation timer");
+            return;
+        }
+        lv_timer_pause(anim_timer);
+        ESP_LOGI(TAG, "Countdown bars animated at up to %d fps", CONFIG_EXAMPLE_COUNTDOWN_ANIM_FPS);
+    }
+
+    countdown_entry_t *entry = NULL;
+    countdown_entry_t *free_entry = NULL;
+    for (int i = 0; i < COUNTDOWN_ANIM_MAX_BARS; i++) {
+        if (entries[i].bar == bar) {
+            entry = &entries[i];
+            break;
+        }
+        if (entries[i].bar == NULL && free_entry == NULL) {
+            free_entry = &entries[i];
+        }
+    }
+
+    if (entry != NULL) {
+        if (entry->start_us == start_us && entry->end_us == end_us) {
+            return;  // Already running towards this deadline
+        }
+    } else {
+        if (free_entry == NULL) {
+            ESP_LOGW(TAG, "No free slot for another countdown bar");
+            return;
+        }
+        entry = free_entry;
+        active_count++;
+    }
+
+    entry->bar = bar;
+    entry->binding = binding;
+    entry->start_us = start_us;
+    entry->end_us = end_us;
+    entry->zone = ZONE_UNKNOWN;
+    countdown_update_entry(entry, esp_timer_get_time());
+    countdown_anim_kick();
+}
+
+/**
+ * @brief Stop animating a bar
+ */
+void countdown_anim_stop(lv_obj_t *bar)
+{
+    for (int i = 0; i < COUNTDOWN_ANIM_MAX_BARS; i++) {
+        if (entries[i].bar == bar && bar != NULL) {
+            memset(&entries[i], 0, sizeof(countdown_entry_t));
+            active_count--;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Pause all bars; resuming jumps them to the current time
+ */
+void countdown_anim_set_suspended(bool suspend)
+{
+    suspended = suspend;
+    if (anim_timer == NULL) {
+        return;
+    }
+    if (suspend) {
+        lv_timer_pause(anim_timer);
+    } else {
+        countdown_anim_kick();
+    }
+}
+
+/**
+ * @brief Get driver statistics
+ */
+void countdown_anim_get_stats(countdown_anim_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    *stats = anim_stats;
+}
@@ -0,0 +1,74 @@
+/*
+ * Countdown Animation Driver Header
+ *
+ * One LVGL timer animates every active countdown progress bar. Bars are
+ * interpolated from their absolute start/end times, so no per-tick
+ * animation objects are created, and the warning/critical colour state is
+ * only changed when a threshold is crossed.
+ */
+
+#ifndef COUNTDOWN_ANIM_H
+#define COUNTDOWN_ANIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+#include "ui_binding.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COUNTDOWN_ANIM_MAX_BARS       8
+#define COUNTDOWN_ANIM_WARNING_PCT    50  // Yellow at or below 50% remaining
+#define COUNTDOWN_ANIM_CRITICAL_PCT   20  // Red at or below 20% remaining
+
+/**
+ * @brief Driver statistics (since boot)
+ */
+typedef struct {
+    uint32_t frames;          // Timer passes with at least one active bar
+    uint32_t bar_updates;     // lv_bar_set_value() calls that changed a bar
+    uint32_t color_changes;   // Threshold crossings
+} countdown_anim_stats_t;
+
+/**
+ * @brief Start (or restart) animating a bar towards an absolute deadline
+ *
+ * The bar fills from its minimum to its maximum value between start_us and
+ * end_us (esp_timer time). Calling it again with the same times does nothing.
+ * LVGL context only.
+ *
+ * @param bar Progress bar object
+ * @param binding Binding of the bar, used for the warning/critical states
+ * @param start_us Countdown start time
+ * @param end_us Countdown deadline
+ */
+void countdown_anim_start(lv_obj_t *bar, ui_binding_t *binding, int64_t start_us, int64_t end_us);
+
+/**
+ * @brief Stop animating a bar (LVGL context only)
+ *
+ * @param bar Progress bar object
+ */
+void countdown_anim_stop(lv_obj_t *bar);
+
+/**
+ * @brief Pause all bars (e.g. while the display is dark); resuming jumps them to the current time
+ *
+ * @param suspended true to pause, false to resume
+ */
+void countdown_anim_set_suspended(bool suspended);
+
+/**
+ * @brief Get driver statistics
+ *
+ * @param stats Output structure
+ */
+void countdown_anim_get_stats(countdown_anim_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COUNTDOWN_ANIM_H
@@ -9,6 +9,7 @@
 
 #include "master_button_ui.h"
 #include "relay_control_ui.h"
+#include "relay_theme.h"
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
@@ -17,6 +18,24 @@
 
 static const char *DEFAULT_TAG = "master_btn";
 
+// Provided by the LVGL port in spi_lcd_touch_example_main.c
+extern void example_lvgl_port_request_timer(lv_timer_t *timer);
+
+/**
+ * @brief LVGL timer callback - applies a requested appearance update, then sleeps again
+ */
+static void master_lvgl_timer_cb(lv_timer_t *timer)
+{
+    master_button_ui_t *master = (master_button_ui_t *)lv_timer_get_user_data(timer);
+    lv_timer_pause(timer);
+    if (master == NULL) {
+        return;
+    }
+    // Clear before reading relay states so a request that races with this pass wakes us again
+    master->update_requested = false;
+    master_button_ui_update_appearance(master);
+}
+
 /**
  * @brief Button click event callback for master button
  */
@@ -119,8 +138,8 @@ master_button_ui_t *master_button_ui_create(lv_obj_t *parent, const char *tag, c
         return NULL;
     }
     
-    // Set button size
-    lv_obj_set_size(master->button, MASTER_BUTTON_WIDTH_PX, MASTER_BUTTON_HEIGHT_PX);
+    // Shared theme styles: size, shape and ON/OFF colours
+    relay_theme_apply_button(master->button, MASTER_BUTTON_WIDTH_PX, MASTER_BUTTON_HEIGHT_PX);
     
     // Position the button according to parameters
     lv_obj_align(master->button, align, x_offset, y_offset);
@@ -135,15 +154,19 @@ master_button_ui_t *master_button_ui_create(lv_obj_t *parent, const char *tag, c
     }
     lv_obj_center(master->label);
     
-    // Set initial appearance (OFF state - red)
-    lv_obj_set_style_bg_color(master->button, MASTER_BUTTON_OFF_COLOR, LV_PART_MAIN);
+    // Set initial appearance (OFF state - red, the theme's default button colour)
     lv_label_set_text_static(master->label, "Master OFF");
     
-    // Make button style more prominent
-    lv_obj_set_style_radius(master->button, 10, LV_PART_MAIN);
-    lv_obj_set_style_shadow_width(master->button, 10, LV_PART_MAIN);
-    lv_obj_set_style_shadow_color(master->button, lv_color_hex(0x808080), LV_PART_MAIN);
-    lv_obj_set_style_shadow_opa(master->button, LV_OPA_50, LV_PART_MAIN);
+    // Paused until master_button_ui_request_update() wakes it from another task
+    master->lvgl_timer = lv_timer_create(master_lvgl_timer_cb, 100, master);
+    if (master->lvgl_timer == NULL) {
+        ESP_LOGE(master->tag, "Failed to create master button timer");
+        lv_obj_del(master->button);
+        free(master);
+        return NULL;
+    }
+    lv_timer_set_repeat_count(master->lvgl_timer, -1);  // Repeat indefinitely
+    lv_timer_pause(master->lvgl_timer);
     
     // Add click event callback with user data pointing to our object
     lv_obj_add_event_cb(master->button, master_button_cb, LV_EVENT_CLICKED, master);
@@ -164,6 +187,11 @@ void master_button_ui_delete(master_button_ui_t *master)
         return;
     }
 
+    if (master->lvgl_timer != NULL) {
+        lv_timer_del(master->lvgl_timer);
+        master->lvgl_timer = NULL;
+    }
+
     // Free controlled_relays array if it exists
     if (master->controlled_relays != NULL) {
         free(master->controlled_relays);
@@ -249,15 +277,27 @@ void master_button_ui_update_appearance(master_button_ui_t *master)
     // Update master button appearance
     if (any_on) {
         // At least one relay is ON - show green
-        lv_obj_set_style_bg_color(master->button, MASTER_BUTTON_ON_COLOR, LV_PART_MAIN);
+        lv_obj_add_state(master->button, RELAY_THEME_STATE_ON);
         lv_label_set_text_static(master->label, "Master ON");
     } else {
         // All relays are OFF - show red
-        lv_obj_set_style_bg_color(master->button, MASTER_BUTTON_OFF_COLOR, LV_PART_MAIN);
+        lv_obj_remove_state(master->button, RELAY_THEME_STATE_ON);
         lv_label_set_text_static(master->label, "Master OFF");
     }
 }
 
+/**
+ * @brief Schedule master_button_ui_update_appearance() on the LVGL task
+ */
+void master_button_ui_request_update(master_button_ui_t *master)
+{
+    if (master == NULL || master->lvgl_timer == NULL || master->update_requested) {
+        return;
+    }
+    master->update_requested = true;
+    example_lvgl_port_request_timer(master->lvgl_timer);
+}
+
 /**
  * @brief Get the button object (for advanced customization)
  * 
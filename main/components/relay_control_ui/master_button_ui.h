@@ -24,8 +24,6 @@ extern "C" {
 
 #define MASTER_BUTTON_WIDTH_PX 100
 #define MASTER_BUTTON_HEIGHT_PX 60
-#define MASTER_BUTTON_OFF_COLOR lv_color_hex(0xC00000)
-#define MASTER_BUTTON_ON_COLOR lv_color_hex(0x00C000)
 
 /**
  * @brief Master Button UI object structure
@@ -37,6 +35,8 @@ typedef struct {
     const char *name;           // Display name (e.g., "Master")
     relay_control_ui_t **controlled_relays; // Array of pointers to controlled relays
     uint8_t num_controlled_relays; // Number of controlled relays
+    lv_timer_t *lvgl_timer;     // Applies requested appearance updates in LVGL context
+    volatile bool update_requested; // LVGL task already asked to run lvgl_timer
 } master_button_ui_t;
 
 /**
@@ -75,6 +75,16 @@ void master_button_ui_set_controlled_relays(master_button_ui_t *master, relay_co
  */
 void master_button_ui_update_appearance(master_button_ui_t *master);
 
+/**
+ * @brief Schedule master_button_ui_update_appearance() on the LVGL task
+ * 
+ * Safe to call from any task (e.g. an HTTP or WebSocket handler that switched
+ * a relay); requests made before the update runs are merged into one.
+ * 
+ * @param master Master button UI object
+ */
+void master_button_ui_request_update(master_button_ui_t *master);
+
 /**
  * @brief Get the button object (for advanced customization)
  * 
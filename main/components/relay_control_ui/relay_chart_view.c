@@ -0,0 +1,303 @@
+/*
+ * Relay Chart View Component
+ *
+ * Detail screen with a live current chart for one relay. The chart always has
+ * RELAY_TELEMETRY_HISTORY_POINTS points; switching zoom tiers rewrites that
+ * same point array in place, so the view never reallocates and its memory is
+ * fixed per chart.
+ *
+ * The screen manager owns the lifetime: the screen is built on the first
+ * open, the poll timer only runs while it is the active screen, and the
+ * whole view is freed when the LRU evicts it.
+ *
+ * New points are appended with lv_chart_set_next_value() in
+ * LV_CHART_UPDATE_MODE_CIRCULAR: the newest point overwrites the oldest one
+ * at a sweeping cursor and LVGL invalidates only the columns around it. In
+ * LV_CHART_UPDATE_MODE_SHIFT every point moves left, so the whole chart area
+ * would be redrawn for each sample.
+ */
+
+#include "relay_chart_view.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "lvgl.h"
+#include "esp_log.h"
+#include "relay_theme.h"
+#include "ui_binding.h"
+#include "display_idle.h"
+#include "screen_manager.h"
+
+static const char *TAG = "relay_chart";
+
+#define CHART_SERIES_COLOR      lv_color_hex(0x00FF00)
+#define CHART_RANGE_STEP_CA     50   // Y axis maximum is rounded up to 0.50 A steps
+
+static const char *const zoom_map[] = { "30 s", "5 min", "30 min", "" };
+static const lv_buttonmatrix_ctrl_t zoom_ctrl_map[] = {
+    LV_BUTTONMATRIX_CTRL_CHECKABLE, LV_BUTTONMATRIX_CTRL_CHECKABLE, LV_BUTTONMATRIX_CTRL_CHECKABLE,
+};
+
+/**
+ * @brief Y axis maximum for a peak value: 25% headroom, rounded up, never below the minimum
+ */
+static int32_t chart_range_for(int32_t peak_ca)
+{
+    int32_t range = peak_ca + peak_ca / 4;
+    range = ((range + CHART_RANGE_STEP_CA - 1) / CHART_RANGE_STEP_CA) * CHART_RANGE_STEP_CA;
+    return range < RELAY_CHART_MIN_RANGE_CA ? RELAY_CHART_MIN_RANGE_CA : range;
+}
+
+/**
+ * @brief Show the relay name and latest reading in the title
+ */
+static void chart_view_update_title(relay_chart_view_t *view)
+{
+    char value_str[12];
+    char title[UI_BINDING_TEXT_LEN];
+
+    ui_binding_format_centi(value_str, sizeof(value_str), relay_telemetry_get_current_ca(view->channel));
+    snprintf(title, sizeof(title), "%s: %s A", view->relay->name, value_str);
+    ui_binding_set_text(&view->title_binding, title);
+}
+
+/**
+ * @brief Fill the chart from the history of the selected tier (rewrites the existing point array)
+ */
+static void chart_view_load_tier(relay_chart_view_t *view)
+{
+    int32_t *points = lv_chart_get_y_array(view->chart, view->series);
+    uint32_t seq = relay_telemetry_get_seq(view->channel, view->tier);
+    uint32_t first = seq > RELAY_TELEMETRY_HISTORY_POINTS ? seq - RELAY_TELEMETRY_HISTORY_POINTS : 0;
+    uint32_t count = 0;
+    int32_t peak = 0;
+
+    for (uint32_t i = 0; i < RELAY_TELEMETRY_HISTORY_POINTS; i++) {
+        points[i] = LV_CHART_POINT_NONE;
+    }
+    for (uint32_t n = first; n < seq; n++, count++) {
+        int16_t value;
+        if (relay_telemetry_get_point(view->channel, view->tier, n, &value)) {
+            points[count] = value;
+            if (value > peak) {
+                peak = value;
+            }
+        }
+    }
+
+    // The next appended point goes right after the newest one
+    lv_chart_set_x_start_point(view->chart, view->series, count % RELAY_TELEMETRY_HISTORY_POINTS);
+    view->next_seq = seq;
+    view->range_ca = chart_range_for(peak);
+    lv_chart_set_range(view->chart, LV_CHART_AXIS_PRIMARY_Y, 0, view->range_ca);
+    lv_chart_refresh(view->chart);
+
+    lv_timer_set_period(view->poll_timer, relay_telemetry_get_point_period_ms(view->tier));
+    lv_timer_reset(view->poll_timer);
+}
+
+/**
+ * @brief Append one point; it is drawn with the next regular refresh
+ *
+ * Only invalidates, so a catch-up of many points costs one render of their
+ * merged columns. What that render costs shows in the render and flush
+ * histograms (GET /api/ui/metrics).
+ */
+static void chart_view_append(relay_chart_view_t *view, int16_t value)
+{
+    if (value > view->range_ca) {
+        // Rare: rescaling moves every point, so this one redraws the whole chart
+        view->range_ca = chart_range_for(value);
+        lv_chart_set_range(view->chart, LV_CHART_AXIS_PRIMARY_Y, 0, view->range_ca);
+    }
+    lv_chart_set_next_value(view->chart, view->series, value);
+}
+
+/**
+ * @brief LVGL timer - appends the history points pushed since the last pass
+ */
+static void chart_view_poll_cb(lv_timer_t *timer)
+{
+    relay_chart_view_t *view = (relay_chart_view_t *)lv_timer_get_user_data(timer);
+
+    // Nothing is visible while dark, catch up on the first pass after wake-up
+    if (display_idle_is_dark()) {
+        return;
+    }
+
+    uint32_t seq = relay_telemetry_get_seq(view->channel, view->tier);
+    if (seq - view->next_seq > RELAY_TELEMETRY_HISTORY_POINTS) {
+        // Fell behind by more than a whole chart - a reload is cheaper than appending
+        chart_view_load_tier(view);
+    } else {
+        // Every pending point first; the refresh after this callback draws them together
+        while (view->next_seq < seq) {
+            int16_t value;
+            if (!relay_telemetry_get_point(view->channel, view->tier, view->next_seq, &value)) {
+                break;
+            }
+            chart_view_append(view, value);
+            view->next_seq++;
+        }
+    }
+    chart_view_update_title(view);
+}
+
+/**
+ * @brief Zoom selector event - switch tiers in place
+ */
+static void chart_view_zoom_cb(lv_event_t *e)
+{
+    relay_chart_view_t *view = (relay_chart_view_t *)lv_event_get_user_data(e);
+    uint32_t selected = lv_buttonmatrix_get_selected_button(lv_event_get_target(e));
+
+    if (selected >= RELAY_TELEMETRY_TIER_COUNT || selected == (uint32_t)view->tier) {
+        return;
+    }
+    view->tier = (relay_telemetry_tier_t)selected;
+    chart_view_load_tier(view);
+    ESP_LOGI(TAG, "%s: zoom %s", view->relay->name, zoom_map[selected]);
+}
+
+/**
+ * @brief Back button event - the screen stays alive for the next visit
+ */
+static void chart_view_back_cb(lv_event_t *e)
+{
+    (void)e;
+    screen_manager_back();
+}
+
+/**
+ * @brief Screen manager hook - build the detail screen of a relay (not loaded, poll timer paused)
+ */
+static lv_obj_t *chart_view_create(void *key, void **instance)
+{
+    relay_control_ui_t *relay = (relay_control_ui_t *)key;
+
+    relay_chart_view_t *view = (relay_chart_view_t *)malloc(sizeof(relay_chart_view_t));
+    if (view == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate memory for chart view");
+        return NULL;
+    }
+    memset(view, 0, sizeof(relay_chart_view_t));
+    view->relay = relay;
+    view->channel = relay->telemetry_channel;
+    view->tier = RELAY_TELEMETRY_TIER_30S;
+
+    view->screen = lv_obj_create(NULL);
+    if (view->screen == NULL) {
+        ESP_LOGE(TAG, "Failed to create chart screen");
+        free(view);
+        return NULL;
+    }
+    lv_obj_remove_flag(view->screen, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Back button and title on the top row
+    lv_obj_t *back = lv_button_create(view->screen);
+    lv_obj_align(back, LV_ALIGN_TOP_LEFT, 5, 5);
+    lv_obj_t *back_label = lv_label_create(back);
+    lv_label_set_text_static(back_label, LV_SYMBOL_LEFT);
+    lv_obj_center(back_label);
+    lv_obj_add_event_cb(back, chart_view_back_cb, LV_EVENT_CLICKED, view);
+
+    view->title = lv_label_create(view->screen);
+    lv_obj_align_to(view->title, back, LV_ALIGN_OUT_RIGHT_MID, 10, 0);
+    ui_binding_init(&view->title_binding, view->title);
+
+    // Fixed point count for every tier, so the series array is allocated once
+    view->chart = lv_chart_create(view->screen);
+    relay_theme_apply_chart(view->chart);
+    lv_obj_set_size(view->chart, lv_pct(94), lv_pct(60));
+    lv_obj_align(view->chart, LV_ALIGN_CENTER, 0, 0);
+    lv_chart_set_type(view->chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_point_count(view->chart, RELAY_TELEMETRY_HISTORY_POINTS);
+    lv_chart_set_update_mode(view->chart, LV_CHART_UPDATE_MODE_CIRCULAR);
+    lv_chart_set_div_line_count(view->chart, 5, 0);
+    view->series = lv_chart_add_series(view->chart, CHART_SERIES_COLOR, LV_CHART_AXIS_PRIMARY_Y);
+
+    view->zoom = lv_buttonmatrix_create(view->screen);
+    lv_buttonmatrix_set_map(view->zoom, zoom_map);
+    lv_buttonmatrix_set_ctrl_map(view->zoom, zoom_ctrl_map);
+    lv_buttonmatrix_set_one_checked(view->zoom, true);
+    lv_buttonmatrix_set_button_ctrl(view->zoom, view->tier, LV_BUTTONMATRIX_CTRL_CHECKED);
+    lv_obj_set_size(view->zoom, lv_pct(94), 40);
+    lv_obj_align(view->zoom, LV_ALIGN_BOTTOM_MID, 0, -5);
+    lv_obj_add_event_cb(view->zoom, chart_view_zoom_cb, LV_EVENT_VALUE_CHANGED, view);
+
+    view->poll_timer = lv_timer_create(chart_view_poll_cb, relay_telemetry_get_point_period_ms(view->tier), view);
+    if (view->series == NULL || view->poll_timer == NULL) {
+        ESP_LOGE(TAG, "Failed to create chart");
+        if (view->poll_timer != NULL) {
+            lv_timer_delete(view->poll_timer);
+        }
+        lv_obj_delete(view->screen);
+        free(view);
+        return NULL;
+    }
+    lv_timer_pause(view->poll_timer);
+
+    ESP_LOGI(TAG, "%s: chart view created, %d points (%u bytes of samples)", relay->name,
+             RELAY_TELEMETRY_HISTORY_POINTS, (unsigned)(RELAY_TELEMETRY_HISTORY_POINTS * sizeof(int32_t)));
+    *instance = view;
+    return view->screen;
+}
+
+/**
+ * @brief Screen manager hook - free a hidden view
+ */
+static void chart_view_destroy(void *instance)
+{
+    relay_chart_view_t *view = (relay_chart_view_t *)instance;
+
+    lv_timer_delete(view->poll_timer);
+    // Never the active screen, so none of its widgets is handling an event
+    lv_obj_delete(view->screen);
+    free(view);
+}
+
+/**
+ * @brief Screen manager hook - catch up on the history missed while hidden and start polling
+ */
+static void chart_view_show(void *instance)
+{
+    relay_chart_view_t *view = (relay_chart_view_t *)instance;
+
+    chart_view_load_tier(view);
+    chart_view_update_title(view);
+    lv_timer_resume(view->poll_timer);
+}
+
+/**
+ * @brief Screen manager hook - stop polling while another screen is shown
+ */
+static void chart_view_hide(void *instance)
+{
+    relay_chart_view_t *view = (relay_chart_view_t *)instance;
+
+    lv_timer_pause(view->poll_timer);
+}
+
+static const screen_manager_class_t chart_view_class = {
+    .name = "chart",
+    .create = chart_view_create,
+    .destroy = chart_view_destroy,
+    .show = chart_view_show,
+    .hide = chart_view_hide,
+};
+
+/**
+ * @brief Show the detail screen of a relay, creating it on first use
+ */
+esp_err_t relay_chart_view_open(relay_control_ui_t *relay)
+{
+    if (relay == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (relay->telemetry_channel < 0) {
+        ESP_LOGW(TAG, "%s has no current sensor to chart", relay->name);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return screen_manager_open(&chart_view_class, relay);
+}
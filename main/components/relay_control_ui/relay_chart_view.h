@@ -0,0 +1,58 @@
+/*
+ * Relay Chart View Component Header
+ *
+ * Full-screen detail view for one relay with a live chart of its current,
+ * fed from the relay telemetry history. Opened by tapping the current
+ * display of a relay tile; the back button returns to the dashboard. The
+ * screen is built on first use and kept alive by the screen manager until it
+ * is evicted from the LRU of live screens.
+ */
+
+#ifndef RELAY_CHART_VIEW_H
+#define RELAY_CHART_VIEW_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+#include "relay_control_ui.h"
+#include "relay_telemetry.h"
+#include "ui_binding.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RELAY_CHART_MIN_RANGE_CA     100  // Y axis covers at least 0-1.00 A
+
+/**
+ * @brief Relay chart view object structure
+ */
+typedef struct {
+    lv_obj_t *screen;           // Detail screen
+    lv_obj_t *title;            // Relay name and latest reading
+    lv_obj_t *chart;            // Current chart, RELAY_TELEMETRY_HISTORY_POINTS points
+    lv_obj_t *zoom;             // Zoom tier selector
+    lv_chart_series_t *series;
+    lv_timer_t *poll_timer;     // Appends new history points, paused while the screen is hidden
+    ui_binding_t title_binding; // Cached title text
+    relay_control_ui_t *relay;
+    int channel;                // Telemetry channel of the relay
+    relay_telemetry_tier_t tier;
+    uint32_t next_seq;          // Next history point to append
+    int32_t range_ca;           // Current Y axis maximum
+} relay_chart_view_t;
+
+/**
+ * @brief Show the detail screen of a relay, creating it on first use (LVGL context only)
+ *
+ * @param relay Relay whose current is charted
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED without a current sensor,
+ *         ESP_ERR_NO_MEM if the screen could not be built
+ */
+esp_err_t relay_chart_view_open(relay_control_ui_t *relay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RELAY_CHART_VIEW_H
@@ -8,6 +8,10 @@
 
 #include "relay_control_ui.h"
 #include "relay_hardware.h"
+#include "relay_theme.h"
+#include "relay_telemetry.h"
+#include "relay_chart_view.h"
+#include "countdown_anim.h"
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
@@ -19,6 +23,37 @@
 
 static const char *DEFAULT_TAG = "relay_ui";
 
+// Bumped whenever any relay switches or its countdown starts or stops (not on countdown ticks)
+static uint32_t state_version = 0;
+static void (*change_listener)(void) = NULL;
+
+/**
+ * @brief Record a relay state change for pollers of relay_control_ui_get_state_version()
+ */
+static void bump_state_version(void)
+{
+    __atomic_fetch_add(&state_version, 1, __ATOMIC_RELAXED);
+    if (change_listener != NULL) {
+        change_listener();
+    }
+}
+
+// Provided by the LVGL port in spi_lcd_touch_example_main.c
+extern void example_lvgl_port_request_timer(lv_timer_t *timer);
+
+/**
+ * @brief Wake the UI update timer after setting update_needed/state_update_needed
+ * Safe to call from any context; repeated requests before the timer runs are dropped.
+ */
+static void request_ui_update(relay_control_ui_t *ui)
+{
+    if (ui->update_requested || ui->lvgl_timer == NULL) {
+        return;
+    }
+    ui->update_requested = true;
+    example_lvgl_port_request_timer(ui->lvgl_timer);
+}
+
 /**
  * @brief Control the relay hardware based on state
  * 
@@ -37,18 +72,12 @@ static void control_relay_hardware(relay_control_ui_t *ui, bool state)
     }
     
     // Control hardware through hardware abstraction layer
+    if (relay_hardware_get_state(ui->hardware) != state) {
+        metrics_counter_inc(&ui->switches);
+    }
     relay_hardware_set_state(ui->hardware, state);
 }
 
-/**
- * @brief Animation callback for progress bar value update
- */
-static void progress_bar_anim_cb(void *var, int32_t value)
-{
-    lv_obj_t *bar = (lv_obj_t *)var;
-    lv_bar_set_value(bar, value, LV_ANIM_OFF);
-}
-
 /**
  * @brief Format time as MM:SS string
  * 
@@ -70,6 +99,9 @@ static void format_time_string(uint32_t seconds, char *buffer)
 /**
  * @brief Update the current consumption display
  * 
+ * Goes through the widget bindings, so LVGL is only touched (and the area
+ * only redrawn) when the displayed value or colour really changed.
+ * 
  * @param ui Pointer to the relay control UI object
  */
 static void update_current_display(relay_control_ui_t *ui)
@@ -78,45 +110,34 @@ static void update_current_display(relay_control_ui_t *ui)
         return;
     }
     
-    // Read current from hardware if available
-    float current = 0.0f;
-    if (ui->hardware != NULL) {
-        current = relay_hardware_read_current(ui->hardware);
-    }
+    // Latest reading of the telemetry task, in hundredths of an Ampere (0 without hardware)
+    int32_t current_ca = relay_telemetry_get_current_ca(ui->telemetry_channel);
     
-    // Format current string with arrow pointing to button
-    char current_str[20];
+    // Format current string with arrow pointing to button (fixed-point, no float printf)
+    char value_str[12];
+    char current_str[UI_BINDING_TEXT_LEN];
+    ui_binding_format_centi(value_str, sizeof(value_str), current_ca);
     if (ui->is_left_side) {
         // Left buttons: arrow points left (←)
-        snprintf(current_str, sizeof(current_str), "← %.2f A", current);
+        strcpy(current_str, "← ");
+        strcat(current_str, value_str);
+        strcat(current_str, " A");
     } else {
         // Right buttons: arrow points right (→)
-        snprintf(current_str, sizeof(current_str), "%.2f A →", current);
+        strcpy(current_str, value_str);
+        strcat(current_str, " A →");
     }
-    lv_label_set_text(ui->current_label, current_str);
+    ui_binding_set_text(&ui->current_binding, current_str);
     
     // Always show current container (even when relay is OFF, it will show 0.00 A)
-    if (ui->current_container != NULL) {
+    if (lv_obj_has_flag(ui->current_container, LV_OBJ_FLAG_HIDDEN)) {
         lv_obj_clear_flag(ui->current_container, LV_OBJ_FLAG_HIDDEN);
     }
     
-    // Change color based on current value for better visibility
-    lv_color_t text_color, bg_color;
-    if (current > 0.1f) {
-        // Current flowing - use bright green text with darker green background
-        text_color = lv_color_hex(0x00FF00);
-        bg_color = lv_color_hex(0x004400);
-    } else {
-        // No current or very low - use gray text with dark background
-        text_color = lv_color_hex(0x808080);
-        bg_color = lv_color_hex(0x202020);
-    }
-    
-    lv_obj_set_style_text_color(ui->current_label, text_color, LV_PART_MAIN);
-    if (ui->current_container != NULL) {
-        lv_obj_set_style_bg_color(ui->current_container, bg_color, LV_PART_MAIN);
-        lv_obj_set_style_border_color(ui->current_container, text_color, LV_PART_MAIN);
-    }
+    // Highlight the bubble while current is flowing (green), gray when idle - colours live in the theme
+    bool active = current_ca > CURRENT_ACTIVE_THRESHOLD_CA;
+    ui_binding_set_state(&ui->current_binding, RELAY_THEME_STATE_ACTIVE, active);
+    ui_binding_set_state(&ui->current_container_binding, RELAY_THEME_STATE_ACTIVE, active);
 }
 
 /**
@@ -133,52 +154,24 @@ static void update_timer_display(relay_control_ui_t *ui)
     if (ui->state && ui->time_remaining > 0) {
         char time_str[10];
         format_time_string(ui->time_remaining, time_str);
-        lv_label_set_text(ui->timer_label, time_str);
+        ui_binding_set_text(&ui->timer_binding, time_str);
         lv_obj_clear_flag(ui->timer_label, LV_OBJ_FLAG_HIDDEN);
         
-        // Update progress bar animation
+        // The shared countdown driver moves the bar and its colour from the deadline
+        // (no-op while it already runs towards this deadline)
         if (ui->progress_bar != NULL) {
-            // Calculate progress percentage (0-100)
-            uint32_t elapsed = RELAY_TIMER_DURATION_SECONDS - ui->time_remaining;
-            int32_t progress = (int32_t)((elapsed * 100) / RELAY_TIMER_DURATION_SECONDS);
-            // Ensure progress is between 0 and 100
-            if (progress < 0) progress = 0;
-            if (progress > 100) progress = 100;
-            
-            // Change color based on remaining time: green -> yellow -> red
-            uint32_t remaining_percent = 100 - progress;
-            lv_color_t bar_color;
-            if (remaining_percent > 50) {
-                // More than 50% remaining - green
-                bar_color = lv_color_hex(0x00FF00);
-            } else if (remaining_percent > 20) {
-                // 20-50% remaining - yellow/orange
-                bar_color = lv_color_hex(0xFFFF00);
-            } else {
-                // Less than 20% remaining - red
-                bar_color = lv_color_hex(0xFF0000);
-            }
-            lv_obj_set_style_bg_color(ui->progress_bar, bar_color, LV_PART_INDICATOR);
-            
-            // Animate the progress bar value change (smooth transition)
-            lv_anim_t a;
-            lv_anim_init(&a);
-            lv_anim_set_var(&a, ui->progress_bar);
-            lv_anim_set_values(&a, lv_bar_get_value(ui->progress_bar), progress);
-            lv_anim_set_time(&a, 1000);  // 1 second smooth animation
-            lv_anim_set_exec_cb(&a, progress_bar_anim_cb);
-            lv_anim_start(&a);
-            
+            countdown_anim_start(ui->progress_bar, &ui->progress_bar_binding, ui->countdown_start_us, ui->countdown_end_us);
             lv_obj_clear_flag(ui->progress_bar, LV_OBJ_FLAG_HIDDEN);
         }
         
         ESP_LOGI(ui->tag, "Timer display updated: %s", time_str);
     } else {
-        lv_label_set_text_static(ui->timer_label, "");
+        ui_binding_set_text(&ui->timer_binding, "");
         lv_obj_add_flag(ui->timer_label, LV_OBJ_FLAG_HIDDEN);
         
         // Hide progress bar
         if (ui->progress_bar != NULL) {
+            countdown_anim_stop(ui->progress_bar);
             lv_obj_add_flag(ui->progress_bar, LV_OBJ_FLAG_HIDDEN);
             lv_bar_set_value(ui->progress_bar, 0, LV_ANIM_OFF);
         }
@@ -200,17 +193,16 @@ static void update_button_appearance(relay_control_ui_t *ui)
     char label_text[32];
     const char *display_name = (ui->name != NULL && strlen(ui->name) > 0) ? ui->name : "RELAY";
 
+    // ON = green, OFF = red (theme colours selected by the checked state)
+    ui_binding_set_state(&ui->button_binding, RELAY_THEME_STATE_ON, ui->state);
+
     if (ui->state) {
-        // ON state - Green color
-        lv_obj_set_style_bg_color(ui->button, BUTTON_ON_COLOR, LV_PART_MAIN);
         snprintf(label_text, sizeof(label_text), "%s ON", display_name);
-        lv_label_set_text(ui->label, label_text);
+        ui_binding_set_text(&ui->label_binding, label_text);
         ESP_LOGI(ui->tag, "Relay UI: ON (Green)");
     } else {
-        // OFF state - Red color
-        lv_obj_set_style_bg_color(ui->button, BUTTON_OFF_COLOR, LV_PART_MAIN);
         snprintf(label_text, sizeof(label_text), "%s OFF", display_name);
-        lv_label_set_text(ui->label, label_text);
+        ui_binding_set_text(&ui->label_binding, label_text);
         ESP_LOGI(ui->tag, "Relay UI: OFF (Red)");
     }
     
@@ -238,13 +230,19 @@ static void timer_callback(void *arg)
             ESP_LOGI(ui->tag, "Timer expired - will turn relay OFF");
             ui->state = false;
             ui->update_needed = true;
+            bump_state_version();
             // Control hardware immediately (safe to call from timer context)
             control_relay_hardware(ui, false);
             // Stop the timer
             if (ui->timer != NULL) {
                 esp_timer_stop(ui->timer);
             }
+            // Only schedules work (the master button restyles on the LVGL task)
+            if (ui->state_change_cb != NULL) {
+                ui->state_change_cb(ui, ui->state);
+            }
         }
+        request_ui_update(ui);
     }
 }
 
@@ -258,20 +256,30 @@ static void lvgl_timer_cb(lv_timer_t *timer)
     if (ui == NULL) {
         return;
     }
+
+    // Clear before reading the flags so a request that races with this pass wakes us again
+    ui->update_requested = false;
+
+    // Display is dark - drop the redraw and catch up in relay_control_ui_set_suspended()
+    if (ui->suspended) {
+        if (ui->update_needed || ui->state_update_needed) {
+            ui->update_needed = false;
+            ui->state_update_needed = false;
+            ui->resync_needed = true;
+        }
+        ui->current_update_needed = false;  // Read again on resume
+        lv_timer_pause(timer);
+        return;
+    }
     
     // Check if update is needed (set from esp_timer callback or start_timer/stop_timer)
     if (ui->update_needed) {
         ui->update_needed = false;  // Clear flag
         
         // Now safe to call LVGL functions since we're in LVGL timer context
+        // (a new countdown restarts the bar from empty and green in the countdown driver)
         update_timer_display(ui);
         
-        // If timer just started (time_remaining == RELAY_TIMER_DURATION_SECONDS), reset progress bar
-        if (ui->time_remaining == RELAY_TIMER_DURATION_SECONDS && ui->progress_bar != NULL) {
-            lv_bar_set_value(ui->progress_bar, 0, LV_ANIM_OFF);
-            lv_obj_set_style_bg_color(ui->progress_bar, lv_color_hex(0x00FF00), LV_PART_INDICATOR);  // Start green
-        }
-        
         // If timer expired, also update button appearance
         if (ui->time_remaining == 0 && !ui->state) {
             update_button_appearance(ui);
@@ -283,24 +291,49 @@ static void lvgl_timer_cb(lv_timer_t *timer)
         ui->state_update_needed = false;  // Clear flag
         
         // Now safe to call LVGL functions since we're in LVGL timer context
+        // (this also shows the latest reading, so a pending current update is covered)
+        ui->current_update_needed = false;
         update_button_appearance(ui);
         update_current_display(ui);
     }
+
+    // New reading from the telemetry task
+    if (ui->current_update_needed) {
+        ui->current_update_needed = false;
+        update_current_display(ui);
+    }
+
+    // Nothing left to do - sleep until request_ui_update() resumes us
+    if (!ui->update_needed && !ui->state_update_needed && !ui->current_update_needed) {
+        lv_timer_pause(timer);
+    }
 }
 
 /**
- * @brief LVGL timer callback for current reading updates
+ * @brief Telemetry listener - the reading of this relay changed (telemetry task)
  */
-static void current_timer_cb(lv_timer_t *timer)
+static void current_changed_cb(void *ctx)
 {
-    relay_control_ui_t *ui = (relay_control_ui_t *)lv_timer_get_user_data(timer);
+    relay_control_ui_t *ui = (relay_control_ui_t *)ctx;
+    // Dark display: relay_control_ui_set_suspended() reads the value on resume
+    if (ui->suspended) {
+        return;
+    }
+    ui->current_update_needed = true;
+    request_ui_update(ui);
+}
+
+/**
+ * @brief Current display click callback - opens the current chart of this relay
+ */
+static void current_display_cb(lv_event_t *e)
+{
+    relay_control_ui_t *ui = (relay_control_ui_t *)lv_event_get_user_data(e);
     
     if (ui == NULL) {
         return;
     }
-    
-    // Update current display (safe to call from LVGL timer context)
-    update_current_display(ui);
+    relay_chart_view_open(ui);
 }
 
 /**
@@ -321,12 +354,16 @@ static void start_timer(relay_control_ui_t *ui)
         ui->timer = NULL;
     }
 
-    // Initialize time remaining
+    // Initialize time remaining and the deadline the progress bar is drawn from
     ui->time_remaining = RELAY_TIMER_DURATION_SECONDS;
+    ui->countdown_start_us = esp_timer_get_time();
+    ui->countdown_end_us = ui->countdown_start_us + (int64_t)RELAY_TIMER_DURATION_SECONDS * 1000000;
+    bump_state_version();
 
     // Signal that UI update is needed (will be handled by LVGL timer callback)
     // DO NOT call LVGL functions directly here - this may be called from HTTP handler
     ui->update_needed = true;
+    request_ui_update(ui);
 
     // Create timer
     const esp_timer_create_args_t timer_args = {
@@ -372,9 +409,11 @@ static void stop_timer(relay_control_ui_t *ui)
     }
 
     ui->time_remaining = 0;
+    bump_state_version();
     // Signal that UI update is needed (will be handled by LVGL timer callback)
     // DO NOT call LVGL functions directly here - this may be called from HTTP handler
     ui->update_needed = true;
+    request_ui_update(ui);
 }
 
 /**
@@ -396,6 +435,7 @@ static void relay_button_cb(lv_event_t *e)
         // Only turn ON if currently OFF
         if (!ui->state) {
             ui->state = true;
+            bump_state_version();
             
             // Control hardware based on new state
             control_relay_hardware(ui, ui->state);
@@ -482,6 +522,7 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
     ui->name = (name != NULL) ? name : "RELAY";  // Default name if not provided
     ui->state = false;  // Start with relay OFF
     ui->hardware = hardware;  // Store hardware object pointer (can be NULL)
+    ui->telemetry_channel = relay_telemetry_register(hardware);  // -1 without hardware
     
     // Sync UI state with hardware state if hardware is available
     if (ui->hardware != NULL) {
@@ -496,8 +537,8 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
         return NULL;
     }
     
-    // Set button size
-    lv_obj_set_size(ui->button, BUTTON_WIDTH_PX, BUTTON_HEIGHT_PX);
+    // Shared theme styles: size, shape and ON/OFF colours
+    relay_theme_apply_button(ui->button, BUTTON_WIDTH_PX, BUTTON_HEIGHT_PX);
     
     // Position the button according to parameters
     lv_obj_align(ui->button, align, x_offset, y_offset);
@@ -526,8 +567,7 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
     lv_label_set_text_static(ui->timer_label, "");
     
     // Style the timer label - make it prominent
-    lv_obj_set_style_text_align(ui->timer_label, TIMER_LABEL_TEXT_ALIGN, LV_PART_MAIN);
-    lv_obj_set_style_text_color(ui->timer_label, TIMER_LABEL_TEXT_COLOR, LV_PART_MAIN);
+    relay_theme_apply_timer_label(ui->timer_label);
     // Make sure it's not hidden initially so it can be shown when needed
     // Initially hide timer label (will show when relay is ON and timer starts)
     lv_obj_add_flag(ui->timer_label, LV_OBJ_FLAG_HIDDEN);
@@ -542,15 +582,15 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
         return NULL;
     }
     
+    // Style the progress bar (size and green/yellow/red indicator come from the theme)
+    relay_theme_apply_progress_bar(ui->progress_bar);
+    
     // Position progress bar above button, between button and timer label
     lv_obj_align_to(ui->progress_bar, ui->button, LV_ALIGN_OUT_BOTTOM_MID, PROGRESS_BAR_X_OFFSET_PX, PROGRESS_BAR_Y_OFFSET_PX);
-    lv_obj_set_size(ui->progress_bar, PROGRESS_BAR_WIDTH_PX, PROGRESS_BAR_HEIGHT_PX);
     
-    // Style the progress bar
+    // One step per pixel, so the countdown driver redraws only when the bar visibly moves
+    lv_bar_set_range(ui->progress_bar, 0, PROGRESS_BAR_WIDTH_PX);
     lv_bar_set_value(ui->progress_bar, 0, LV_ANIM_OFF);
-    lv_bar_set_range(ui->progress_bar, 0, 100);
-    // Set progress bar color based on remaining time (green -> yellow -> red)
-    lv_obj_set_style_bg_color(ui->progress_bar, lv_color_hex(0x00FF00), LV_PART_INDICATOR);  // Green
     
     // Initially hide progress bar
     lv_obj_add_flag(ui->progress_bar, LV_OBJ_FLAG_HIDDEN);
@@ -570,14 +610,8 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
         return NULL;
     }
     
-    // Style the container to look like an arrow/bubble
-    lv_obj_set_size(ui->current_container, 80, 30);
-    lv_obj_set_style_bg_opa(ui->current_container, LV_OPA_80, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(ui->current_container, lv_color_hex(0x202020), LV_PART_MAIN);
-    lv_obj_set_style_border_width(ui->current_container, 2, LV_PART_MAIN);
-    lv_obj_set_style_border_color(ui->current_container, lv_color_hex(0x808080), LV_PART_MAIN);
-    lv_obj_set_style_radius(ui->current_container, 5, LV_PART_MAIN);
-    lv_obj_set_style_pad_all(ui->current_container, 4, LV_PART_MAIN);
+    // Style the container to look like an arrow/bubble (label style applied below)
+    relay_theme_apply_current_display(ui->current_container, NULL);
     
     // Position container based on button alignment
     if (ui->is_left_side) {
@@ -606,9 +640,8 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
     lv_obj_center(ui->current_label);
     lv_label_set_text_static(ui->current_label, "0.00 A");
     
-    // Style the current label
-    lv_obj_set_style_text_align(ui->current_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-    lv_obj_set_style_text_color(ui->current_label, CURRENT_LABEL_TEXT_COLOR, LV_PART_MAIN);
+    // Style the current label (idle gray / active green)
+    relay_theme_apply_current_display(NULL, ui->current_label);
     
     // Always show current container (will display 0.00 A when relay is OFF)
     lv_obj_clear_flag(ui->current_container, LV_OBJ_FLAG_HIDDEN);
@@ -617,13 +650,14 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
     ui->timer = NULL;
     ui->time_remaining = 0;
     ui->update_needed = false;
+    ui->update_requested = false;
     ui->long_press_active = false;  // Initialize long press flag
     ui->state_change_cb = NULL;
     ui->state_change_cb_arg = NULL;
     
     // Create LVGL timer for safe UI updates (runs in LVGL context)
-    // This timer will periodically check update_needed flag and update UI safely
-    ui->lvgl_timer = lv_timer_create(lvgl_timer_cb, 100, ui);  // Check every 100ms
+    // It stays paused until request_ui_update() resumes it, then applies the pending flags
+    ui->lvgl_timer = lv_timer_create(lvgl_timer_cb, 100, ui);
     if (ui->lvgl_timer == NULL) {
         ESP_LOGE(ui->tag, "Failed to create LVGL timer");
         if (ui->current_label != NULL) {
@@ -638,30 +672,22 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
         return NULL;
     }
     lv_timer_set_repeat_count(ui->lvgl_timer, -1);  // Repeat indefinitely
+    lv_timer_pause(ui->lvgl_timer);
     
-    // Create LVGL timer for current reading updates
-    ui->current_timer = lv_timer_create(current_timer_cb, CURRENT_UPDATE_INTERVAL_MS, ui);
-    if (ui->current_timer == NULL) {
-        ESP_LOGE(ui->tag, "Failed to create current timer");
-        lv_timer_del(ui->lvgl_timer);
-        if (ui->current_container != NULL) {
-            lv_obj_del(ui->current_container);
-        }
-        if (ui->progress_bar != NULL) {
-            lv_obj_del(ui->progress_bar);
-        }
-        lv_obj_del(ui->timer_label);
-        lv_obj_del(ui->button);
-        free(ui);
-        return NULL;
-    }
-    lv_timer_set_repeat_count(ui->current_timer, -1);  // Repeat indefinitely
+    // Bind widgets so periodic refreshes only touch LVGL on real changes
+    ui_binding_init(&ui->button_binding, ui->button);
+    ui_binding_init(&ui->label_binding, ui->label);
+    ui_binding_init(&ui->timer_binding, ui->timer_label);
+    ui_binding_init(&ui->current_binding, ui->current_label);
+    ui_binding_init(&ui->current_container_binding, ui->current_container);
+    ui_binding_init(&ui->progress_bar_binding, ui->progress_bar);
     
     // Set initial appearance
     update_button_appearance(ui);
     
-    // Initialize current display
+    // Initialize current display; after this only a changed reading redraws it
     update_current_display(ui);
+    relay_telemetry_set_listener(ui->telemetry_channel, current_changed_cb, ui);
     
     // Add click event callback with user data pointing to our object
     lv_obj_add_event_cb(ui->button, relay_button_cb, LV_EVENT_CLICKED, ui);
@@ -669,11 +695,9 @@ relay_control_ui_t *relay_control_ui_create(lv_obj_t *parent, const char *tag, c
     // Add long press event callback for turning on without timer
     lv_obj_add_event_cb(ui->button, relay_button_cb, LV_EVENT_LONG_PRESSED, ui);
     
-    // Make button style more prominent
-    lv_obj_set_style_radius(ui->button, 10, LV_PART_MAIN);
-    lv_obj_set_style_shadow_width(ui->button, 10, LV_PART_MAIN);
-    lv_obj_set_style_shadow_color(ui->button, lv_color_hex(0x808080), LV_PART_MAIN);
-    lv_obj_set_style_shadow_opa(ui->button, LV_OPA_50, LV_PART_MAIN);
+    // Tapping the current display opens the current chart
+    lv_obj_add_flag(ui->current_container, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(ui->current_container, current_display_cb, LV_EVENT_CLICKED, ui);
     
     ESP_LOGI(ui->tag, "Relay control UI object created");
     
@@ -693,17 +717,13 @@ void relay_control_ui_delete(relay_control_ui_t *ui)
 
     // Stop and delete timers if they exist
     stop_timer(ui);
+    relay_telemetry_set_listener(ui->telemetry_channel, NULL, NULL);
     
     if (ui->lvgl_timer != NULL) {
         lv_timer_del(ui->lvgl_timer);
         ui->lvgl_timer = NULL;
     }
     
-    if (ui->current_timer != NULL) {
-        lv_timer_del(ui->current_timer);
-        ui->current_timer = NULL;
-    }
-
     // Delete LVGL objects if they exist
     // Note: deleting current_container will also delete current_label as it's a child
     if (ui->current_container != NULL) {
@@ -713,6 +733,7 @@ void relay_control_ui_delete(relay_control_ui_t *ui)
     }
     
     if (ui->progress_bar != NULL) {
+        countdown_anim_stop(ui->progress_bar);
         lv_obj_del(ui->progress_bar);
         ui->progress_bar = NULL;
     }
@@ -746,6 +767,49 @@ bool relay_control_ui_get_state(const relay_control_ui_t *ui)
     return ui->state;
 }
 
+/**
+ * @brief Seconds left on the countdown
+ * 
+ * @param ui Pointer to the relay control UI object
+ * @return uint32_t Seconds until the relay turns off, 0 when no countdown runs
+ */
+uint32_t relay_control_ui_get_time_remaining(const relay_control_ui_t *ui)
+{
+    if (ui == NULL || !ui->state) {
+        return 0;
+    }
+    return ui->time_remaining;
+}
+
+/**
+ * @brief Number of times the relay hardware switched since boot
+ */
+uint32_t relay_control_ui_get_switch_count(const relay_control_ui_t *ui)
+{
+    if (ui == NULL) {
+        return 0;
+    }
+    return metrics_counter_read(&ui->switches);
+}
+
+/**
+ * @brief Version of the relay states
+ * 
+ * @return uint32_t Counter bumped on every switch and countdown start/stop
+ */
+uint32_t relay_control_ui_get_state_version(void)
+{
+    return __atomic_load_n(&state_version, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Set the function called on every state version bump
+ */
+void relay_control_ui_set_change_listener(void (*listener)(void))
+{
+    change_listener = listener;
+}
+
 /**
  * @brief Set relay state programmatically
  * 
@@ -788,14 +852,41 @@ void relay_control_ui_set_state(relay_control_ui_t *ui, bool state)
     // Signal that UI update is needed (will be handled by LVGL timer callback)
     // DO NOT call LVGL functions directly here - this may be called from HTTP handler (CPU 1)
     ui->state_update_needed = true;
+    request_ui_update(ui);
     
     // Notify state change callback (for master button updates)
-    // Note: This callback should also not call LVGL functions directly
+    // Note: This callback must not call LVGL functions either (the master button only schedules its restyle)
     if (ui->state_change_cb != NULL) {
         ui->state_change_cb(ui, ui->state);
     }
 }
 
+/**
+ * @brief Suspend or resume on-screen updates (e.g. while the display is dark)
+ * 
+ * @param ui Pointer to the relay control UI object
+ * @param suspended true to suspend, false to resume
+ */
+void relay_control_ui_set_suspended(relay_control_ui_t *ui, bool suspended)
+{
+    if (ui == NULL || ui->suspended == suspended) {
+        return;
+    }
+    ui->suspended = suspended;
+
+    if (suspended) {
+        return;
+    }
+
+    // Readings that changed while dark were dropped, show the latest one
+    update_current_display(ui);
+    // Countdown kept running while dark, redraw it (and the button if the timer expired)
+    if (ui->resync_needed || ui->state) {
+        ui->resync_needed = false;
+        update_button_appearance(ui);
+    }
+}
+
 /**
  * @brief Toggle relay state programmatically
  * 
@@ -13,6 +13,8 @@
 #include "lvgl.h"
 #include "esp_timer.h"
 #include "relay_hardware.h"
+#include "ui_binding.h"
+#include "metrics.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,8 +24,10 @@ extern "C" {
 // #define RELAY_TIMER_DURATION_SECONDS (10 * 60)  // 10 seconds in seconds
 #define BUTTON_WIDTH_PX 100
 #define BUTTON_HEIGHT_PX 60
-#define BUTTON_OFF_COLOR lv_color_hex(0xC00000)
-#define BUTTON_ON_COLOR lv_color_hex(0x00C000)
+#define BUTTON_OFF_COLOR_HEX 0xC00000
+#define BUTTON_ON_COLOR_HEX 0x00C000
+#define BUTTON_OFF_COLOR lv_color_hex(BUTTON_OFF_COLOR_HEX)
+#define BUTTON_ON_COLOR lv_color_hex(BUTTON_ON_COLOR_HEX)
 #define TIMER_LABEL_HEIGHT_PX 20
 #define TIMER_LABEL_WIDTH_PX 100
 #define TIMER_LABEL_X_OFFSET_PX 0
@@ -38,9 +42,8 @@ extern "C" {
 #define CURRENT_LABEL_WIDTH_PX 100
 #define CURRENT_LABEL_X_OFFSET_PX 0
 #define CURRENT_LABEL_Y_OFFSET_PX 50
-#define CURRENT_LABEL_TEXT_COLOR lv_color_hex(0xFFFF00)
 #define CURRENT_LABEL_TEXT_ALIGN LV_TEXT_ALIGN_CENTER
-#define CURRENT_UPDATE_INTERVAL_MS 500  // Update current reading every 500ms
+#define CURRENT_ACTIVE_THRESHOLD_CA 10  // Above 0.10 A the current display is highlighted (in 1/100 A)
 
 
 /**
@@ -51,6 +54,9 @@ typedef struct relay_control_ui_s relay_control_ui_t;
 
 /**
  * @brief Callback function type for state change notifications
+ * 
+ * Called on the task that changed the state, which may be an HTTP, WebSocket
+ * or esp_timer task: it must not call LVGL, only schedule work for the LVGL task.
  */
 typedef void (*relay_state_change_cb_t)(relay_control_ui_t *ui, bool new_state);
 
@@ -65,19 +71,32 @@ struct relay_control_ui_s {
     lv_obj_t *current_container; // Container for current display with arrow
     lv_obj_t *current_label;   // The current consumption label
     lv_timer_t *lvgl_timer;    // LVGL timer for safe UI updates
-    lv_timer_t *current_timer; // LVGL timer for current reading updates
     bool state;                 // Current relay state (true = ON, false = OFF)
     bool is_left_side;          // Whether button is on left side (for arrow direction)
     const char *tag;            // Log tag for this instance
     const char *name;           // Display name for this relay (e.g., "Relay 1")
     esp_timer_handle_t timer;   // Timer handle for countdown
     uint32_t time_remaining;   // Time remaining in seconds
+    int64_t countdown_start_us; // esp_timer time the countdown started
+    int64_t countdown_end_us;   // esp_timer time the countdown expires
     volatile bool update_needed; // Flag to signal UI update needed (set from timer callback)
     volatile bool state_update_needed; // Flag to signal state change UI update needed (set from HTTP handler or other non-LVGL contexts)
+    volatile bool current_update_needed; // Flag to signal a new current reading (set from the telemetry task)
+    volatile bool update_requested; // LVGL task already asked to run lvgl_timer (avoids flooding its request queue)
+    bool suspended;             // Display is dark: skip countdown/current redraws (LVGL context only)
+    bool resync_needed;         // Updates were dropped while suspended, refresh everything on resume
     bool long_press_active;    // Flag to track if long press just happened (prevents CLICKED event from toggling)
     relay_state_change_cb_t state_change_cb; // Callback when state changes
     void *state_change_cb_arg;  // User data for state change callback
     relay_hardware_t *hardware;  // Pointer to hardware control object (NULL if no hardware)
+    int telemetry_channel;       // Current sampling channel (-1 if no hardware)
+    metrics_counter_t switches;  // Hardware ON/OFF transitions since boot
+    ui_binding_t button_binding;     // Cached button ON/OFF state
+    ui_binding_t label_binding;      // Cached button label text
+    ui_binding_t timer_binding;      // Cached countdown text
+    ui_binding_t current_binding;    // Cached current text and idle/active state
+    ui_binding_t current_container_binding; // Cached current bubble idle/active state
+    ui_binding_t progress_bar_binding; // Cached progress bar colour state
 };
 
 /**
@@ -109,6 +128,42 @@ void relay_control_ui_delete(relay_control_ui_t *ui);
  */
 bool relay_control_ui_get_state(const relay_control_ui_t *ui);
 
+/**
+ * @brief Seconds left on the countdown
+ * 
+ * @param ui Pointer to the relay control UI object
+ * @return uint32_t Seconds until the relay turns off, 0 when no countdown runs
+ */
+uint32_t relay_control_ui_get_time_remaining(const relay_control_ui_t *ui);
+
+/**
+ * @brief Number of times the relay hardware switched since boot (safe from any task)
+ * 
+ * @param ui Pointer to the relay control UI object
+ * @return uint32_t ON/OFF transitions, wrapping at 2^32
+ */
+uint32_t relay_control_ui_get_switch_count(const relay_control_ui_t *ui);
+
+/**
+ * @brief Version of the relay states (safe from any task)
+ * 
+ * Incremented whenever any relay switches or its countdown starts or stops, but
+ * not on countdown ticks, so a poller can tell whether anything changed.
+ * 
+ * @return uint32_t Current version
+ */
+uint32_t relay_control_ui_get_state_version(void);
+
+/**
+ * @brief Set the function called whenever the state version is bumped
+ * 
+ * The listener runs in the task that changed the relay (usually the LVGL task,
+ * with the LVGL lock held), so it must only note the change and return.
+ * 
+ * @param listener Function to call, or NULL to remove it
+ */
+void relay_control_ui_set_change_listener(void (*listener)(void));
+
 /**
  * @brief Set relay state programmatically
  * 
@@ -124,6 +179,19 @@ void relay_control_ui_set_state(relay_control_ui_t *ui, bool state);
  */
 void relay_control_ui_toggle(relay_control_ui_t *ui);
 
+/**
+ * @brief Suspend or resume on-screen updates (e.g. while the display is dark)
+ * 
+ * While suspended current readings and countdown ticks are not
+ * drawn (the progress bars are paused through countdown_anim_set_suspended());
+ * relay control and timers keep running.
+ * Resuming redraws the tile with the latest state. Must be called from LVGL context.
+ * 
+ * @param ui Pointer to the relay control UI object
+ * @param suspended true to suspend, false to resume
+ */
+void relay_control_ui_set_suspended(relay_control_ui_t *ui, bool suspended);
+
 /**
  * @brief Get the button object (for advanced customization)
  * 
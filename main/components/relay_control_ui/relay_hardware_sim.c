@@ -0,0 +1,156 @@
+/*
+ * Relay Hardware Simulation Component
+ *
+ * Drop-in replacement for relay_hardware.c that the host simulator (sim/)
+ * links against. Implements the same API without touching GPIO or the ADC:
+ * relay state only lives in the object, and an ON relay draws a
+ * deterministic, slowly varying load so the current display, the chart and
+ * the telemetry history have realistic input without relays or sensors.
+ */
+
+#include "relay_hardware.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *DEFAULT_TAG = "relay_hw_sim";
+
+// ADC channel marker for "no current sensing" (same as relay_hardware.c)
+#define ADC_CHANNEL_INVALID     (ADC_CHANNEL_9 + 1)
+// Simulated load: base current per relay plus a triangle ripple
+#define SIM_BASE_CA             50    // 0.50 A for the first relay
+#define SIM_STEP_CA             40    // Each further ADC channel draws 0.40 A more
+#define SIM_RIPPLE_CA           30    // Peak-to-peak ripple
+#define SIM_RIPPLE_PERIOD_MS    20000
+
+/**
+ * @brief Create and initialize a relay hardware object
+ */
+relay_hardware_t *relay_hardware_create(gpio_num_t gpio_pin, gpio_num_t led_pin, adc_unit_t adc_unit, adc_channel_t adc_channel, const char *tag)
+{
+    relay_hardware_t *hw = (relay_hardware_t *)malloc(sizeof(relay_hardware_t));
+    if (hw == NULL) {
+        ESP_LOGE(DEFAULT_TAG, "Failed to allocate memory for relay hardware");
+        return NULL;
+    }
+
+    memset(hw, 0, sizeof(relay_hardware_t));
+    hw->gpio_pin = gpio_pin;
+    hw->led_pin = led_pin;
+    hw->adc_unit = adc_unit;
+    hw->adc_channel = adc_channel;
+    hw->tag = (tag != NULL) ? tag : DEFAULT_TAG;
+    hw->state = false;  // Start with relay OFF
+
+    ESP_LOGI(hw->tag, "Simulated relay hardware created (GPIO %d, ADC%d channel %d not used)",
+             gpio_pin, adc_unit, adc_channel);
+    return hw;
+}
+
+/**
+ * @brief Delete/destroy a relay hardware object
+ */
+void relay_hardware_delete(relay_hardware_t *hw)
+{
+    free(hw);
+}
+
+/**
+ * @brief Get current relay state
+ */
+bool relay_hardware_get_state(const relay_hardware_t *hw)
+{
+    if (hw == NULL) {
+        return false;
+    }
+    return hw->state;
+}
+
+/**
+ * @brief Set relay state
+ */
+esp_err_t relay_hardware_set_state(relay_hardware_t *hw, bool state)
+{
+    if (hw == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    hw->state = state;
+    ESP_LOGI(hw->tag, "Simulated relay set to %s", state ? "ON" : "OFF");
+    return ESP_OK;
+}
+
+/**
+ * @brief Toggle relay state
+ */
+esp_err_t relay_hardware_toggle(relay_hardware_t *hw)
+{
+    if (hw == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return relay_hardware_set_state(hw, !hw->state);
+}
+
+/**
+ * @brief Get GPIO pin number
+ */
+gpio_num_t relay_hardware_get_gpio_pin(const relay_hardware_t *hw)
+{
+    if (hw == NULL) {
+        return GPIO_NUM_NC;
+    }
+    return hw->gpio_pin;
+}
+
+/**
+ * @brief Get LED GPIO pin number
+ */
+gpio_num_t relay_hardware_get_led_pin(const relay_hardware_t *hw)
+{
+    if (hw == NULL) {
+        return GPIO_NUM_NC;
+    }
+    return hw->led_pin;
+}
+
+/**
+ * @brief Simulated current: 0 A when OFF, base load plus a triangle ripple when ON
+ */
+float relay_hardware_read_current(const relay_hardware_t *hw)
+{
+    if (hw == NULL || !hw->state || hw->adc_channel > ADC_CHANNEL_9) {
+        return 0.0f;
+    }
+
+    uint32_t phase_ms = (uint32_t)((esp_timer_get_time() / 1000) % SIM_RIPPLE_PERIOD_MS);
+    uint32_t half = SIM_RIPPLE_PERIOD_MS / 2;
+    int32_t ripple = (phase_ms < half) ? (int32_t)phase_ms : (int32_t)(SIM_RIPPLE_PERIOD_MS - phase_ms);
+    ripple = (ripple * SIM_RIPPLE_CA) / (int32_t)half;
+
+    int32_t channel_index = (int32_t)hw->adc_channel + (hw->adc_unit == ADC_UNIT_2 ? 10 : 0);
+    int32_t current_ca = SIM_BASE_CA + SIM_STEP_CA * (channel_index % 6) + ripple;
+    return (float)current_ca / 100.0f;
+}
+
+/**
+ * @brief Get ADC unit
+ */
+adc_unit_t relay_hardware_get_adc_unit(const relay_hardware_t *hw)
+{
+    if (hw == NULL) {
+        return ADC_UNIT_1;
+    }
+    return hw->adc_unit;
+}
+
+/**
+ * @brief Get ADC channel number
+ */
+adc_channel_t relay_hardware_get_adc_channel(const relay_hardware_t *hw)
+{
+    if (hw == NULL) {
+        return ADC_CHANNEL_INVALID;
+    }
+    return hw->adc_channel;
+}
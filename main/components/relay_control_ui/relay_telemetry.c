@@ -0,0 +1,239 @@
+/*
+ * Relay Telemetry Component
+ *
+ * One task reads every registered current sensor each
+ * RELAY_TELEMETRY_SAMPLE_PERIOD_MS and folds the sample into a fixed ring of
+ * RELAY_TELEMETRY_HISTORY_POINTS points per zoom tier. Coarser tiers average
+ * their samples as they arrive, so zooming out never rescans raw data and the
+ * memory per relay is constant (a few hundred bytes, no heap).
+ *
+ * The ADC oneshot driver is not safe to use from several tasks, so this is
+ * now the only place that calls relay_hardware_read_current().
+ */
+
+#include "relay_telemetry.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "task_layout.h"
+
+static const char *TAG = "relay_telemetry";
+
+typedef struct {
+    int16_t points[RELAY_TELEMETRY_HISTORY_POINTS];  // Ring, point n lives at n % RELAY_TELEMETRY_HISTORY_POINTS
+    uint32_t seq;                                     // Points pushed so far
+    int32_t acc;                                      // Sum of the samples of the point being built
+    uint16_t acc_count;
+} telemetry_tier_t;
+
+typedef struct {
+    relay_hardware_t *hw;
+    volatile int32_t latest_ca;
+    uint64_t charge_mas;                              // Charge since boot in milliampere-seconds
+    relay_telemetry_listener_t listener;              // Told when latest_ca changes
+    void *listener_ctx;
+    telemetry_tier_t tiers[RELAY_TELEMETRY_TIER_COUNT];
+} telemetry_channel_t;
+
+static const uint16_t tier_samples_per_point[RELAY_TELEMETRY_TIER_COUNT] = { 1, 10, 60 };
+
+static telemetry_channel_t channels[RELAY_TELEMETRY_MAX_CHANNELS];
+static int channel_count = 0;
+static TaskHandle_t telemetry_task = NULL;
+static portMUX_TYPE telemetry_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Fold one sample into every tier of a channel
+ *
+ * @return bool true if the latest reading changed
+ */
+static bool telemetry_push_sample(telemetry_channel_t *ch, int32_t value_ca)
+{
+    if (value_ca > INT16_MAX) {
+        value_ca = INT16_MAX;
+    } else if (value_ca < INT16_MIN) {
+        value_ca = INT16_MIN;
+    }
+
+    taskENTER_CRITICAL(&telemetry_lock);
+    bool changed = ch->latest_ca != value_ca;
+    ch->latest_ca = value_ca;
+    if (value_ca > 0) {
+        ch->charge_mas += (uint64_t)value_ca * 10 * RELAY_TELEMETRY_SAMPLE_PERIOD_MS / 1000;
+    }
+    for (int t = 0; t < RELAY_TELEMETRY_TIER_COUNT; t++) {
+        telemetry_tier_t *tier = &ch->tiers[t];
+        tier->acc += value_ca;
+        if (++tier->acc_count < tier_samples_per_point[t]) {
+            continue;
+        }
+        tier->points[tier->seq % RELAY_TELEMETRY_HISTORY_POINTS] = (int16_t)(tier->acc / tier->acc_count);
+        tier->seq++;
+        tier->acc = 0;
+        tier->acc_count = 0;
+    }
+    taskEXIT_CRITICAL(&telemetry_lock);
+    return changed;
+}
+
+/**
+ * @brief Sampling task - reads all channels at a fixed rate
+ */
+static void telemetry_task_fn(void *arg)
+{
+    (void)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        for (int i = 0; i < channel_count; i++) {
+            // ADC averaging happens here, outside the LVGL and HTTP tasks
+            float amps = relay_hardware_read_current(channels[i].hw);
+            // Rounded half away from zero, so a small negative offset reads -0.01 A, not 0.00 A
+            if (!telemetry_push_sample(&channels[i], (int32_t)lroundf(amps * 100.0f))) {
+                continue;
+            }
+
+            // Only a changed reading wakes the listener, so a steady load costs the UI nothing
+            taskENTER_CRITICAL(&telemetry_lock);
+            relay_telemetry_listener_t listener = channels[i].listener;
+            void *ctx = channels[i].listener_ctx;
+            taskEXIT_CRITICAL(&telemetry_lock);
+            if (listener != NULL) {
+                listener(ctx);
+            }
+        }
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(RELAY_TELEMETRY_SAMPLE_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief Register a relay for sampling (call before relay_telemetry_start())
+ */
+int relay_telemetry_register(relay_hardware_t *hw)
+{
+    if (hw == NULL) {
+        return -1;
+    }
+    if (channel_count >= RELAY_TELEMETRY_MAX_CHANNELS) {
+        ESP_LOGW(TAG, "No free telemetry channel for %s", hw->tag != NULL ? hw->tag : "relay");
+        return -1;
+    }
+
+    telemetry_channel_t *ch = &channels[channel_count];
+    memset(ch, 0, sizeof(telemetry_channel_t));
+    ch->hw = hw;
+    return channel_count++;
+}
+
+/**
+ * @brief Start the sampling task
+ */
+esp_err_t relay_telemetry_start(void)
+{
+    if (telemetry_task != NULL) {
+        return ESP_OK;
+    }
+
+    // Placed on the UI core, next to the LVGL task that shows its readings
+    esp_err_t ret = task_layout_create(TASK_ROLE_TELEMETRY, telemetry_task_fn, NULL, &telemetry_task);
+    if (ret != ESP_OK) {
+        telemetry_task = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Sampling %d relays every %d ms, %u bytes of history",
+             channel_count, RELAY_TELEMETRY_SAMPLE_PERIOD_MS, (unsigned)sizeof(channels));
+    return ESP_OK;
+}
+
+/**
+ * @brief Set the function told when a channel's latest reading changes
+ */
+void relay_telemetry_set_listener(int channel, relay_telemetry_listener_t listener, void *ctx)
+{
+    if (channel < 0 || channel >= channel_count) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&telemetry_lock);
+    channels[channel].listener = listener;
+    channels[channel].listener_ctx = ctx;
+    taskEXIT_CRITICAL(&telemetry_lock);
+}
+
+/**
+ * @brief Get the latest reading of a channel
+ */
+int32_t relay_telemetry_get_current_ca(int channel)
+{
+    if (channel < 0 || channel >= channel_count) {
+        return 0;
+    }
+    return channels[channel].latest_ca;
+}
+
+/**
+ * @brief Get the charge a channel has drawn since boot
+ */
+uint64_t relay_telemetry_get_charge_mas(int channel)
+{
+    if (channel < 0 || channel >= channel_count) {
+        return 0;
+    }
+    // 64-bit, so read under the lock the sampling task writes it with
+    taskENTER_CRITICAL(&telemetry_lock);
+    uint64_t charge = channels[channel].charge_mas;
+    taskEXIT_CRITICAL(&telemetry_lock);
+    return charge;
+}
+
+/**
+ * @brief Get the number of points ever pushed to a tier
+ */
+uint32_t relay_telemetry_get_seq(int channel, relay_telemetry_tier_t tier)
+{
+    if (channel < 0 || channel >= channel_count || tier >= RELAY_TELEMETRY_TIER_COUNT) {
+        return 0;
+    }
+
+    taskENTER_CRITICAL(&telemetry_lock);
+    uint32_t seq = channels[channel].tiers[tier].seq;
+    taskEXIT_CRITICAL(&telemetry_lock);
+    return seq;
+}
+
+/**
+ * @brief Read one history point by sequence number
+ */
+bool relay_telemetry_get_point(int channel, relay_telemetry_tier_t tier, uint32_t seq, int16_t *value_ca)
+{
+    if (channel < 0 || channel >= channel_count || tier >= RELAY_TELEMETRY_TIER_COUNT || value_ca == NULL) {
+        return false;
+    }
+
+    bool valid = false;
+    taskENTER_CRITICAL(&telemetry_lock);
+    const telemetry_tier_t *t = &channels[channel].tiers[tier];
+    // Only the last RELAY_TELEMETRY_HISTORY_POINTS points are still in the ring
+    if (seq < t->seq && t->seq - seq <= RELAY_TELEMETRY_HISTORY_POINTS) {
+        *value_ca = t->points[seq % RELAY_TELEMETRY_HISTORY_POINTS];
+        valid = true;
+    }
+    taskEXIT_CRITICAL(&telemetry_lock);
+    return valid;
+}
+
+/**
+ * @brief Time covered by one point of a tier
+ */
+uint32_t relay_telemetry_get_point_period_ms(relay_telemetry_tier_t tier)
+{
+    if (tier >= RELAY_TELEMETRY_TIER_COUNT) {
+        return 0;
+    }
+    return (uint32_t)tier_samples_per_point[tier] * RELAY_TELEMETRY_SAMPLE_PERIOD_MS;
+}
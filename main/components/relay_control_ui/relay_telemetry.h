@@ -0,0 +1,119 @@
+/*
+ * Relay Telemetry Component Header
+ *
+ * Samples the current sensor of every registered relay from one background
+ * task and keeps a short, fixed-size history per relay at a few zoom tiers.
+ * The UI and the HTTP server read the latest value and the history from here
+ * instead of touching the ADC themselves.
+ */
+
+#ifndef RELAY_TELEMETRY_H
+#define RELAY_TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "relay_hardware.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RELAY_TELEMETRY_MAX_CHANNELS     6
+#define RELAY_TELEMETRY_SAMPLE_PERIOD_MS 500  // One ADC reading per relay every 500 ms
+#define RELAY_TELEMETRY_HISTORY_POINTS   60   // Points kept per relay and tier
+
+/**
+ * @brief History zoom tiers; each point of a tier is the average of several samples
+ */
+typedef enum {
+    RELAY_TELEMETRY_TIER_30S = 0,   // 1 sample per point, 30 s window
+    RELAY_TELEMETRY_TIER_5MIN,      // 10 samples per point, 5 min window
+    RELAY_TELEMETRY_TIER_30MIN,     // 60 samples per point, 30 min window
+    RELAY_TELEMETRY_TIER_COUNT
+} relay_telemetry_tier_t;
+
+/**
+ * @brief Called from the sampling task when a channel's latest reading changes
+ *
+ * Must not block; hand the work to another task (e.g. wake an LVGL timer).
+ */
+typedef void (*relay_telemetry_listener_t)(void *ctx);
+
+/**
+ * @brief Register a relay for sampling (call before relay_telemetry_start())
+ *
+ * @param hw Relay hardware object with a current sensor
+ * @return int Channel number, or -1 if hw is NULL or all channels are taken
+ */
+int relay_telemetry_register(relay_hardware_t *hw);
+
+/**
+ * @brief Start the sampling task
+ *
+ * @return esp_err_t ESP_OK on success (or if already started)
+ */
+esp_err_t relay_telemetry_start(void);
+
+/**
+ * @brief Set the function told when a channel's latest reading changes
+ *
+ * One listener per channel; a steady reading never calls it.
+ *
+ * @param channel Channel returned by relay_telemetry_register()
+ * @param listener Function to call, or NULL to stop notifications
+ * @param ctx Passed to the listener
+ */
+void relay_telemetry_set_listener(int channel, relay_telemetry_listener_t listener, void *ctx);
+
+/**
+ * @brief Get the latest reading of a channel
+ *
+ * @param channel Channel returned by relay_telemetry_register()
+ * @return int32_t Current in hundredths of an Ampere (0 for an invalid channel)
+ */
+int32_t relay_telemetry_get_current_ca(int channel);
+
+/**
+ * @brief Get the charge a channel has drawn since boot
+ *
+ * Integrated from the samples, one sample period per reading.
+ *
+ * @param channel Channel returned by relay_telemetry_register()
+ * @return uint64_t Charge in milliampere-seconds (0 for an invalid channel)
+ */
+uint64_t relay_telemetry_get_charge_mas(int channel);
+
+/**
+ * @brief Get the number of points ever pushed to a tier
+ *
+ * Point n (0-based) can be read with relay_telemetry_get_point() as long as
+ * it is one of the last RELAY_TELEMETRY_HISTORY_POINTS points.
+ *
+ * @param channel Channel returned by relay_telemetry_register()
+ * @param tier Zoom tier
+ * @return uint32_t Point count (0 for an invalid channel)
+ */
+uint32_t relay_telemetry_get_seq(int channel, relay_telemetry_tier_t tier);
+
+/**
+ * @brief Read one history point by sequence number
+ *
+ * @param channel Channel returned by relay_telemetry_register()
+ * @param tier Zoom tier
+ * @param seq Sequence number of the point (0-based)
+ * @param value_ca Output: average current of the point in hundredths of an Ampere
+ * @return true if the point is still in the history
+ */
+bool relay_telemetry_get_point(int channel, relay_telemetry_tier_t tier, uint32_t seq, int16_t *value_ca);
+
+/**
+ * @brief Time covered by one point of a tier
+ */
+uint32_t relay_telemetry_get_point_period_ms(relay_telemetry_tier_t tier);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RELAY_TELEMETRY_H
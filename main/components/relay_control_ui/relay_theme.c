@@ -0,0 +1,277 @@
+/*
+ * Relay Theme Component
+ *
+ * Shared, statically allocated LVGL styles for the relay tiles and the master
+ * button. Every widget references the same lv_style_t objects, so the LVGL
+ * heap only holds one style list entry per widget instead of a local style
+ * block with a dozen properties, and a state change is a single
+ * lv_obj_add_state()/lv_obj_remove_state() call.
+ */
+
+#include "relay_theme.h"
+#include <stdbool.h>
+#include "lvgl.h"
+#include "esp_log.h"
+#include "relay_control_ui.h"
+#include "font_subset.h"
+
+#define THEME_COLOR_SHADOW         0x808080
+#define THEME_COLOR_IDLE_TEXT      0x808080
+#define THEME_COLOR_IDLE_BG        0x202020
+#define THEME_COLOR_ACTIVE_TEXT    0x00FF00
+#define THEME_COLOR_ACTIVE_BG      0x004400
+#define THEME_COLOR_BAR_OK         0x00FF00
+#define THEME_COLOR_BAR_WARNING    0xFFFF00
+#define THEME_COLOR_BAR_CRITICAL   0xFF0000
+#define THEME_CURRENT_BOX_WIDTH    80
+#define THEME_CURRENT_BOX_HEIGHT   30
+#define THEME_COLOR_CHART_BG       0x101010
+#define THEME_COLOR_CHART_GRID     0x303030
+
+static const char *TAG = "relay_theme";
+
+static bool theme_initialized = false;
+
+// Buttons
+static lv_style_t style_button;            // Shape, shadow and OFF colour
+static lv_style_t style_button_on;         // ON colour (RELAY_THEME_STATE_ON)
+// Countdown
+static lv_style_t style_timer_label;
+static lv_style_t style_bar;               // Bar size
+static lv_style_t style_bar_indicator;     // Green indicator
+static lv_style_t style_bar_warning;       // Yellow indicator (RELAY_THEME_STATE_WARNING)
+static lv_style_t style_bar_critical;      // Red indicator (RELAY_THEME_STATE_CRITICAL)
+// Current display
+static lv_style_t style_current_box;       // Idle bubble
+static lv_style_t style_current_box_active;
+static lv_style_t style_current_label;     // Idle text
+static lv_style_t style_current_label_active;
+// Current chart
+static lv_style_t style_chart;
+static lv_style_t style_chart_line;        // Series line, no point markers
+
+/**
+ * @brief Initialize the shared styles (safe to call more than once)
+ */
+void relay_theme_init(void)
+{
+    if (theme_initialized) {
+        return;
+    }
+
+    lv_style_init(&style_button);
+    lv_style_set_width(&style_button, BUTTON_WIDTH_PX);
+    lv_style_set_height(&style_button, BUTTON_HEIGHT_PX);
+    lv_style_set_bg_color(&style_button, lv_color_hex(BUTTON_OFF_COLOR_HEX));
+    lv_style_set_radius(&style_button, 10);
+    lv_style_set_shadow_width(&style_button, 10);
+    lv_style_set_shadow_color(&style_button, lv_color_hex(THEME_COLOR_SHADOW));
+    lv_style_set_shadow_opa(&style_button, LV_OPA_50);
+
+    lv_style_init(&style_button_on);
+    lv_style_set_bg_color(&style_button_on, lv_color_hex(BUTTON_ON_COLOR_HEX));
+
+    lv_style_init(&style_timer_label);
+    lv_style_set_text_align(&style_timer_label, TIMER_LABEL_TEXT_ALIGN);
+    lv_style_set_text_color(&style_timer_label, TIMER_LABEL_TEXT_COLOR);
+    lv_style_set_text_font(&style_timer_label, font_subset_get());
+
+    lv_style_init(&style_bar);
+    lv_style_set_width(&style_bar, PROGRESS_BAR_WIDTH_PX);
+    lv_style_set_height(&style_bar, PROGRESS_BAR_HEIGHT_PX);
+
+    lv_style_init(&style_bar_indicator);
+    lv_style_set_bg_color(&style_bar_indicator, lv_color_hex(THEME_COLOR_BAR_OK));
+
+    lv_style_init(&style_bar_warning);
+    lv_style_set_bg_color(&style_bar_warning, lv_color_hex(THEME_COLOR_BAR_WARNING));
+
+    lv_style_init(&style_bar_critical);
+    lv_style_set_bg_color(&style_bar_critical, lv_color_hex(THEME_COLOR_BAR_CRITICAL));
+
+    lv_style_init(&style_current_box);
+    lv_style_set_width(&style_current_box, THEME_CURRENT_BOX_WIDTH);
+    lv_style_set_height(&style_current_box, THEME_CURRENT_BOX_HEIGHT);
+    lv_style_set_bg_opa(&style_current_box, LV_OPA_80);
+    lv_style_set_bg_color(&style_current_box, lv_color_hex(THEME_COLOR_IDLE_BG));
+    lv_style_set_border_width(&style_current_box, 2);
+    lv_style_set_border_color(&style_current_box, lv_color_hex(THEME_COLOR_IDLE_TEXT));
+    lv_style_set_radius(&style_current_box, 5);
+    lv_style_set_pad_all(&style_current_box, 4);
+
+    lv_style_init(&style_current_box_active);
+    lv_style_set_bg_color(&style_current_box_active, lv_color_hex(THEME_COLOR_ACTIVE_BG));
+    lv_style_set_border_color(&style_current_box_active, lv_color_hex(THEME_COLOR_ACTIVE_TEXT));
+
+    lv_style_init(&style_current_label);
+    lv_style_set_text_align(&style_current_label, CURRENT_LABEL_TEXT_ALIGN);
+    lv_style_set_text_color(&style_current_label, lv_color_hex(THEME_COLOR_IDLE_TEXT));
+    lv_style_set_text_font(&style_current_label, font_subset_get());
+
+    lv_style_init(&style_current_label_active);
+    lv_style_set_text_color(&style_current_label_active, lv_color_hex(THEME_COLOR_ACTIVE_TEXT));
+
+    lv_style_init(&style_chart);
+    lv_style_set_bg_color(&style_chart, lv_color_hex(THEME_COLOR_CHART_BG));
+    lv_style_set_border_color(&style_chart, lv_color_hex(THEME_COLOR_CHART_GRID));
+    lv_style_set_line_color(&style_chart, lv_color_hex(THEME_COLOR_CHART_GRID));
+    lv_style_set_radius(&style_chart, 0);
+
+    lv_style_init(&style_chart_line);
+    lv_style_set_line_width(&style_chart_line, 2);
+    lv_style_set_width(&style_chart_line, 0);
+    lv_style_set_height(&style_chart_line, 0);
+
+    theme_initialized = true;
+}
+
+/**
+ * @brief Apply the relay/master button styles (size, shape, OFF/ON colours)
+ */
+void relay_theme_apply_button(lv_obj_t *button, int32_t width, int32_t height)
+{
+    if (button == NULL) {
+        return;
+    }
+    relay_theme_init();
+    lv_obj_add_style(button, &style_button, LV_PART_MAIN);
+    lv_obj_add_style(button, &style_button_on, LV_PART_MAIN | RELAY_THEME_STATE_ON);
+    // Only buttons that deviate from the shared size get local width/height
+    if (width != BUTTON_WIDTH_PX || height != BUTTON_HEIGHT_PX) {
+        lv_obj_set_size(button, width, height);
+    }
+}
+
+/**
+ * @brief Apply the countdown label style
+ */
+void relay_theme_apply_timer_label(lv_obj_t *label)
+{
+    if (label == NULL) {
+        return;
+    }
+    relay_theme_init();
+    lv_obj_add_style(label, &style_timer_label, LV_PART_MAIN);
+}
+
+/**
+ * @brief Apply the countdown progress bar styles (size, green/yellow/red indicator)
+ */
+void relay_theme_apply_progress_bar(lv_obj_t *bar)
+{
+    if (bar == NULL) {
+        return;
+    }
+    relay_theme_init();
+    lv_obj_add_style(bar, &style_bar, LV_PART_MAIN);
+    lv_obj_add_style(bar, &style_bar_indicator, LV_PART_INDICATOR);
+    lv_obj_add_style(bar, &style_bar_warning, LV_PART_INDICATOR | RELAY_THEME_STATE_WARNING);
+    lv_obj_add_style(bar, &style_bar_critical, LV_PART_INDICATOR | RELAY_THEME_STATE_CRITICAL);
+}
+
+/**
+ * @brief Apply the current display bubble styles (idle/active)
+ */
+void relay_theme_apply_current_display(lv_obj_t *container, lv_obj_t *label)
+{
+    relay_theme_init();
+    if (container != NULL) {
+        lv_obj_add_style(container, &style_current_box, LV_PART_MAIN);
+        lv_obj_add_style(container, &style_current_box_active, LV_PART_MAIN | RELAY_THEME_STATE_ACTIVE);
+    }
+    if (label != NULL) {
+        lv_obj_add_style(label, &style_current_label, LV_PART_MAIN);
+        lv_obj_add_style(label, &style_current_label_active, LV_PART_MAIN | RELAY_THEME_STATE_ACTIVE);
+    }
+}
+
+/**
+ * @brief Apply the current chart styles (background, grid, series line without markers)
+ */
+void relay_theme_apply_chart(lv_obj_t *chart)
+{
+    if (chart == NULL) {
+        return;
+    }
+    relay_theme_init();
+    lv_obj_add_style(chart, &style_chart, LV_PART_MAIN);
+    lv_obj_add_style(chart, &style_chart_line, LV_PART_ITEMS);
+    lv_obj_add_style(chart, &style_chart_line, LV_PART_INDICATOR);
+}
+
+/**
+ * @brief LVGL heap taken by one tile's objects, styled locally or with the shared theme
+ *
+ * The local variant repeats the lv_obj_set_style_*() calls the tiles made
+ * before the theme, including the OFF -> ON colour change, so the difference
+ * between the two is what the theme saves per tile.
+ */
+static size_t relay_theme_tile_cost(lv_obj_t *parent, bool shared)
+{
+    lv_mem_monitor_t before;
+    lv_mem_monitor_t after;
+    lv_mem_monitor(&before);
+
+    lv_obj_t *button = lv_button_create(parent);
+    lv_obj_t *label = lv_label_create(button);
+    lv_obj_t *timer_label = lv_label_create(parent);
+    lv_obj_t *bar = lv_bar_create(parent);
+    lv_obj_t *container = lv_obj_create(parent);
+    lv_obj_t *current_label = lv_label_create(container);
+    lv_label_set_text_static(label, "Relay 1 OFF");
+
+    if (shared) {
+        relay_theme_apply_button(button, BUTTON_WIDTH_PX, BUTTON_HEIGHT_PX);
+        relay_theme_apply_timer_label(timer_label);
+        relay_theme_apply_progress_bar(bar);
+        relay_theme_apply_current_display(container, current_label);
+        lv_obj_add_state(button, RELAY_THEME_STATE_ON);
+    } else {
+        lv_obj_set_size(button, BUTTON_WIDTH_PX, BUTTON_HEIGHT_PX);
+        lv_obj_set_style_bg_color(button, BUTTON_OFF_COLOR, LV_PART_MAIN);
+        lv_obj_set_style_radius(button, 10, LV_PART_MAIN);
+        lv_obj_set_style_shadow_width(button, 10, LV_PART_MAIN);
+        lv_obj_set_style_shadow_color(button, lv_color_hex(THEME_COLOR_SHADOW), LV_PART_MAIN);
+        lv_obj_set_style_shadow_opa(button, LV_OPA_50, LV_PART_MAIN);
+        lv_obj_set_style_text_align(timer_label, TIMER_LABEL_TEXT_ALIGN, LV_PART_MAIN);
+        lv_obj_set_style_text_color(timer_label, TIMER_LABEL_TEXT_COLOR, LV_PART_MAIN);
+        lv_obj_set_size(bar, PROGRESS_BAR_WIDTH_PX, PROGRESS_BAR_HEIGHT_PX);
+        lv_obj_set_style_bg_color(bar, lv_color_hex(THEME_COLOR_BAR_OK), LV_PART_INDICATOR);
+        lv_obj_set_size(container, THEME_CURRENT_BOX_WIDTH, THEME_CURRENT_BOX_HEIGHT);
+        lv_obj_set_style_bg_opa(container, LV_OPA_80, LV_PART_MAIN);
+        lv_obj_set_style_bg_color(container, lv_color_hex(THEME_COLOR_IDLE_BG), LV_PART_MAIN);
+        lv_obj_set_style_border_width(container, 2, LV_PART_MAIN);
+        lv_obj_set_style_border_color(container, lv_color_hex(THEME_COLOR_IDLE_TEXT), LV_PART_MAIN);
+        lv_obj_set_style_radius(container, 5, LV_PART_MAIN);
+        lv_obj_set_style_pad_all(container, 4, LV_PART_MAIN);
+        lv_obj_set_style_text_align(current_label, CURRENT_LABEL_TEXT_ALIGN, LV_PART_MAIN);
+        lv_obj_set_style_text_color(current_label, lv_color_hex(THEME_COLOR_IDLE_TEXT), LV_PART_MAIN);
+        lv_obj_set_style_bg_color(button, BUTTON_ON_COLOR, LV_PART_MAIN);
+    }
+
+    lv_mem_monitor(&after);
+    lv_obj_delete(button);
+    lv_obj_delete(timer_label);
+    lv_obj_delete(bar);
+    lv_obj_delete(container);
+
+    size_t used_before = before.total_size - before.free_size;
+    size_t used_after = after.total_size - after.free_size;
+    return used_after > used_before ? used_after - used_before : 0;
+}
+
+/**
+ * @brief Measure and log the LVGL heap one tile takes with local and with shared styles
+ */
+void relay_theme_log_heap_savings(lv_obj_t *parent, int tiles)
+{
+    if (parent == NULL) {
+        return;
+    }
+    relay_theme_init();
+    size_t local = relay_theme_tile_cost(parent, false);
+    size_t shared = relay_theme_tile_cost(parent, true);
+    long saved = ((long)local - (long)shared) * tiles;
+    ESP_LOGI(TAG, "LVGL heap per relay tile: %u bytes with local styles, %u with the shared theme (%ld bytes for %d tiles)",
+             (unsigned)local, (unsigned)shared, saved, tiles);
+}
@@ -0,0 +1,84 @@
+/*
+ * Relay Theme Component Header
+ * 
+ * Shared, statically allocated LVGL styles for the relay tiles and the master
+ * button. Widgets attach these styles once and switch appearance by changing
+ * object state instead of setting per-object local style properties.
+ */
+
+#ifndef RELAY_THEME_H
+#define RELAY_THEME_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Object states used by the theme
+#define RELAY_THEME_STATE_ON       LV_STATE_CHECKED  // Button: relay (or any relay for master) is ON
+#define RELAY_THEME_STATE_ACTIVE   LV_STATE_USER_1   // Current display: current is flowing
+#define RELAY_THEME_STATE_WARNING  LV_STATE_USER_1   // Progress bar: 20-50% of the countdown left
+#define RELAY_THEME_STATE_CRITICAL LV_STATE_USER_2   // Progress bar: less than 20% of the countdown left
+
+/**
+ * @brief Initialize the shared styles (safe to call more than once)
+ */
+void relay_theme_init(void);
+
+/**
+ * @brief Apply the relay/master button styles (size, shape, OFF/ON colours)
+ * 
+ * @param button Button object
+ * @param width Button width in pixels
+ * @param height Button height in pixels
+ */
+void relay_theme_apply_button(lv_obj_t *button, int32_t width, int32_t height);
+
+/**
+ * @brief Apply the countdown label style
+ * 
+ * @param label Timer label object
+ */
+void relay_theme_apply_timer_label(lv_obj_t *label);
+
+/**
+ * @brief Apply the countdown progress bar styles (size, green/yellow/red indicator)
+ * 
+ * @param bar Progress bar object
+ */
+void relay_theme_apply_progress_bar(lv_obj_t *bar);
+
+/**
+ * @brief Apply the current display bubble styles (idle/active)
+ * 
+ * @param container Current display container
+ * @param label Current label inside the container
+ */
+void relay_theme_apply_current_display(lv_obj_t *container, lv_obj_t *label);
+
+/**
+ * @brief Apply the current chart styles (background, grid, series line without markers)
+ * 
+ * @param chart Chart object
+ */
+void relay_theme_apply_chart(lv_obj_t *chart);
+
+/**
+ * @brief Measure and log the LVGL heap one tile takes with local and with shared styles
+ * 
+ * Builds a tile's objects once with the per-object style properties the tiles
+ * used before the theme and once with the theme, logs both costs and the
+ * difference for the given number of tiles, and deletes the objects again.
+ * Call with the LVGL lock held, before the tiles are built.
+ * 
+ * @param parent Screen to build the scratch objects on
+ * @param tiles Number of tiles the dashboard shows
+ */
+void relay_theme_log_heap_savings(lv_obj_t *parent, int tiles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RELAY_THEME_H
@@ -0,0 +1,234 @@
+/*
+ * Screen Manager Component
+ *
+ * Secondary screens live in a fixed table of SCREEN_MANAGER_MAX_LIVE slots
+ * ordered by last use. Opening a screen that is alive just loads it again;
+ * otherwise hidden screens are destroyed, least recently used first, until a
+ * slot is free and the LVGL heap has SCREEN_MANAGER_MIN_FREE_BYTES left, and
+ * the new screen is built. The active screen is never destroyed.
+ */
+
+#include "screen_manager.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include "lvgl.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "screen_mgr";
+
+typedef struct {
+    const screen_manager_class_t *cls;  // NULL for a free slot
+    void *key;
+    void *instance;
+    lv_obj_t *screen;
+    uint32_t last_used;                 // Navigation counter value of the last open
+} screen_slot_t;
+
+static screen_slot_t slots[SCREEN_MANAGER_MAX_LIVE];
+static screen_slot_t *active_slot = NULL;  // NULL while the home screen is shown
+static lv_obj_t *home_screen = NULL;
+static screen_manager_stats_t mgr_stats;
+
+/**
+ * @brief Free bytes in the LVGL heap
+ */
+static uint32_t lvgl_heap_free(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return (uint32_t)mon.free_size;
+}
+
+/**
+ * @brief Destroy a hidden screen and free its slot
+ */
+static void screen_slot_destroy(screen_slot_t *slot)
+{
+    ESP_LOGI(TAG, "Destroying %s screen (last used at navigation %" PRIu32 ")", slot->cls->name, slot->last_used);
+    slot->cls->destroy(slot->instance);
+    memset(slot, 0, sizeof(screen_slot_t));
+    mgr_stats.live--;
+}
+
+/**
+ * @brief Destroy the least recently used hidden screen
+ *
+ * @return true if a screen was destroyed
+ */
+static bool screen_manager_evict_lru(void)
+{
+    screen_slot_t *lru = NULL;
+    for (int i = 0; i < SCREEN_MANAGER_MAX_LIVE; i++) {
+        screen_slot_t *slot = &slots[i];
+        if (slot->cls == NULL || slot == active_slot) {
+            continue;
+        }
+        if (lru == NULL || slot->last_used < lru->last_used) {
+            lru = slot;
+        }
+    }
+    if (lru == NULL) {
+        return false;
+    }
+    screen_slot_destroy(lru);
+    mgr_stats.evicted++;
+    return true;
+}
+
+/**
+ * @brief Find a free slot, evicting hidden screens while the LRU is full or the heap is low
+ */
+static screen_slot_t *screen_manager_make_room(void)
+{
+    while (lvgl_heap_free() < SCREEN_MANAGER_MIN_FREE_BYTES && screen_manager_evict_lru()) {
+    }
+    for (int i = 0; i < SCREEN_MANAGER_MAX_LIVE; i++) {
+        if (slots[i].cls == NULL) {
+            return &slots[i];
+        }
+    }
+    if (!screen_manager_evict_lru()) {
+        return NULL;
+    }
+    for (int i = 0; i < SCREEN_MANAGER_MAX_LIVE; i++) {
+        if (slots[i].cls == NULL) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Hide the active secondary screen (it stays alive)
+ */
+static void screen_manager_hide_active(void)
+{
+    if (active_slot != NULL && active_slot->cls->hide != NULL) {
+        active_slot->cls->hide(active_slot->instance);
+    }
+    active_slot = NULL;
+}
+
+/**
+ * @brief Render the new screen right away and record the transition
+ */
+static void screen_manager_finish_transition(const char *name, int64_t start_us, bool created)
+{
+    lv_refr_now(NULL);
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t used = (uint32_t)(mon.total_size - mon.free_size);
+    if (used > mgr_stats.peak_heap_used) {
+        mgr_stats.peak_heap_used = used;
+    }
+    mgr_stats.last_transition_us = elapsed_us;
+    if (elapsed_us > mgr_stats.max_transition_us) {
+        mgr_stats.max_transition_us = elapsed_us;
+    }
+
+    ESP_LOGI(TAG, "%s screen %s in %" PRIu32 " us, LVGL heap used %" PRIu32 " (peak %" PRIu32 ", max used %u), %" PRIu32 "/%d live",
+             name, created ? "created and shown" : "shown", elapsed_us, used, mgr_stats.peak_heap_used,
+             (unsigned)mon.max_used, mgr_stats.live, SCREEN_MANAGER_MAX_LIVE);
+}
+
+/**
+ * @brief Set the home screen that the back navigation returns to
+ */
+void screen_manager_init(lv_obj_t *home)
+{
+    home_screen = home;
+}
+
+/**
+ * @brief Show the screen of a kind for a key, creating it if it is not alive
+ */
+esp_err_t screen_manager_open(const screen_manager_class_t *cls, void *key)
+{
+    if (cls == NULL || cls->create == NULL || cls->destroy == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    uint32_t now = ++mgr_stats.navigations;
+
+    screen_slot_t *slot = NULL;
+    for (int i = 0; i < SCREEN_MANAGER_MAX_LIVE; i++) {
+        if (slots[i].cls == cls && slots[i].key == key) {
+            slot = &slots[i];
+            break;
+        }
+    }
+    if (slot != NULL && slot == active_slot) {
+        slot->last_used = now;
+        return ESP_OK;
+    }
+
+    bool created = false;
+    if (slot == NULL) {
+        slot = screen_manager_make_room();
+        if (slot == NULL) {
+            ESP_LOGE(TAG, "No room for a %s screen", cls->name);
+            return ESP_ERR_NO_MEM;
+        }
+        void *instance = NULL;
+        lv_obj_t *screen = cls->create(key, &instance);
+        // Out of LVGL heap despite the margin - drop every hidden screen and try once more
+        if (screen == NULL && screen_manager_evict_lru()) {
+            while (screen_manager_evict_lru()) {
+            }
+            screen = cls->create(key, &instance);
+        }
+        if (screen == NULL) {
+            ESP_LOGE(TAG, "Failed to create %s screen", cls->name);
+            return ESP_ERR_NO_MEM;
+        }
+        slot->cls = cls;
+        slot->key = key;
+        slot->instance = instance;
+        slot->screen = screen;
+        mgr_stats.created++;
+        mgr_stats.live++;
+        created = true;
+    }
+
+    // The previous screen is only hidden once the new one exists, so a failed open leaves it usable
+    screen_manager_hide_active();
+    slot->last_used = now;
+    active_slot = slot;
+    if (cls->show != NULL) {
+        cls->show(slot->instance);
+    }
+    lv_screen_load(slot->screen);
+    screen_manager_finish_transition(cls->name, start_us, created);
+    return ESP_OK;
+}
+
+/**
+ * @brief Return to the home screen; the current screen stays alive in the LRU
+ */
+void screen_manager_back(void)
+{
+    if (home_screen == NULL || active_slot == NULL) {
+        return;
+    }
+    int64_t start_us = esp_timer_get_time();
+    screen_manager_hide_active();
+    lv_screen_load(home_screen);
+    screen_manager_finish_transition("home", start_us, false);
+}
+
+/**
+ * @brief Get screen manager statistics
+ */
+void screen_manager_get_stats(screen_manager_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    *stats = mgr_stats;
+}
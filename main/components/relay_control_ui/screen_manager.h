@@ -0,0 +1,81 @@
+/*
+ * Screen Manager Component Header
+ *
+ * Creates secondary screens (e.g. per-relay detail views) on first navigation
+ * and keeps a small LRU of live screens next to the always-present dashboard.
+ * The least recently used hidden screen is destroyed when the LRU is full or
+ * the LVGL heap runs low, so rich views only cost RAM while they are in use.
+ */
+
+#ifndef SCREEN_MANAGER_H
+#define SCREEN_MANAGER_H
+
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCREEN_MANAGER_MAX_LIVE        CONFIG_EXAMPLE_UI_MAX_LIVE_SCREENS
+#define SCREEN_MANAGER_MIN_FREE_BYTES  (12 * 1024)  // Evict hidden screens before the LVGL heap gets this low
+
+/**
+ * @brief Kind of screen the manager can create (one static instance per kind)
+ */
+typedef struct {
+    const char *name;                                   // For logs
+    lv_obj_t *(*create)(void *key, void **instance);    // Build the screen (not loaded), NULL on failure
+    void (*destroy)(void *instance);                    // Delete the screen and everything it owns
+    void (*show)(void *instance);                       // Optional: about to be loaded
+    void (*hide)(void *instance);                       // Optional: no longer the active screen
+} screen_manager_class_t;
+
+/**
+ * @brief Screen manager statistics (since boot)
+ */
+typedef struct {
+    uint32_t navigations;           // screen_manager_open() calls that loaded a screen
+    uint32_t created;               // Screens built
+    uint32_t evicted;               // Screens destroyed to make room
+    uint32_t live;                  // Secondary screens alive now
+    uint32_t last_transition_us;    // Open call to first rendered frame of the last transition
+    uint32_t max_transition_us;
+    uint32_t peak_heap_used;        // Highest LVGL heap use seen after a transition
+} screen_manager_stats_t;
+
+/**
+ * @brief Set the home screen that the back navigation returns to (LVGL context only)
+ *
+ * @param home Dashboard screen, never destroyed by the manager
+ */
+void screen_manager_init(lv_obj_t *home);
+
+/**
+ * @brief Show the screen of a kind for a key, creating it if it is not alive (LVGL context only)
+ *
+ * @param cls Kind of screen
+ * @param key Identifies the instance (e.g. the relay), passed to cls->create
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the screen could not be built
+ */
+esp_err_t screen_manager_open(const screen_manager_class_t *cls, void *key);
+
+/**
+ * @brief Return to the home screen; the current screen stays alive in the LRU (LVGL context only)
+ */
+void screen_manager_back(void);
+
+/**
+ * @brief Get screen manager statistics
+ *
+ * @param stats Output structure
+ */
+void screen_manager_get_stats(screen_manager_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCREEN_MANAGER_H
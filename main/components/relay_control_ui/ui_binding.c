@@ -0,0 +1,134 @@
+/*
+ * UI Binding Component
+ *
+ * Thin change-detection layer between application state and LVGL widgets.
+ * Each binding remembers the last text and state bits it pushed to its widget
+ * and only calls into LVGL (which invalidates and redraws) on a real change.
+ * All functions must be called from LVGL context.
+ */
+
+#include "ui_binding.h"
+#include <stdbool.h>
+#include <string.h>
+#include "lvgl.h"
+
+static ui_binding_stats_t binding_stats;
+
+/**
+ * @brief Bind a widget; all cached values start invalid so the first update is always applied
+ */
+void ui_binding_init(ui_binding_t *binding, lv_obj_t *obj)
+{
+    if (binding == NULL) {
+        return;
+    }
+    memset(binding, 0, sizeof(ui_binding_t));
+    binding->obj = obj;
+}
+
+/**
+ * @brief Forget cached values (e.g. after the widget was restyled elsewhere)
+ */
+void ui_binding_invalidate(ui_binding_t *binding)
+{
+    if (binding == NULL) {
+        return;
+    }
+    binding->text_valid = false;
+    binding->states_known = 0;
+}
+
+/**
+ * @brief Set label text if it differs from the last applied text
+ */
+bool ui_binding_set_text(ui_binding_t *binding, const char *text)
+{
+    if (binding == NULL || binding->obj == NULL || text == NULL) {
+        return false;
+    }
+
+    if (binding->text_valid && strncmp(binding->text, text, sizeof(binding->text) - 1) == 0) {
+        binding_stats.skipped++;
+        return false;
+    }
+
+    strncpy(binding->text, text, sizeof(binding->text) - 1);
+    binding->text[sizeof(binding->text) - 1] = '\0';
+    binding->text_valid = true;
+    binding_stats.applied++;
+    lv_label_set_text(binding->obj, binding->text);
+    return true;
+}
+
+/**
+ * @brief Add or remove a theme state (e.g. LV_STATE_CHECKED) if it changed
+ */
+bool ui_binding_set_state(ui_binding_t *binding, lv_state_t state, bool enabled)
+{
+    if (binding == NULL || binding->obj == NULL) {
+        return false;
+    }
+
+    lv_state_t wanted = enabled ? state : 0;
+    if ((binding->states_known & state) == state && (binding->states & state) == wanted) {
+        binding_stats.skipped++;
+        return false;
+    }
+
+    binding->states = (lv_state_t)((binding->states & ~state) | wanted);
+    binding->states_known |= state;
+    binding_stats.applied++;
+    if (enabled) {
+        lv_obj_add_state(binding->obj, state);
+    } else {
+        lv_obj_remove_state(binding->obj, state);
+    }
+    return true;
+}
+
+/**
+ * @brief Format a value in hundredths as "I.FF" without floating point printf
+ */
+size_t ui_binding_format_centi(char *buf, size_t len, int32_t centi)
+{
+    char tmp[16];
+    size_t n = 0;
+    bool negative = centi < 0;
+    uint32_t value = negative ? (uint32_t)(-(int64_t)centi) : (uint32_t)centi;
+
+    if (buf == NULL || len == 0) {
+        return 0;
+    }
+
+    // Build the digits in reverse: two decimals, the point, then the integer part
+    tmp[n++] = (char)('0' + value % 10);
+    value /= 10;
+    tmp[n++] = (char)('0' + value % 10);
+    value /= 10;
+    tmp[n++] = '.';
+    do {
+        tmp[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    if (negative) {
+        tmp[n++] = '-';
+    }
+
+    size_t out = 0;
+    while (n > 0 && out < len - 1) {
+        buf[out++] = tmp[--n];
+    }
+    buf[out] = '\0';
+    return out;
+}
+
+/**
+ * @brief Get applied/skipped update counters
+ */
+void ui_binding_get_stats(ui_binding_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    *stats = binding_stats;
+}
@@ -0,0 +1,97 @@
+/*
+ * UI Binding Component Header
+ * 
+ * Thin change-detection layer between application state and LVGL widgets.
+ * Each binding remembers the last text and state bits it pushed to its widget
+ * and only calls into LVGL (which invalidates and redraws) on a real change.
+ */
+
+#ifndef UI_BINDING_H
+#define UI_BINDING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_BINDING_TEXT_LEN 24  // Longest cached text including terminator (e.g. "← 12.34 A")
+
+/**
+ * @brief Binding between one LVGL widget and its last rendered values
+ */
+typedef struct {
+    lv_obj_t *obj;                   // Bound widget (label or container)
+    char text[UI_BINDING_TEXT_LEN];  // Last text applied with ui_binding_set_text()
+    lv_state_t states;               // Theme state bits applied with ui_binding_set_state()
+    lv_state_t states_known;         // Which bits of 'states' have been applied at least once
+    bool text_valid;                 // 'text' holds the label's current text
+} ui_binding_t;
+
+/**
+ * @brief Update counters shared by all bindings
+ */
+typedef struct {
+    uint32_t applied;   // Updates that reached LVGL
+    uint32_t skipped;   // Updates dropped because the value was unchanged
+} ui_binding_stats_t;
+
+/**
+ * @brief Bind a widget; all cached values start invalid so the first update is always applied
+ * 
+ * @param binding Binding to initialize
+ * @param obj Widget to bind (can be NULL, updates are then ignored)
+ */
+void ui_binding_init(ui_binding_t *binding, lv_obj_t *obj);
+
+/**
+ * @brief Forget cached values (e.g. after the widget was restyled elsewhere)
+ * 
+ * @param binding Binding to invalidate
+ */
+void ui_binding_invalidate(ui_binding_t *binding);
+
+/**
+ * @brief Set label text if it differs from the last applied text
+ * 
+ * @param binding Binding for a label widget
+ * @param text New text (truncated to UI_BINDING_TEXT_LEN - 1 characters)
+ * @return true if LVGL was updated, false if skipped
+ */
+bool ui_binding_set_text(ui_binding_t *binding, const char *text);
+
+/**
+ * @brief Add or remove a theme state (e.g. LV_STATE_CHECKED) if it changed
+ * 
+ * @param binding Widget binding
+ * @param state State bit(s) to switch
+ * @param enabled true to add, false to remove
+ * @return true if LVGL was updated, false if skipped
+ */
+bool ui_binding_set_state(ui_binding_t *binding, lv_state_t state, bool enabled);
+
+/**
+ * @brief Format a value in hundredths as "I.FF" without floating point printf
+ * 
+ * @param buf Output buffer
+ * @param len Size of the output buffer
+ * @param centi Value multiplied by 100 (e.g. 123 -> "1.23", -5 -> "-0.05")
+ * @return size_t Number of characters written (excluding terminator)
+ */
+size_t ui_binding_format_centi(char *buf, size_t len, int32_t centi);
+
+/**
+ * @brief Get applied/skipped update counters
+ * 
+ * @param stats Output counters
+ */
+void ui_binding_get_stats(ui_binding_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_BINDING_H
@@ -0,0 +1,346 @@
+/*
+ * Task Layout Component
+ *
+ * The placement table is built from Kconfig. With the layout enabled, the
+ * HTTP server (and so firmware uploads) is pinned to the networking core next
+ * to the WiFi driver and esp_timer tasks, while the LVGL task and the current
+ * sampling task share the other core. The WiFi, lwIP and esp_timer tasks are
+ * created by ESP-IDF and placed by sdkconfig; they are only checked and logged.
+ *
+ * Per-core load is sampled from the FreeRTOS tick hook of each core: a sample
+ * is busy when the interrupted task is not that core's idle task. At
+ * CONFIG_FREERTOS_HZ this is coarse, but it needs no run-time stats support
+ * and costs a few instructions per tick. The core 0 hook also stamps the time
+ * of each tick, which gives the LVGL task's wake-up lateness to the
+ * microsecond instead of to the tick.
+ */
+
+#include "task_layout.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_freertos_hooks.h"
+
+static const char *TAG = "task_layout";
+
+#if CONFIG_EXAMPLE_TASK_LAYOUT_PINNED
+#define NET_CORE    CONFIG_EXAMPLE_TASK_NET_CORE
+#define UI_CORE     (1 - CONFIG_EXAMPLE_TASK_NET_CORE)
+#else
+#define NET_CORE    tskNO_AFFINITY
+#define UI_CORE     tskNO_AFFINITY
+#endif
+
+static const task_layout_entry_t layout[TASK_ROLE_COUNT] = {
+    [TASK_ROLE_LVGL]        = {"LVGL", CONFIG_EXAMPLE_TASK_LVGL_STACK, CONFIG_EXAMPLE_TASK_LVGL_PRIORITY, UI_CORE},
+    [TASK_ROLE_TELEMETRY]   = {"telemetry", CONFIG_EXAMPLE_TASK_TELEMETRY_STACK, CONFIG_EXAMPLE_TASK_TELEMETRY_PRIORITY, UI_CORE},
+    [TASK_ROLE_HTTPD]       = {"httpd", CONFIG_EXAMPLE_TASK_HTTPD_STACK, CONFIG_EXAMPLE_TASK_HTTPD_PRIORITY, NET_CORE},
+    [TASK_ROLE_WS_PUSH]     = {"ws_push", CONFIG_EXAMPLE_TASK_WS_PUSH_STACK, CONFIG_EXAMPLE_TASK_WS_PUSH_PRIORITY, NET_CORE},
+    [TASK_ROLE_HTTP_WORKER] = {"http_worker", CONFIG_EXAMPLE_TASK_HTTP_WORKER_STACK, CONFIG_EXAMPLE_TASK_HTTP_WORKER_PRIORITY, NET_CORE},
+};
+
+/**
+ * @brief Counter values at the start of a measurement window
+ */
+typedef struct {
+    uint32_t samples[TASK_LAYOUT_CORES];
+    uint32_t busy[TASK_LAYOUT_CORES];
+    int64_t start_us;
+    uint32_t ui_late_max_us;
+} load_mark_t;
+
+// Written only by the tick hook of the matching core
+static volatile uint32_t tick_samples[TASK_LAYOUT_CORES];
+static volatile uint32_t tick_busy[TASK_LAYOUT_CORES];
+static TaskHandle_t idle_task[TASK_LAYOUT_CORES];
+static volatile int64_t last_tick_us = 0;   // Time of the last tick count increment (core 0)
+
+static portMUX_TYPE layout_lock = portMUX_INITIALIZER_UNLOCKED;
+static load_mark_t log_mark;
+static load_mark_t ota_mark;
+static bool ota_active = false;
+static bool ota_measured = false;
+static task_layout_window_t last_window;
+static task_layout_window_t last_ota;
+static uint32_t ui_late_max_us = 0;     // Since boot
+
+/**
+ * @brief Tick hook body - one load sample for a core (ISR context)
+ */
+static inline void task_layout_sample(int core)
+{
+    tick_samples[core]++;
+    if (xTaskGetCurrentTaskHandleForCore(core) != idle_task[core]) {
+        tick_busy[core]++;
+    }
+}
+
+static void task_layout_tick_core0(void)
+{
+    // The tick count is incremented on core 0, and that is what unblocks sleeping tasks
+    last_tick_us = esp_timer_get_time();
+    task_layout_sample(0);
+}
+
+static void task_layout_tick_core1(void)
+{
+    task_layout_sample(1);
+}
+
+/**
+ * @brief Start a measurement window at the current counter values (layout_lock held)
+ */
+static void task_layout_mark(load_mark_t *mark)
+{
+    for (int i = 0; i < TASK_LAYOUT_CORES; i++) {
+        mark->samples[i] = tick_samples[i];
+        mark->busy[i] = tick_busy[i];
+    }
+    mark->start_us = esp_timer_get_time();
+    mark->ui_late_max_us = 0;
+}
+
+/**
+ * @brief Load and UI timing since a mark (layout_lock held)
+ */
+static void task_layout_window_since(const load_mark_t *mark, task_layout_window_t *window)
+{
+    for (int i = 0; i < TASK_LAYOUT_CORES; i++) {
+        uint32_t samples = tick_samples[i] - mark->samples[i];
+        uint32_t busy = tick_busy[i] - mark->busy[i];
+        window->busy_pct[i] = samples > 0 ? (uint8_t)((busy * 100) / samples) : 0;
+        if (i == 0) {
+            window->samples = samples;
+        }
+    }
+    window->ui_late_max_us = mark->ui_late_max_us;
+    window->duration_ms = (uint32_t)((esp_timer_get_time() - mark->start_us) / 1000);
+}
+
+/**
+ * @brief Core name for logs
+ */
+static const char *task_layout_core_str(BaseType_t core)
+{
+    return core == 0 ? "core 0" : core == 1 ? "core 1" : "any core";
+}
+
+/**
+ * @brief Placement of a role
+ */
+const task_layout_entry_t *task_layout_get(task_role_t role)
+{
+    return role < TASK_ROLE_COUNT ? &layout[role] : &layout[TASK_ROLE_LVGL];
+}
+
+/**
+ * @brief Create the task of a role with its placement from the table
+ */
+esp_err_t task_layout_create(task_role_t role, TaskFunction_t fn, void *arg, TaskHandle_t *handle)
+{
+    if (role >= TASK_ROLE_COUNT || fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const task_layout_entry_t *entry = &layout[role];
+    if (xTaskCreatePinnedToCore(fn, entry->name, entry->stack_size, arg, entry->priority, handle, entry->core) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create %s task", entry->name);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Log the layout and start sampling per-core load
+ */
+esp_err_t task_layout_start(void)
+{
+    for (int i = 0; i < TASK_ROLE_COUNT; i++) {
+        ESP_LOGI(TAG, "%-10s %s, priority %u, %" PRIu32 " byte stack", layout[i].name,
+                 task_layout_core_str(layout[i].core), (unsigned)layout[i].priority, layout[i].stack_size);
+    }
+
+#if CONFIG_EXAMPLE_TASK_LAYOUT_PINNED
+    // Tasks ESP-IDF creates itself follow sdkconfig; point out the ones on the UI core
+#if CONFIG_ESP_WIFI_TASK_PINNED_TO_CORE_1
+    const int wifi_core = 1;
+#else
+    const int wifi_core = 0;
+#endif
+    if (wifi_core != NET_CORE) {
+        ESP_LOGW(TAG, "WiFi driver task runs on the UI core %d (ESP_WIFI_TASK_PINNED_TO_CORE_x)", wifi_core);
+    }
+#if CONFIG_ESP_TIMER_TASK_AFFINITY_CPU0 || CONFIG_ESP_TIMER_TASK_AFFINITY_CPU1
+    if (CONFIG_ESP_TIMER_TASK_AFFINITY != NET_CORE) {
+        ESP_LOGW(TAG, "esp_timer callbacks run on the UI core (ESP_TIMER_TASK_AFFINITY)");
+    }
+#endif
+#if CONFIG_LWIP_TCPIP_TASK_AFFINITY_NO_AFFINITY
+    ESP_LOGI(TAG, "lwIP tcpip task is not pinned (LWIP_TCPIP_TASK_AFFINITY), it may run on either core");
+#endif
+#endif
+
+    for (int i = 0; i < TASK_LAYOUT_CORES && i < portNUM_PROCESSORS; i++) {
+        idle_task[i] = xTaskGetIdleTaskHandleForCore(i);
+    }
+    taskENTER_CRITICAL(&layout_lock);
+    task_layout_mark(&log_mark);
+    taskEXIT_CRITICAL(&layout_lock);
+
+    esp_err_t ret = esp_register_freertos_tick_hook_for_cpu(task_layout_tick_core0, 0);
+    if (ret == ESP_OK && portNUM_PROCESSORS > 1) {
+        ret = esp_register_freertos_tick_hook_for_cpu(task_layout_tick_core1, 1);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register tick hooks: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+/**
+ * @brief Record how late the LVGL task ran after its sleep for a timer ended
+ */
+void task_layout_record_ui_wakeup(TickType_t due_tick)
+{
+    if (last_tick_us == 0) {
+        return;  // Tick hooks not running
+    }
+    TickType_t now_tick;
+    int64_t late;
+    do {
+        // Retry if a tick arrives between reading the count and its time stamp
+        now_tick = xTaskGetTickCount();
+        late = esp_timer_get_time() - last_tick_us;
+    } while (now_tick != xTaskGetTickCount());
+    late += (int64_t)(TickType_t)(now_tick - due_tick) * portTICK_PERIOD_MS * 1000;
+    if (late < 0) {
+        return;
+    }
+    uint32_t late_us = (uint32_t)late;
+
+    taskENTER_CRITICAL(&layout_lock);
+    if (late_us > log_mark.ui_late_max_us) {
+        log_mark.ui_late_max_us = late_us;
+    }
+    if (ota_active && late_us > ota_mark.ui_late_max_us) {
+        ota_mark.ui_late_max_us = late_us;
+    }
+    if (late_us > ui_late_max_us) {
+        ui_late_max_us = late_us;
+    }
+    taskEXIT_CRITICAL(&layout_lock);
+}
+
+/**
+ * @brief Load and UI timing since the previous call
+ */
+void task_layout_get_window(task_layout_window_t *window)
+{
+    if (window == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&layout_lock);
+    task_layout_window_since(&log_mark, window);
+    last_window = *window;
+    task_layout_mark(&log_mark);
+    taskEXIT_CRITICAL(&layout_lock);
+}
+
+/**
+ * @brief Mark the start of a firmware upload
+ */
+void task_layout_ota_begin(void)
+{
+    taskENTER_CRITICAL(&layout_lock);
+    task_layout_mark(&ota_mark);
+    ota_active = true;
+    taskEXIT_CRITICAL(&layout_lock);
+}
+
+/**
+ * @brief Mark the end of a firmware upload and log its load and UI timing
+ */
+void task_layout_ota_end(void)
+{
+    task_layout_window_t window;
+
+    taskENTER_CRITICAL(&layout_lock);
+    if (!ota_active) {
+        taskEXIT_CRITICAL(&layout_lock);
+        return;
+    }
+    task_layout_window_since(&ota_mark, &window);
+    last_ota = window;
+    ota_active = false;
+    ota_measured = true;
+    taskEXIT_CRITICAL(&layout_lock);
+
+    ESP_LOGI(TAG, "OTA upload: %" PRIu32 " ms, core 0 busy %u%%, core 1 busy %u%%, LVGL wake-up up to %" PRIu32 " us late",
+             window.duration_ms, window.busy_pct[0], window.busy_pct[1], window.ui_late_max_us);
+}
+
+/**
+ * @brief Write the layout, current load and last OTA window as JSON
+ */
+void task_layout_write_json(json_writer_t *writer)
+{
+    task_layout_window_t window;
+    task_layout_window_t ota;
+    bool active;
+    bool measured;
+    uint32_t late_max;
+
+    taskENTER_CRITICAL(&layout_lock);
+    window = last_window;
+    active = ota_active;
+    measured = ota_measured;
+    if (active) {
+        task_layout_window_since(&ota_mark, &ota);
+    } else {
+        ota = last_ota;
+    }
+    late_max = ui_late_max_us;
+    taskEXIT_CRITICAL(&layout_lock);
+
+    json_obj_begin(writer);
+    json_key(writer, "tasks");
+    json_arr_begin(writer);
+    for (int i = 0; i < TASK_ROLE_COUNT; i++) {
+        json_obj_begin(writer);
+        json_kv_str(writer, "name", layout[i].name);
+        json_kv_int(writer, "core", layout[i].core == tskNO_AFFINITY ? -1 : (int)layout[i].core);
+        json_kv_int(writer, "priority", layout[i].priority);
+        json_kv_int(writer, "stack", layout[i].stack_size);
+        json_obj_end(writer);
+    }
+    json_arr_end(writer);
+
+    json_key(writer, "load");
+    json_obj_begin(writer);
+    json_key(writer, "busy_pct");
+    json_arr_begin(writer);
+    json_int(writer, window.busy_pct[0]);
+    json_int(writer, window.busy_pct[1]);
+    json_arr_end(writer);
+    json_kv_int(writer, "window_ms", window.duration_ms);
+    json_kv_int(writer, "ui_late_max_us", window.ui_late_max_us);
+    json_obj_end(writer);
+    json_kv_int(writer, "ui_late_max_us", late_max);
+
+    json_key(writer, "ota");
+    json_obj_begin(writer);
+    json_kv_bool(writer, "active", active);
+    if (active || measured) {
+        json_key(writer, "busy_pct");
+        json_arr_begin(writer);
+        json_int(writer, ota.busy_pct[0]);
+        json_int(writer, ota.busy_pct[1]);
+        json_arr_end(writer);
+        json_kv_int(writer, "duration_ms", ota.duration_ms);
+        json_kv_int(writer, "ui_late_max_us", ota.ui_late_max_us);
+    }
+    json_obj_end(writer);
+    json_obj_end(writer);
+}
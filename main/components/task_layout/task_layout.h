@@ -0,0 +1,124 @@
+/*
+ * Task Layout Component Header
+ *
+ * One Kconfig-driven table of the application's tasks: core, priority and
+ * stack size per role. Networking and OTA run on one core, the UI and the
+ * realtime current sampling on the other, so a firmware upload does not
+ * compete with rendering. Also samples per-core load from the tick interrupt
+ * and tracks how late the LVGL task wakes, overall and during OTA uploads.
+ */
+
+#ifndef TASK_LAYOUT_H
+#define TASK_LAYOUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "json_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TASK_LAYOUT_CORES   2
+
+/**
+ * @brief Task roles placed by the layout
+ */
+typedef enum {
+    TASK_ROLE_LVGL = 0,     // LVGL timer handler and flush pipeline
+    TASK_ROLE_TELEMETRY,    // Current sampling of the relays
+    TASK_ROLE_HTTPD,        // HTTP server, including firmware uploads
+    TASK_ROLE_WS_PUSH,      // WebSocket relay state push
+    TASK_ROLE_HTTP_WORKER,  // Long HTTP requests: firmware uploads, screen captures
+    TASK_ROLE_COUNT
+} task_role_t;
+
+/**
+ * @brief Placement of one role
+ */
+typedef struct {
+    const char *name;       // Task name
+    uint32_t stack_size;    // Bytes
+    UBaseType_t priority;
+    BaseType_t core;        // Core ID, or tskNO_AFFINITY
+} task_layout_entry_t;
+
+/**
+ * @brief Load and UI timing over one window
+ */
+typedef struct {
+    uint8_t busy_pct[TASK_LAYOUT_CORES];    // Share of tick samples not in the idle task
+    uint32_t samples;                       // Tick samples per core in the window
+    uint32_t ui_late_max_us;                // Worst LVGL task wake-up lateness
+    uint32_t duration_ms;
+} task_layout_window_t;
+
+/**
+ * @brief Placement of a role
+ *
+ * @param role Task role
+ * @return const task_layout_entry_t* Table entry (never NULL for a valid role)
+ */
+const task_layout_entry_t *task_layout_get(task_role_t role);
+
+/**
+ * @brief Create the task of a role with its placement from the table
+ *
+ * @param role Task role
+ * @param fn Task function
+ * @param arg Task argument
+ * @param handle Output task handle (may be NULL)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the task could not be created
+ */
+esp_err_t task_layout_create(task_role_t role, TaskFunction_t fn, void *arg, TaskHandle_t *handle);
+
+/**
+ * @brief Log the layout and start sampling per-core load
+ *
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t task_layout_start(void);
+
+/**
+ * @brief Record how late the LVGL task ran after its sleep for a timer ended (LVGL task only)
+ *
+ * The lateness is measured from the tick interrupt that made the task ready, so it
+ * is the scheduling delay caused by other work on the core, not tick rounding.
+ *
+ * @param due_tick Tick count at which the sleep timed out
+ */
+void task_layout_record_ui_wakeup(TickType_t due_tick);
+
+/**
+ * @brief Load and UI timing since the previous call (for the periodic log)
+ *
+ * @param window Output structure
+ */
+void task_layout_get_window(task_layout_window_t *window);
+
+/**
+ * @brief Mark the start of a firmware upload
+ */
+void task_layout_ota_begin(void);
+
+/**
+ * @brief Mark the end of a firmware upload and log its load and UI timing (idempotent)
+ */
+void task_layout_ota_end(void);
+
+/**
+ * @brief Write the layout, current load and last OTA window as a JSON object
+ *
+ * @param writer Writer positioned where a value may go
+ */
+void task_layout_write_json(json_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_LAYOUT_H
@@ -0,0 +1,319 @@
+/*
+ * API Router Component
+ *
+ * The path is split into at most API_ROUTER_MAX_SEGMENTS (pointer, length)
+ * pairs pointing into req->uri, without copying. A route is rejected on its
+ * segment count before any string is compared, and literal segments are
+ * compared by length first, so a request costs a few integer compares per
+ * route instead of a full string match per registered URI.
+ *
+ * Also the JSON glue for the handlers: request bodies are received straight
+ * into a json_reader_t, and responses are written through a json_writer_t
+ * whose sink is httpd_resp_send_chunk(), so no handler needs the heap or a
+ * buffer sized for its largest response.
+ *
+ * Every dispatch lands in the stats slot of the route that took it. Error
+ * responses are noticed through api_send_error(), which flags the dispatch
+ * running on the calling task, so handlers need no bookkeeping of their own.
+ */
+
+#include "api_router.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "api_router";
+
+typedef struct {
+    const char *str;
+    size_t len;
+} api_segment_t;
+
+// Dispatch in progress; requests are dispatched by the server task only
+static TaskHandle_t volatile dispatch_task = NULL;
+static bool dispatch_error = false;
+
+/**
+ * @brief Split the path after the prefix into segments, stopping at a query string
+ *
+ * @return int Segment count, or -1 if there are too many or an empty one
+ */
+static int api_router_split(const char *path, api_segment_t *segments)
+{
+    int count = 0;
+    const char *p = path;
+    while (*p != '\0' && *p != '?' && *p != '#') {
+        if (count == API_ROUTER_MAX_SEGMENTS) {
+            return -1;
+        }
+        size_t len = strcspn(p, "/?#");
+        if (len == 0) {
+            return -1;  // "//" in the path
+        }
+        segments[count].str = p;
+        segments[count].len = len;
+        count++;
+        p += len;
+        if (*p == '/') {
+            p++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Parse a decimal path parameter
+ */
+static bool api_router_parse_int(const api_segment_t *segment, int *value)
+{
+    if (segment->len > 9) {
+        return false;  // Would not fit an int
+    }
+    int v = 0;
+    for (size_t i = 0; i < segment->len; i++) {
+        char c = segment->str[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        v = v * 10 + (c - '0');
+    }
+    *value = v;
+    return true;
+}
+
+/**
+ * @brief Match the request segments against one route's path
+ */
+static bool api_router_match(const api_route_t *route, const api_segment_t *segments, int count, api_params_t *params)
+{
+    int route_count = 0;
+    while (route_count < API_ROUTER_MAX_SEGMENTS && route->segments[route_count] != NULL) {
+        route_count++;
+    }
+    if (route_count != count) {
+        return false;
+    }
+
+    params->count = 0;
+    for (int i = 0; i < count; i++) {
+        const char *pattern = route->segments[i];
+        if (strcmp(pattern, API_ROUTER_PARAM_INT) == 0) {
+            if (params->count == API_ROUTER_MAX_PARAMS ||
+                !api_router_parse_int(&segments[i], &params->ints[params->count])) {
+                return false;
+            }
+            params->count++;
+        } else if (strlen(pattern) != segments[i].len || memcmp(pattern, segments[i].str, segments[i].len) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Find the route of a request and run it
+ *
+ * @param route Output: index of the route that ran, left alone if none did
+ */
+static esp_err_t api_router_route(httpd_req_t *req, const api_route_t *routes, size_t count, size_t *route)
+{
+    const size_t prefix_len = strlen(API_ROUTER_PREFIX);
+    if (strncmp(req->uri, API_ROUTER_PREFIX, prefix_len) != 0) {
+        return api_send_error(req, "404 Not Found", "Unknown API path");
+    }
+
+    api_segment_t segments[API_ROUTER_MAX_SEGMENTS];
+    int segment_count = api_router_split(req->uri + prefix_len, segments);
+    if (segment_count <= 0) {
+        return api_send_error(req, "404 Not Found", "Unknown API path");
+    }
+
+    bool path_matched = false;
+    for (size_t i = 0; i < count; i++) {
+        api_params_t params;
+        if (!api_router_match(&routes[i], segments, segment_count, &params)) {
+            continue;
+        }
+        if (routes[i].method != req->method) {
+            path_matched = true;
+            continue;
+        }
+        *route = i;
+        return routes[i].handler(req, &params);
+    }
+
+    ESP_LOGD(TAG, "No route for %s %s", http_method_str(req->method), req->uri);
+    if (path_matched) {
+        return api_send_error(req, "405 Method Not Allowed", "Method not allowed");
+    }
+    return api_send_error(req, "404 Not Found", "Unknown API path");
+}
+
+/**
+ * @brief Route a request to the matching handler of a table
+ */
+esp_err_t api_router_dispatch(httpd_req_t *req, const api_route_t *routes, api_route_stats_t *stats, size_t count)
+{
+    int64_t start_us = esp_timer_get_time();
+    size_t route = count;
+    dispatch_error = false;
+    dispatch_task = xTaskGetCurrentTaskHandle();
+    esp_err_t ret = api_router_route(req, routes, count, &route);
+    dispatch_task = NULL;
+
+    metrics_histogram_observe(&stats[route].latency, (uint32_t)(esp_timer_get_time() - start_us));
+    if (ret != ESP_OK || dispatch_error) {
+        metrics_counter_inc(&stats[route].errors);
+    }
+    return ret;
+}
+
+/**
+ * @brief Label of a stats slot: method and path, parameters as "{n}"
+ */
+static void api_router_route_label(const api_route_t *routes, size_t count, size_t index, char *label, size_t size)
+{
+    if (index == count) {
+        snprintf(label, size, "route=\"unmatched\"");
+        return;
+    }
+    const api_route_t *route = &routes[index];
+    int len = snprintf(label, size, "route=\"%s %s", http_method_str(route->method), API_ROUTER_PREFIX);
+    for (int i = 0; i < API_ROUTER_MAX_SEGMENTS && route->segments[i] != NULL && len > 0 && (size_t)len < size; i++) {
+        const char *segment = route->segments[i];
+        len += snprintf(label + len, size - len, "%s%s", i > 0 ? "/" : "",
+                        strcmp(segment, API_ROUTER_PARAM_INT) == 0 ? "{n}" : segment);
+    }
+    if (len > 0 && (size_t)len < size) {
+        snprintf(label + len, size - len, "\"");
+    }
+}
+
+/**
+ * @brief Write the request count, error count and latency families of a route table
+ */
+void api_router_write_metrics(metrics_writer_t *writer, const api_route_t *routes,
+                              const api_route_stats_t *stats, size_t count)
+{
+    char label[80];
+
+    metrics_write_family(writer, "smartsocket_http_requests_total", "counter", "API requests per route.");
+    for (size_t i = 0; i <= count; i++) {
+        api_router_route_label(routes, count, i, label, sizeof(label));
+        metrics_write_int(writer, "smartsocket_http_requests_total", label, metrics_histogram_count(&stats[i].latency));
+    }
+
+    metrics_write_family(writer, "smartsocket_http_request_errors_total", "counter",
+                         "API requests per route that failed or got an error response.");
+    for (size_t i = 0; i <= count; i++) {
+        api_router_route_label(routes, count, i, label, sizeof(label));
+        metrics_write_int(writer, "smartsocket_http_request_errors_total", label, metrics_counter_read(&stats[i].errors));
+    }
+
+    metrics_write_family(writer, "smartsocket_http_request_duration_seconds", "histogram",
+                         "API request time on the server task, routing to the handler's return.");
+    for (size_t i = 0; i <= count; i++) {
+        api_router_route_label(routes, count, i, label, sizeof(label));
+        metrics_write_histogram(writer, "smartsocket_http_request_duration_seconds", label, &stats[i].latency);
+    }
+}
+
+/**
+ * @brief Send a JSON error response
+ */
+esp_err_t api_send_error(httpd_req_t *req, const char *status, const char *error)
+{
+    if (dispatch_task == xTaskGetCurrentTaskHandle()) {
+        dispatch_error = true;
+    }
+    char buf[96];
+    json_writer_t writer;
+    httpd_resp_set_status(req, status);
+    api_json_begin(req, &writer, buf, sizeof(buf));
+    json_obj_begin(&writer);
+    json_kv_bool(&writer, "success", false);
+    json_kv_str(&writer, "error", error);
+    json_obj_end(&writer);
+    return api_json_end(&writer);
+}
+
+/**
+ * @brief Read a JSON request body into a reader, receive by receive
+ */
+esp_err_t api_read_json(httpd_req_t *req, json_reader_t *reader)
+{
+    json_reader_init(reader);
+    if (req->content_len == 0) {
+        api_send_error(req, "400 Bad Request", "No data received");
+        return ESP_FAIL;
+    }
+    if (req->content_len > JSON_READER_MAX_INPUT) {
+        // The server drains the unread body before the next request
+        api_send_error(req, "413 Payload Too Large", "Body too large");
+        return ESP_FAIL;
+    }
+
+    // Received straight into the reader, which tokenizes each piece as it arrives.
+    // The whole body is fed: whitespace after the closing bracket may come in a later receive.
+    size_t remaining = req->content_len;
+    json_status_t status = JSON_PARTIAL;
+    while (remaining > 0 && (status == JSON_PARTIAL || status == JSON_OK)) {
+        size_t room;
+        char *tail = json_reader_tail(reader, &room);
+        int ret = httpd_req_recv(req, tail, remaining < room ? remaining : room);
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+            continue;
+        }
+        if (ret <= 0) {
+            api_send_error(req, "400 Bad Request", "No data received");
+            return ESP_FAIL;
+        }
+        remaining -= ret;
+        status = json_reader_advance(reader, ret);
+    }
+    if (status != JSON_OK) {
+        ESP_LOGD(TAG, "Rejected body of %s (reader status %d)", req->uri, status);
+        api_send_error(req, "400 Bad Request", "Invalid JSON");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Writer sink - one HTTP chunk per full buffer
+ */
+static bool api_json_sink(void *ctx, const char *data, size_t len)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, len) == ESP_OK;
+}
+
+/**
+ * @brief Start a JSON response whose writer streams into httpd_resp_send_chunk()
+ */
+void api_json_begin(httpd_req_t *req, json_writer_t *writer, char *buf, size_t size)
+{
+    httpd_resp_set_type(req, "application/json");
+    json_writer_init(writer, buf, size, api_json_sink, req);
+}
+
+/**
+ * @brief Finish a JSON response
+ */
+esp_err_t api_json_end(json_writer_t *writer)
+{
+    httpd_req_t *req = (httpd_req_t *)writer->ctx;
+    if (writer->failed) {
+        return ESP_FAIL;  // Headers may be out already, only closing the connection is left
+    }
+    if (!writer->flushed) {
+        return httpd_resp_send(req, writer->buf, writer->len);
+    }
+    if (!json_writer_flush(writer)) {
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
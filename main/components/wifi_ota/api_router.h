@@ -0,0 +1,147 @@
+/*
+ * API Router Component Header
+ *
+ * Dispatches every /api/ request from one wildcard URI handler through a
+ * route table. The request path is split into segments once, numeric path
+ * parameters are parsed while matching, and the handler receives them typed,
+ * so one route serves any number of relays. Each dispatch is counted and
+ * timed per route for the /metrics endpoint.
+ */
+
+#ifndef API_ROUTER_H
+#define API_ROUTER_H
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include "json_stream.h"
+#include "metrics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define API_ROUTER_PREFIX        "/api/"
+#define API_ROUTER_MAX_SEGMENTS  4      // Path segments after the prefix
+#define API_ROUTER_MAX_PARAMS    2
+#define API_ROUTER_PARAM_INT     "#"    // Route segment matching a non-negative decimal number
+#define API_JSON_BUF_SIZE        512    // Responses up to this size go out in one send with Content-Length
+
+/**
+ * @brief Path parameters of a matched route, in path order
+ */
+typedef struct {
+    int count;
+    int ints[API_ROUTER_MAX_PARAMS];
+} api_params_t;
+
+/**
+ * @brief Route handler
+ *
+ * @param req Request
+ * @param params Parameters parsed from the path
+ * @return esp_err_t As for an httpd URI handler
+ */
+typedef esp_err_t (*api_handler_t)(httpd_req_t *req, const api_params_t *params);
+
+/**
+ * @brief One route: method and path segments after API_ROUTER_PREFIX
+ *
+ * e.g. { HTTP_GET, { "relay", API_ROUTER_PARAM_INT, "telemetry" }, handler }
+ * matches GET /api/relay/3/telemetry with params->ints[0] == 3.
+ */
+typedef struct {
+    httpd_method_t method;
+    const char *segments[API_ROUTER_MAX_SEGMENTS];  // Unused trailing entries are NULL
+    api_handler_t handler;
+} api_route_t;
+
+/**
+ * @brief Request statistics of one route (lock-free, see metrics.h)
+ */
+typedef struct {
+    metrics_histogram_t latency;    // Routing to the handler's return
+    metrics_counter_t errors;       // Handler failed or answered with api_send_error()
+} api_route_stats_t;
+
+/**
+ * @brief Route a request to the matching handler of a table
+ *
+ * Sends 404 when no route matches the path and 405 when routes match the
+ * path but not the method. A handler that hands the request to an HTTP
+ * worker is timed up to the hand-off.
+ *
+ * @param req Request whose URI starts with API_ROUTER_PREFIX
+ * @param routes Route table
+ * @param stats count + 1 entries, one per route and a last one for requests no route took
+ * @param count Number of routes
+ * @return esp_err_t Result of the handler, or of the error response
+ */
+esp_err_t api_router_dispatch(httpd_req_t *req, const api_route_t *routes, api_route_stats_t *stats, size_t count);
+
+/**
+ * @brief Write the request count, error count and latency families of a route table
+ *
+ * Routes are labelled with their method and path, numeric parameters as
+ * "{n}", e.g. route="GET /api/relay/{n}"; requests no route took are
+ * labelled route="unmatched".
+ *
+ * @param writer Writer
+ * @param routes Route table
+ * @param stats Statistics given to api_router_dispatch()
+ * @param count Number of routes
+ */
+void api_router_write_metrics(metrics_writer_t *writer, const api_route_t *routes,
+                              const api_route_stats_t *stats, size_t count);
+
+/**
+ * @brief Send a JSON error response: {"success":false,"error":"..."}
+ *
+ * @param req Request
+ * @param status HTTP status line, e.g. "400 Bad Request"
+ * @param error Message
+ * @return esp_err_t Result of sending the response
+ */
+esp_err_t api_send_error(httpd_req_t *req, const char *status, const char *error);
+
+/**
+ * @brief Read a JSON request body into a reader, receive by receive
+ *
+ * Answers 400 (no body, or not a JSON object or array) or 413 (longer than
+ * JSON_READER_MAX_INPUT) itself.
+ *
+ * @param req Request
+ * @param reader Reader, initialized here
+ * @return esp_err_t ESP_OK with a complete document, ESP_FAIL if an error response was sent
+ */
+esp_err_t api_read_json(httpd_req_t *req, json_reader_t *reader);
+
+/**
+ * @brief Start a JSON response whose writer streams into httpd_resp_send_chunk()
+ *
+ * Set the status and any headers first. Nothing is sent until buf fills up or
+ * api_json_end() is called.
+ *
+ * @param req Request
+ * @param writer Writer to initialize
+ * @param buf Format buffer, usually API_JSON_BUF_SIZE bytes on the handler's stack
+ * @param size Size of buf
+ */
+void api_json_begin(httpd_req_t *req, json_writer_t *writer, char *buf, size_t size);
+
+/**
+ * @brief Finish a JSON response
+ *
+ * A response that fit the buffer is sent in one piece with Content-Length,
+ * a longer one ends its chunked transfer.
+ *
+ * @param writer Writer from api_json_begin()
+ * @return esp_err_t ESP_OK, or ESP_FAIL if sending failed (the connection is then closed)
+ */
+esp_err_t api_json_end(json_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // API_ROUTER_H
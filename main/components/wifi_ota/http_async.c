@@ -0,0 +1,104 @@
+/*
+ * HTTP Async Component
+ *
+ * A request is only accepted while a worker is idle. Queued requests would
+ * each hold one of the server's seven sockets for as long as an upload takes,
+ * and a client is better served by a 503 it can retry. The workers run below
+ * the server task's priority on the same core, so the server preempts an
+ * upload to answer short requests.
+ */
+
+#include "http_async.h"
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "task_layout.h"
+
+static const char *TAG = "http_async";
+
+typedef struct {
+    httpd_req_t *req;               // Detached copy
+    http_async_handler_t handler;
+} http_async_job_t;
+
+static QueueHandle_t job_queue = NULL;
+static SemaphoreHandle_t idle_workers = NULL;
+
+static void http_async_worker(void *arg)
+{
+    (void)arg;
+    http_async_job_t job;
+    while (1) {
+        if (xQueueReceive(job_queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        int64_t start_us = esp_timer_get_time();
+        esp_err_t ret = job.handler(job.req);
+        ESP_LOGD(TAG, "%s done in %" PRId64 " ms", job.req->uri, (esp_timer_get_time() - start_us) / 1000);
+        if (ret != ESP_OK) {
+            // What a synchronous handler's error return does
+            httpd_sess_trigger_close(job.req->handle, httpd_req_to_sockfd(job.req));
+        }
+        httpd_req_async_handler_complete(job.req);
+        xSemaphoreGive(idle_workers);
+    }
+}
+
+/**
+ * @brief Start the worker tasks (idempotent)
+ */
+esp_err_t http_async_start(void)
+{
+    if (idle_workers != NULL) {
+        return ESP_OK;
+    }
+    QueueHandle_t queue = xQueueCreate(HTTP_ASYNC_WORKERS, sizeof(http_async_job_t));
+    if (queue == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    job_queue = queue;  // Before the workers start taking from it
+
+    int started = 0;
+    while (started < HTTP_ASYNC_WORKERS &&
+           task_layout_create(TASK_ROLE_HTTP_WORKER, http_async_worker, NULL, NULL) == ESP_OK) {
+        started++;
+    }
+    // Only workers that exist may be counted as idle
+    idle_workers = started > 0 ? xSemaphoreCreateCounting(started, started) : NULL;
+    if (idle_workers == NULL) {
+        ESP_LOGE(TAG, "No HTTP workers");
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "%d HTTP workers for long requests", started);
+    return ESP_OK;
+}
+
+/**
+ * @brief Hand a request to an idle worker, from the server task
+ */
+esp_err_t http_async_submit(httpd_req_t *req, http_async_handler_t handler)
+{
+    if (idle_workers == NULL) {
+        // No workers (start failed); the server task's stack is too small to run these in place
+        ESP_LOGW(TAG, "No HTTP workers for %s", req->uri);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xSemaphoreTake(idle_workers, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "No idle worker for %s", req->uri);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    http_async_job_t job = { .handler = handler };
+    esp_err_t ret = httpd_req_async_handler_begin(req, &job.req);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Could not detach %s: %s", req->uri, esp_err_to_name(ret));
+        xSemaphoreGive(idle_workers);
+        return ESP_ERR_INVALID_STATE;
+    }
+    // A worker is idle, so the queue has room
+    xQueueSend(job_queue, &job, 0);
+    return ESP_OK;
+}
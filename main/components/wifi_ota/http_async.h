@@ -0,0 +1,56 @@
+/*
+ * HTTP Async Component Header
+ *
+ * Runs long requests (firmware uploads, screen captures) on worker tasks
+ * instead of the HTTP server task, so short API calls and page loads are
+ * answered while they are in progress.
+ */
+
+#ifndef HTTP_ASYNC_H
+#define HTTP_ASYNC_H
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_ASYNC_WORKERS  CONFIG_EXAMPLE_HTTP_WORKERS
+
+/**
+ * @brief Request handler run on a worker task
+ *
+ * @param req Detached copy of the request; it is completed after the handler returns
+ * @return esp_err_t Anything but ESP_OK closes the connection
+ */
+typedef esp_err_t (*http_async_handler_t)(httpd_req_t *req);
+
+/**
+ * @brief Start the worker tasks (idempotent)
+ *
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t http_async_start(void);
+
+/**
+ * @brief Hand a request to an idle worker, from the server task
+ *
+ * The request is detached with httpd_req_async_handler_begin(); its socket
+ * stays open until the handler has run. Nothing is sent when no worker is
+ * idle, so the caller can answer 503 itself. Without workers (start failed)
+ * every request is refused the same way: the handlers need the worker stack
+ * and must not run on the server task.
+ *
+ * @param req Request of the calling URI handler
+ * @param handler Handler to run on the worker
+ * @return esp_err_t ESP_OK if handed off, ESP_ERR_INVALID_STATE if every worker
+ *         is busy or none could be started
+ */
+esp_err_t http_async_submit(httpd_req_t *req, http_async_handler_t handler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_ASYNC_H
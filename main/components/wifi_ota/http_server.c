@@ -9,260 +9,262 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <inttypes.h>
 #include <sys/stat.h>
 #include <dirent.h>
 #include "esp_log.h"
 #include "esp_http_server.h"
 #include "esp_ota_ops.h"
 #include "esp_partition.h"
-#include "esp_vfs.h"
-#include "esp_spiffs.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "relay_control_ui.h"
+#include "relay_telemetry.h"
+#include "ui_metrics.h"
+#include "screen_capture.h"
+#include "task_layout.h"
+#include "web_assets.h"
+#include "api_router.h"
+#include "json_stream.h"
+#include "esp_app_desc.h"
+#include "esp_timer.h"
+#include "http_async.h"
+#include "metrics.h"
+#include "wifi_ota.h"
+#if CONFIG_EXAMPLE_WS_PUSH
+#include "ws_push.h"
+#endif
 
 // Forward declaration
 extern relay_control_ui_t *example_lvgl_get_relay_ui(int index);
 
 static const char *TAG = "http_server";
 
+#define HTTP_API_MAX_RELAYS       6     // Relay IDs 1..6 as returned by example_lvgl_get_relay_ui()
+#define HTTP_OTA_REBOOT_DELAY_MS  1000  // Between answering a successful upload and rebooting
+#define HTTP_METRICS_BUF_SIZE     512   // Chunk size of the /metrics exposition
+
+/**
+ * @brief Outcome of a firmware upload, as counted for /metrics
+ */
+typedef enum {
+    HTTP_OTA_RESULT_SUCCESS = 0,    // Image written and set as boot partition
+    HTTP_OTA_RESULT_INVALID_IMAGE,  // Image failed validation
+    HTTP_OTA_RESULT_FAILED,         // Receive, flash or partition error
+    HTTP_OTA_RESULT_CONFLICT,       // Another upload was running (409)
+    HTTP_OTA_RESULT_BUSY,           // No free HTTP worker (503)
+    HTTP_OTA_RESULT_COUNT
+} http_ota_result_t;
+
+static const char *const ota_result_names[HTTP_OTA_RESULT_COUNT] = {
+    [HTTP_OTA_RESULT_SUCCESS]       = "success",
+    [HTTP_OTA_RESULT_INVALID_IMAGE] = "invalid_image",
+    [HTTP_OTA_RESULT_FAILED]        = "failed",
+    [HTTP_OTA_RESULT_CONFLICT]      = "conflict",
+    [HTTP_OTA_RESULT_BUSY]          = "busy",
+};
+
 static httpd_handle_t server_handle = NULL;
 static bool server_running = false;
+static bool ota_running = false;        // A firmware upload is being received (atomic)
+static metrics_counter_t ota_results[HTTP_OTA_RESULT_COUNT];
 
 /**
- * @brief Initialize SPIFFS filesystem
+ * @brief Handler for root path - serves index.html from the web assets
  */
-esp_err_t http_server_init_spiffs(void)
+static esp_err_t control_page_handler(httpd_req_t *req)
 {
-    esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs",
-        .partition_label = NULL,
-        .max_files = 5,
-        .format_if_mount_failed = true
-    };
-    
-    esp_err_t ret = esp_vfs_spiffs_register(&conf);
-    if (ret != ESP_OK) {
-        if (ret == ESP_FAIL) {
-            ESP_LOGE(TAG, "Failed to mount or format filesystem");
-        } else if (ret == ESP_ERR_NOT_FOUND) {
-            ESP_LOGE(TAG, "Failed to find SPIFFS partition");
-        } else {
-            ESP_LOGE(TAG, "Failed to initialize SPIFFS (%s)", esp_err_to_name(ret));
-        }
-        return ret;
-    }
-    
-    size_t total = 0, used = 0;
-    ret = esp_spiffs_info(NULL, &total, &used);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get SPIFFS partition information (%s)", esp_err_to_name(ret));
-    } else {
-        ESP_LOGI(TAG, "Partition size: total: %d, used: %d", total, used);
-    }
-    
-    return ESP_OK;
+    return web_assets_send(req, "/index.html");
+}
+
+/**
+ * @brief Handler for firmware update page - serves index.html from the web assets
+ */
+static esp_err_t update_page_handler(httpd_req_t *req)
+{
+    return web_assets_send(req, "/index.html");
 }
 
+// Removed embedded HTML - now served from the packed asset image (web_assets.c)
+
 /**
- * @brief Get content type from file extension
+ * @brief Resolve the relay of a /api/relay/<id> route, answering 400 or 503 itself
+ * 
+ * @return relay_control_ui_t* Relay, or NULL if an error response was sent
  */
-static const char* get_content_type(const char *filename)
+static relay_control_ui_t *api_get_relay(httpd_req_t *req, const api_params_t *params)
 {
-    const char *ext = strrchr(filename, '.');
-    if (ext == NULL) {
-        return "application/octet-stream";
+    int relay_id = params->ints[0];
+    if (relay_id < 1 || relay_id > HTTP_API_MAX_RELAYS) {
+        api_send_error(req, "400 Bad Request", "Invalid relay ID");
+        return NULL;
     }
     
-    if (strcmp(ext, ".html") == 0 || strcmp(ext, ".htm") == 0) {
-        return "text/html";
-    } else if (strcmp(ext, ".css") == 0) {
-        return "text/css";
-    } else if (strcmp(ext, ".js") == 0) {
-        return "application/javascript";
-    } else if (strcmp(ext, ".json") == 0) {
-        return "application/json";
-    } else if (strcmp(ext, ".png") == 0) {
-        return "image/png";
-    } else if (strcmp(ext, ".jpg") == 0 || strcmp(ext, ".jpeg") == 0) {
-        return "image/jpeg";
-    } else if (strcmp(ext, ".gif") == 0) {
-        return "image/gif";
-    } else if (strcmp(ext, ".svg") == 0) {
-        return "image/svg+xml";
-    } else if (strcmp(ext, ".ico") == 0) {
-        return "image/x-icon";
+    relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(relay_id);
+    if (relay_ui == NULL) {
+        ESP_LOGW(TAG, "Relay UI %d not found (may not be initialized yet)", relay_id);
+        api_send_error(req, "503 Service Unavailable", "Relay not initialized");
     }
-    return "application/octet-stream";
+    return relay_ui;
 }
 
 /**
- * @brief Handler for serving static files from SPIFFS
+ * @brief Read the requested relay state from a JSON body ({"state":true|false})
+ * 
+ * @param req Request
+ * @param state Output: requested state
+ * @param has_state Output: false if the body names no state
+ * @return esp_err_t ESP_OK, or ESP_FAIL after answering 400 for a missing or malformed body
  */
-static esp_err_t file_handler(httpd_req_t *req)
+static esp_err_t api_read_state(httpd_req_t *req, bool *state, bool *has_state)
 {
-    char filepath[256];
-    
-    // Map root to index.html
-    if (strcmp(req->uri, "/") == 0) {
-        strcpy(filepath, "/spiffs/index.html");
-    } else {
-        // Check URI length to prevent buffer overflow
-        size_t uri_len = strlen(req->uri);
-        if (uri_len > sizeof(filepath) - 8) {  // 8 = "/spiffs" + null terminator
-            ESP_LOGE(TAG, "URI too long: %s", req->uri);
-            httpd_resp_set_status(req, "414 URI Too Long");
-            httpd_resp_send(req, "URI too long", HTTPD_RESP_USE_STRLEN);
-            return ESP_FAIL;
-        }
-        // Suppress format-truncation warning - we've already checked the length
-        #pragma GCC diagnostic push
-        #pragma GCC diagnostic ignored "-Wformat-truncation"
-        snprintf(filepath, sizeof(filepath), "/spiffs%s", req->uri);
-        #pragma GCC diagnostic pop
+    json_reader_t reader;
+    if (api_read_json(req, &reader) != ESP_OK) {
+        return ESP_FAIL;
     }
-    
-    FILE *fd = fopen(filepath, "r");
-    if (fd == NULL) {
-        ESP_LOGE(TAG, "Failed to open file: %s", filepath);
-        httpd_resp_set_status(req, "404 Not Found");
-        httpd_resp_send(req, "File not found", HTTPD_RESP_USE_STRLEN);
+    // An array root is valid JSON but not a state request; don't read it as "no state"
+    if (reader.tokens[0].type != JSON_TYPE_OBJECT) {
+        api_send_error(req, "400 Bad Request", "Expected a JSON object");
         return ESP_FAIL;
     }
     
-    // Set content type
-    const char *content_type = get_content_type(filepath);
-    httpd_resp_set_type(req, content_type);
-    
-    // Send file content
-    char chunk[1024];
-    size_t read_bytes;
-    do {
-        read_bytes = fread(chunk, 1, sizeof(chunk), fd);
-        if (read_bytes > 0) {
-            if (httpd_resp_send_chunk(req, chunk, read_bytes) != ESP_OK) {
-                fclose(fd);
-                ESP_LOGE(TAG, "File sending failed");
-                return ESP_FAIL;
-            }
-        }
-    } while (read_bytes > 0);
-    
-    fclose(fd);
-    httpd_resp_send_chunk(req, NULL, 0);
-    ESP_LOGI(TAG, "File sent: %s", filepath);
+    int token = json_reader_find(&reader, 0, "state");
+    *has_state = token >= 0;
+    if (*has_state && !json_reader_get_bool(&reader, token, state)) {
+        api_send_error(req, "400 Bad Request", "Invalid state");
+        return ESP_FAIL;
+    }
     return ESP_OK;
 }
 
 /**
- * @brief Handler for root path - serves index.html from SPIFFS
+ * @brief Write {"success":true,"id":<id>,"state":<state>}
  */
-static esp_err_t control_page_handler(httpd_req_t *req)
+static esp_err_t api_send_relay_state(httpd_req_t *req, int relay_id, bool state)
 {
-    return file_handler(req);
+    char buf[API_JSON_BUF_SIZE];
+    json_writer_t w;
+    api_json_begin(req, &w, buf, sizeof(buf));
+    json_obj_begin(&w);
+    json_kv_bool(&w, "success", true);
+    json_kv_int(&w, "id", relay_id);
+    json_kv_bool(&w, "state", state);
+    json_obj_end(&w);
+    return api_json_end(&w);
 }
 
 /**
- * @brief Handler for firmware update page - serves index.html from SPIFFS
+ * @brief Handler for getting relay status (GET /api/relay/<id>)
  */
-static esp_err_t update_page_handler(httpd_req_t *req)
+static esp_err_t relay_get_handler(httpd_req_t *req, const api_params_t *params)
 {
-    return file_handler(req);
+    relay_control_ui_t *relay_ui = api_get_relay(req, params);
+    if (relay_ui == NULL) {
+        return ESP_OK;
+    }
+    
+    return api_send_relay_state(req, params->ints[0], relay_control_ui_get_state(relay_ui));
 }
 
-// Removed embedded HTML - now using SPIFFS
+/**
+ * @brief Handler for the status of all relays in one response (GET /api/relays)
+ * 
+ * Replaces six GET /api/relay/<id> polls per dashboard refresh. "version" only
+ * changes when a relay switches or a countdown starts or stops, so clients can
+ * skip re-rendering the states; "remaining" is in seconds and "current_ca" in
+ * hundredths of an Ampere.
+ */
+static esp_err_t relays_get_handler(httpd_req_t *req, const api_params_t *params)
+{
+    (void)params;
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    if (example_lvgl_get_relay_ui(1) == NULL) {
+        return api_send_error(req, "503 Service Unavailable", "Relays not initialized");
+    }
 
-// Old handlers removed - now using file_handler from SPIFFS
+    char buf[API_JSON_BUF_SIZE];
+    json_writer_t w;
+    api_json_begin(req, &w, buf, sizeof(buf));
+    json_obj_begin(&w);
+    json_kv_bool(&w, "success", true);
+    json_kv_int(&w, "version", relay_control_ui_get_state_version());
+    json_key(&w, "relays");
+    json_arr_begin(&w);
+    for (int id = 1; id <= HTTP_API_MAX_RELAYS; id++) {
+        relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(id);
+        if (relay_ui == NULL) {
+            continue;  // Not initialized yet
+        }
+        json_obj_begin(&w);
+        json_kv_int(&w, "id", id);
+        json_kv_bool(&w, "state", relay_control_ui_get_state(relay_ui));
+        json_kv_int(&w, "remaining", relay_control_ui_get_time_remaining(relay_ui));
+        json_kv_int(&w, "current_ca", relay_telemetry_get_current_ca(relay_ui->telemetry_channel));
+        json_obj_end(&w);
+    }
+    json_arr_end(&w);
+    json_obj_end(&w);
+    return api_json_end(&w);
+}
 
 /**
- * @brief Handler for getting relay status (GET /api/relay/<id>)
+ * @brief Handler for switching all relays at once (POST /api/relays), like the master button
+ * 
+ * Does not touch LVGL, so it needs no LVGL lock.
  */
-static esp_err_t relay_get_handler(httpd_req_t *req)
+static esp_err_t relays_post_handler(httpd_req_t *req, const api_params_t *params)
 {
-    // Extract relay ID from URI (format: /api/relay/1)
-    const char *uri = req->uri;
-    const char *id_start = strrchr(uri, '/');
-    if (id_start == NULL) {
-        httpd_resp_set_status(req, "400 Bad Request");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"success\":false,\"error\":\"Invalid URI\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_FAIL;
+    (void)params;
+    bool new_state = false;
+    bool has_state = false;
+    if (api_read_state(req, &new_state, &has_state) != ESP_OK) {
+        return ESP_OK;
     }
-    
-    id_start++; // Skip '/'
-    int relay_id = atoi(id_start);
-    if (relay_id < 1 || relay_id > 6) {
-        httpd_resp_set_status(req, "400 Bad Request");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"success\":false,\"error\":\"Invalid relay ID\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_FAIL;
+    if (!has_state) {
+        return api_send_error(req, "400 Bad Request", "Missing state");
     }
-    
-    relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(relay_id);
-    if (relay_ui == NULL) {
-        ESP_LOGW(TAG, "Relay UI %d not found (may not be initialized yet)", relay_id);
-        httpd_resp_set_status(req, "503 Service Unavailable");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"success\":false,\"error\":\"Relay not initialized\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;  // Return OK to avoid error logging, but indicate service unavailable
+
+    // Runs on the httpd task: set_state() only switches the hardware and flags the tiles;
+    // they and the master button are restyled once, later, on the LVGL task
+    int switched = 0;
+    for (int id = 1; id <= HTTP_API_MAX_RELAYS; id++) {
+        relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(id);
+        if (relay_ui != NULL) {
+            relay_control_ui_set_state(relay_ui, new_state);
+            switched++;
+        }
     }
-    
-    bool state = relay_control_ui_get_state(relay_ui);
-    char response[128];
-    snprintf(response, sizeof(response), "{\"success\":true,\"id\":%d,\"state\":%s}", relay_id, state ? "true" : "false");
-    
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, response, HTTPD_RESP_USE_STRLEN);
-    return ESP_OK;
+    if (switched == 0) {
+        return api_send_error(req, "503 Service Unavailable", "Relays not initialized");
+    }
+
+    char buf[API_JSON_BUF_SIZE];
+    json_writer_t w;
+    api_json_begin(req, &w, buf, sizeof(buf));
+    json_obj_begin(&w);
+    json_kv_bool(&w, "success", true);
+    json_kv_bool(&w, "state", new_state);
+    json_kv_int(&w, "count", switched);
+    json_obj_end(&w);
+    return api_json_end(&w);
 }
 
 /**
  * @brief Handler for setting relay state (POST /api/relay/<id>)
  */
-static esp_err_t relay_post_handler(httpd_req_t *req)
+static esp_err_t relay_post_handler(httpd_req_t *req, const api_params_t *params)
 {
-    char relay_id_str[8] = {0};
-    const char *uri = req->uri;
-    const char *id_start = strrchr(uri, '/');
-    if (id_start != NULL) {
-        id_start++; // Skip '/'
-        strncpy(relay_id_str, id_start, sizeof(relay_id_str) - 1);
-    }
-    
-    int relay_id = atoi(relay_id_str);
-    if (relay_id < 1 || relay_id > 6) {
-        httpd_resp_set_status(req, "400 Bad Request");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"success\":false,\"error\":\"Invalid relay ID\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_FAIL;
-    }
-    
-    relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(relay_id);
+    relay_control_ui_t *relay_ui = api_get_relay(req, params);
     if (relay_ui == NULL) {
-        ESP_LOGW(TAG, "Relay UI %d not found (may not be initialized yet)", relay_id);
-        httpd_resp_set_status(req, "503 Service Unavailable");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"success\":false,\"error\":\"Relay not initialized\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;  // Return OK to avoid error logging, but indicate service unavailable
-    }
-    
-    // Read JSON body
-    char content[128] = {0};
-    int ret = httpd_req_recv(req, content, sizeof(content) - 1);
-    if (ret <= 0) {
-        httpd_resp_set_status(req, "400 Bad Request");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"success\":false,\"error\":\"No data received\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_FAIL;
+        return ESP_OK;
     }
     
-    // Parse JSON (simple parsing for "state":true/false)
     bool new_state = false;
-    if (strstr(content, "\"state\":true") != NULL || strstr(content, "'state':true") != NULL) {
-        new_state = true;
-    } else if (strstr(content, "\"state\":false") != NULL || strstr(content, "'state':false") != NULL) {
-        new_state = false;
-    } else {
+    bool has_state = false;
+    if (api_read_state(req, &new_state, &has_state) != ESP_OK) {
+        return ESP_OK;
+    }
+    if (!has_state) {
         // Try to toggle if no state specified
         new_state = !relay_control_ui_get_state(relay_ui);
     }
@@ -270,18 +272,206 @@ static esp_err_t relay_post_handler(httpd_req_t *req)
     // Set relay state (this will update UI and hardware)
     relay_control_ui_set_state(relay_ui, new_state);
     
-    char response[128];
-    snprintf(response, sizeof(response), "{\"success\":true,\"id\":%d,\"state\":%s}", relay_id, new_state ? "true" : "false");
-    
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, response, HTTPD_RESP_USE_STRLEN);
-    return ESP_OK;
+    return api_send_relay_state(req, params->ints[0], new_state);
 }
 
 /**
- * @brief Handler for firmware upload
+ * @brief Handler for the current history of a relay (GET /api/relay/<id>/telemetry[?tier=30s|5min|30min])
+ * 
+ * "points" are the last RELAY_TELEMETRY_HISTORY_POINTS averages of the tier,
+ * oldest first, in hundredths of an Ampere; "seq" counts every point ever
+ * taken, so a client can tell which points are new.
  */
-static esp_err_t update_post_handler(httpd_req_t *req)
+static esp_err_t relay_telemetry_get_handler(httpd_req_t *req, const api_params_t *params)
+{
+    relay_control_ui_t *relay_ui = api_get_relay(req, params);
+    if (relay_ui == NULL) {
+        return ESP_OK;
+    }
+
+    relay_telemetry_tier_t tier = RELAY_TELEMETRY_TIER_30S;
+    char query[32];
+    char value[8];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "tier", value, sizeof(value)) == ESP_OK) {
+        if (strcmp(value, "5min") == 0) {
+            tier = RELAY_TELEMETRY_TIER_5MIN;
+        } else if (strcmp(value, "30min") == 0) {
+            tier = RELAY_TELEMETRY_TIER_30MIN;
+        } else if (strcmp(value, "30s") != 0) {
+            return api_send_error(req, "400 Bad Request", "Invalid tier");
+        }
+    }
+
+    int channel = relay_ui->telemetry_channel;
+    uint32_t seq = relay_telemetry_get_seq(channel, tier);
+    uint32_t first_seq = seq > RELAY_TELEMETRY_HISTORY_POINTS ? seq - RELAY_TELEMETRY_HISTORY_POINTS : 0;
+
+    char buf[API_JSON_BUF_SIZE];
+    json_writer_t w;
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    api_json_begin(req, &w, buf, sizeof(buf));
+    json_obj_begin(&w);
+    json_kv_bool(&w, "success", true);
+    json_kv_int(&w, "id", params->ints[0]);
+    json_kv_int(&w, "current_ca", relay_telemetry_get_current_ca(channel));
+    json_kv_int(&w, "period_ms", relay_telemetry_get_point_period_ms(tier));
+    json_kv_int(&w, "seq", seq);
+    json_key(&w, "points");
+    json_arr_begin(&w);
+    for (uint32_t s = first_seq; s < seq; s++) {
+        int16_t value_ca;
+        if (relay_telemetry_get_point(channel, tier, s, &value_ca)) {
+            json_int(&w, value_ca);
+        }
+    }
+    json_arr_end(&w);
+    json_obj_end(&w);
+    return api_json_end(&w);
+}
+
+/**
+ * @brief Handler for the device configuration (GET /api/config)
+ */
+static esp_err_t config_get_handler(httpd_req_t *req, const api_params_t *params)
+{
+    (void)params;
+#if CONFIG_EXAMPLE_WS_PUSH
+    const int ws_push_rate_hz = CONFIG_EXAMPLE_WS_PUSH_MAX_RATE_HZ;
+#else
+    const int ws_push_rate_hz = 0;
+#endif
+    char buf[API_JSON_BUF_SIZE];
+    json_writer_t w;
+    api_json_begin(req, &w, buf, sizeof(buf));
+    json_obj_begin(&w);
+    json_kv_bool(&w, "success", true);
+    json_kv_str(&w, "firmware", esp_app_get_description()->version);
+    json_kv_int(&w, "relays", HTTP_API_MAX_RELAYS);
+    json_kv_int(&w, "telemetry_period_ms", RELAY_TELEMETRY_SAMPLE_PERIOD_MS);
+    json_kv_int(&w, "ws_push_max_rate_hz", ws_push_rate_hz);
+    json_obj_end(&w);
+    return api_json_end(&w);
+}
+
+/**
+ * @brief Handler for LVGL pipeline metrics (GET /api/ui/metrics)
+ * 
+ * The writer flushes a chunk whenever its buffer fills, so the response never
+ * needs a buffer for all histograms.
+ */
+static esp_err_t ui_metrics_get_handler(httpd_req_t *req, const api_params_t *params)
+{
+    (void)params;
+    char buf[API_JSON_BUF_SIZE];
+    json_writer_t w;
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    api_json_begin(req, &w, buf, sizeof(buf));
+    json_obj_begin(&w);
+    for (int i = 0; i < UI_METRIC_COUNT; i++) {
+        ui_metrics_write_json((ui_metric_t)i, &w);
+    }
+    json_obj_end(&w);
+    return api_json_end(&w);
+}
+
+/**
+ * @brief Screen capture writer - forwards each encoded piece as one HTTP chunk
+ */
+static esp_err_t screen_capture_write_chunk(void *ctx, const uint8_t *data, size_t len)
+{
+    httpd_req_t *req = (httpd_req_t *)ctx;
+    return httpd_resp_send_chunk(req, (const char *)data, len);
+}
+
+/**
+ * @brief Send a screen capture (HTTP worker)
+ * 
+ * The image is encoded band by band while the LVGL task redraws the screen and
+ * streamed as it is produced, so no frame-sized buffer is needed.
+ */
+static esp_err_t screen_send(httpd_req_t *req)
+{
+    httpd_resp_set_type(req, "image/qoi");
+    httpd_resp_set_hdr(req, "Content-Disposition", "inline; filename=\"screen.qoi\"");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+    esp_err_t ret = screen_capture_stream(screen_capture_write_chunk, req);
+    if (ret == ESP_ERR_INVALID_STATE) {
+        // Nothing sent yet, so the status can still be changed
+        return api_send_error(req, "503 Service Unavailable", "Capture in progress");
+    }
+    if (ret != ESP_OK) {
+        // Headers are already out - drop the connection so the client sees a truncated image
+        ESP_LOGW(TAG, "Screen capture failed: %s", esp_err_to_name(ret));
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/**
+ * @brief Handler for screen captures (GET /api/screen), a QOI image of what the LCD shows
+ * 
+ * A capture waits for the LVGL task to redraw the whole screen, so it runs on
+ * an HTTP worker.
+ */
+static esp_err_t screen_get_handler(httpd_req_t *req, const api_params_t *params)
+{
+    (void)params;
+    esp_err_t ret = http_async_submit(req, screen_send);
+    if (ret == ESP_ERR_INVALID_STATE) {
+        httpd_resp_set_hdr(req, "Retry-After", "1");
+        return api_send_error(req, "503 Service Unavailable", "Server busy");
+    }
+    return ret;
+}
+
+/**
+ * @brief Handler for the task layout and per-core load (GET /api/tasks)
+ */
+static esp_err_t tasks_get_handler(httpd_req_t *req, const api_params_t *params)
+{
+    (void)params;
+    char buf[API_JSON_BUF_SIZE];
+    json_writer_t w;
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    api_json_begin(req, &w, buf, sizeof(buf));
+    task_layout_write_json(&w);
+    return api_json_end(&w);
+}
+
+/**
+ * @brief Reboot timer callback
+ */
+static void http_server_restart_cb(void *arg)
+{
+    (void)arg;
+    ESP_LOGI(TAG, "Rebooting now...");
+    esp_restart();
+}
+
+/**
+ * @brief Reboot in HTTP_OTA_REBOOT_DELAY_MS, leaving time to send the response
+ */
+static void http_server_schedule_restart(void)
+{
+    const esp_timer_create_args_t timer_args = {
+        .callback = http_server_restart_cb,
+        .name = "ota_reboot",
+    };
+    esp_timer_handle_t timer = NULL;
+    if (esp_timer_create(&timer_args, &timer) != ESP_OK ||
+        esp_timer_start_once(timer, HTTP_OTA_REBOOT_DELAY_MS * 1000) != ESP_OK) {
+        ESP_LOGW(TAG, "No reboot timer, rebooting now");
+        esp_restart();
+    }
+    ESP_LOGI(TAG, "Boot partition set successfully! Rebooting in %d ms...", HTTP_OTA_REBOOT_DELAY_MS);
+}
+
+/**
+ * @brief Receive a firmware image into the next OTA partition (reboots on success)
+ */
+static esp_err_t update_post_receive(httpd_req_t *req)
 {
     // Get content length - may be 0 for chunked or multipart transfers
     size_t content_len = req->content_len;
@@ -848,7 +1038,7 @@ static esp_err_t update_post_handler(httpd_req_t *req)
             esp_ota_abort(ota_handle);
             httpd_resp_set_status(req, "400 Bad Request");
             httpd_resp_send(req, "Image validation failed - invalid magic byte", HTTPD_RESP_USE_STRLEN);
-            return ESP_ERR_INVALID_ARG;
+            return ESP_ERR_OTA_VALIDATE_FAILED;
         }
         
         // Temporarily reduce log level for bootloader_support component to avoid logging lock issues
@@ -878,19 +1068,8 @@ static esp_err_t update_post_handler(httpd_req_t *req)
         }
         
         ESP_LOGI(TAG, "Image verification successful!");
-        
-        // Send success response first, before setting boot partition
-        // This ensures the client gets confirmation even if something goes wrong
-        httpd_resp_set_status(req, "200 OK");
-        httpd_resp_send(req, "Firmware update successful! Device will reboot...", HTTPD_RESP_USE_STRLEN);
-        
-        // Give time for response to be fully sent and ensure we're in task context
-        // Also allow HTTP server to finish processing
-        vTaskDelay(2000 / portTICK_PERIOD_MS);
-        
-        // Disable WiFi to avoid any interference during boot partition update
-        // This can help avoid cache coherency issues
-        ESP_LOGI(TAG, "Preparing to set boot partition...");
+        // The device reboots below, report the upload's load and UI timing first
+        task_layout_ota_end();
         
         // Re-get the partition to ensure pointer is valid (avoid cache issues)
         const esp_partition_t *boot_partition = esp_ota_get_next_update_partition(NULL);
@@ -912,15 +1091,18 @@ static esp_err_t update_post_handler(httpd_req_t *req)
         err = esp_ota_set_boot_partition(boot_partition);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "esp_ota_set_boot_partition failed: %s", esp_err_to_name(err));
-            // Even if setting boot partition fails, we've already sent success response
-            // The image is valid, so on next boot it might still work
+            httpd_resp_set_status(req, "500 Internal Server Error");
+            httpd_resp_send(req, "Could not set boot partition", HTTPD_RESP_USE_STRLEN);
             return err;
         }
         
-        ESP_LOGI(TAG, "Boot partition set successfully! Rebooting in 1 second...");
-        vTaskDelay(1000 / portTICK_PERIOD_MS);
-        ESP_LOGI(TAG, "Rebooting now...");
-        esp_restart();
+        // The boot partition is set before answering, so success means the next boot runs the new image
+        httpd_resp_set_status(req, "200 OK");
+        httpd_resp_send(req, "Firmware update successful! Device will reboot...", HTTPD_RESP_USE_STRLEN);
+        
+        // Reboot from a timer once the response has gone out; nothing waits for it meanwhile
+        http_server_schedule_restart();
+        return ESP_OK;
     }
     
     // If we get here and no data was received, return error
@@ -930,6 +1112,189 @@ static esp_err_t update_post_handler(httpd_req_t *req)
     return ESP_ERR_INVALID_ARG;
 }
 
+/**
+ * @brief Firmware upload on an HTTP worker - measures load, UI timing and API latency while it runs
+ */
+static esp_err_t update_post_worker(httpd_req_t *req)
+{
+    if (__atomic_exchange_n(&ota_running, true, __ATOMIC_ACQ_REL)) {
+        httpd_resp_set_status(req, "409 Conflict");
+        httpd_resp_send(req, "Another update is in progress", HTTPD_RESP_USE_STRLEN);
+        metrics_counter_inc(&ota_results[HTTP_OTA_RESULT_CONFLICT]);
+        return ESP_OK;
+    }
+    task_layout_ota_begin();
+    esp_err_t ret = update_post_receive(req);
+    task_layout_ota_end();
+    __atomic_store_n(&ota_running, false, __ATOMIC_RELEASE);
+
+    if (ret == ESP_OK) {
+        metrics_counter_inc(&ota_results[HTTP_OTA_RESULT_SUCCESS]);
+    } else if (ret == ESP_ERR_OTA_VALIDATE_FAILED) {
+        metrics_counter_inc(&ota_results[HTTP_OTA_RESULT_INVALID_IMAGE]);
+    } else {
+        metrics_counter_inc(&ota_results[HTTP_OTA_RESULT_FAILED]);
+    }
+
+    ESP_LOGI(TAG, "API during uploads: p50 %" PRIu32 " us, p95 %" PRIu32 " us, p99 %" PRIu32 " us",
+             ui_metrics_percentile(UI_METRIC_API_DURING_OTA_US, 50),
+             ui_metrics_percentile(UI_METRIC_API_DURING_OTA_US, 95),
+             ui_metrics_percentile(UI_METRIC_API_DURING_OTA_US, 99));
+    return ret;
+}
+
+/**
+ * @brief Handler for firmware upload - hands it to an HTTP worker so the server keeps serving
+ */
+static esp_err_t update_post_handler(httpd_req_t *req)
+{
+    esp_err_t ret = http_async_submit(req, update_post_worker);
+    if (ret == ESP_ERR_INVALID_STATE) {
+        metrics_counter_inc(&ota_results[HTTP_OTA_RESULT_BUSY]);
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "5");
+        return httpd_resp_send(req, "Server busy, try again", HTTPD_RESP_USE_STRLEN);
+    }
+    return ret;
+}
+
+/**
+ * @brief API routes, matched in order; path segments follow /api/
+ */
+static const api_route_t api_routes[] = {
+    { HTTP_GET,  { "relays" },                                    relays_get_handler },
+    { HTTP_POST, { "relays" },                                    relays_post_handler },
+    { HTTP_GET,  { "relay", API_ROUTER_PARAM_INT },               relay_get_handler },
+    { HTTP_POST, { "relay", API_ROUTER_PARAM_INT },               relay_post_handler },
+    { HTTP_GET,  { "relay", API_ROUTER_PARAM_INT, "telemetry" },  relay_telemetry_get_handler },
+    { HTTP_GET,  { "config" },                                    config_get_handler },
+    { HTTP_GET,  { "ui", "metrics" },                             ui_metrics_get_handler },
+    { HTTP_GET,  { "screen" },                                    screen_get_handler },
+    { HTTP_GET,  { "tasks" },                                     tasks_get_handler },
+};
+
+#define API_ROUTE_COUNT (sizeof(api_routes) / sizeof(api_routes[0]))
+
+// Per-route request statistics, plus one slot for requests no route took
+static api_route_stats_t api_route_stats[API_ROUTE_COUNT + 1];
+
+/**
+ * @brief Single entry point for /api/* (GET and POST)
+ */
+static esp_err_t api_handler(httpd_req_t *req)
+{
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t ret = api_router_dispatch(req, api_routes, api_route_stats, API_ROUTE_COUNT);
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    ui_metrics_record(UI_METRIC_API_US, elapsed_us);
+    if (__atomic_load_n(&ota_running, __ATOMIC_ACQUIRE)) {
+        ui_metrics_record(UI_METRIC_API_DURING_OTA_US, elapsed_us);
+    }
+    return ret;
+}
+
+/**
+ * @brief Metrics writer sink - one HTTP chunk per full buffer
+ */
+static bool metrics_http_sink(void *ctx, const char *data, size_t len)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, len) == ESP_OK;
+}
+
+/**
+ * @brief Relay switch count, state, current and energy families
+ */
+static void http_server_write_relay_metrics(metrics_writer_t *w)
+{
+    char labels[16];
+
+    metrics_write_family(w, "smartsocket_relay_switches_total", "counter", "Relay ON/OFF transitions.");
+    for (int id = 1; id <= HTTP_API_MAX_RELAYS; id++) {
+        relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(id);
+        if (relay_ui != NULL) {
+            snprintf(labels, sizeof(labels), "relay=\"%d\"", id);
+            metrics_write_int(w, "smartsocket_relay_switches_total", labels, relay_control_ui_get_switch_count(relay_ui));
+        }
+    }
+
+    metrics_write_family(w, "smartsocket_relay_on", "gauge", "1 while the relay is ON.");
+    for (int id = 1; id <= HTTP_API_MAX_RELAYS; id++) {
+        relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(id);
+        if (relay_ui != NULL) {
+            snprintf(labels, sizeof(labels), "relay=\"%d\"", id);
+            metrics_write_int(w, "smartsocket_relay_on", labels, relay_control_ui_get_state(relay_ui));
+        }
+    }
+
+    metrics_write_family(w, "smartsocket_relay_current_amperes", "gauge", "Latest current reading.");
+    for (int id = 1; id <= HTTP_API_MAX_RELAYS; id++) {
+        relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(id);
+        if (relay_ui != NULL) {
+            int32_t ca = relay_telemetry_get_current_ca(relay_ui->telemetry_channel);
+            int32_t abs_ca = ca < 0 ? -ca : ca;
+            metrics_printf(w, "smartsocket_relay_current_amperes{relay=\"%d\"} %s%" PRId32 ".%02" PRId32 "\n",
+                           id, ca < 0 ? "-" : "", abs_ca / 100, abs_ca % 100);
+        }
+    }
+
+    metrics_write_family(w, "smartsocket_relay_energy_joules_total", "counter",
+                         "Energy since boot, estimated from the current at the configured mains voltage.");
+    for (int id = 1; id <= HTTP_API_MAX_RELAYS; id++) {
+        relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui(id);
+        if (relay_ui != NULL) {
+            snprintf(labels, sizeof(labels), "relay=\"%d\"", id);
+            uint64_t charge_mas = relay_telemetry_get_charge_mas(relay_ui->telemetry_channel);
+            metrics_write_int(w, "smartsocket_relay_energy_joules_total", labels,
+                              (int64_t)(charge_mas * CONFIG_EXAMPLE_MAINS_VOLTAGE / 1000));
+        }
+    }
+}
+
+/**
+ * @brief Handler for Prometheus metrics (GET /metrics)
+ *
+ * Streamed in HTTP_METRICS_BUF_SIZE chunks as it is formatted, so the
+ * exposition can grow with routes and tasks without a larger buffer. All
+ * counters are since boot.
+ */
+static esp_err_t metrics_get_handler(httpd_req_t *req)
+{
+    char buf[HTTP_METRICS_BUF_SIZE];
+    metrics_writer_t w;
+    httpd_resp_set_type(req, "text/plain; version=0.0.4; charset=utf-8");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    metrics_writer_init(&w, buf, sizeof(buf), metrics_http_sink, req);
+
+    api_router_write_metrics(&w, api_routes, api_route_stats, API_ROUTE_COUNT);
+    http_server_write_relay_metrics(&w);
+
+    int8_t rssi = 0;
+    bool connected = wifi_ota_get_rssi(&rssi) == ESP_OK;
+    metrics_write_family(&w, "smartsocket_wifi_connected", "gauge", "1 while connected to the AP.");
+    metrics_write_int(&w, "smartsocket_wifi_connected", NULL, connected);
+    if (connected) {
+        metrics_write_family(&w, "smartsocket_wifi_rssi_dbm", "gauge", "Signal strength of the AP.");
+        metrics_write_int(&w, "smartsocket_wifi_rssi_dbm", NULL, rssi);
+    }
+    metrics_write_family(&w, "smartsocket_wifi_reconnects_total", "counter", "Connections to the AP lost and retried.");
+    metrics_write_int(&w, "smartsocket_wifi_reconnects_total", NULL, wifi_ota_get_disconnect_count());
+
+    metrics_write_family(&w, "smartsocket_ota_updates_total", "counter",
+                         "Firmware uploads by result (a success reboots, so it shows until the restart).");
+    for (int i = 0; i < HTTP_OTA_RESULT_COUNT; i++) {
+        char labels[32];
+        snprintf(labels, sizeof(labels), "result=\"%s\"", ota_result_names[i]);
+        metrics_write_int(&w, "smartsocket_ota_updates_total", labels, metrics_counter_read(&ota_results[i]));
+    }
+
+    metrics_write_system(&w);
+
+    if (!metrics_writer_flush(&w)) {
+        return ESP_FAIL;  // Headers are out already, only closing the connection is left
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
 /**
  * @brief Start the HTTP server
  */
@@ -940,18 +1305,29 @@ esp_err_t http_server_start(uint16_t port)
         return ESP_OK;
     }
     
-    // Initialize SPIFFS
-    esp_err_t spiffs_err = http_server_init_spiffs();
-    if (spiffs_err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize SPIFFS, continuing without file serving");
+    // Map the web UI image (no filesystem to mount)
+    if (web_assets_init() != ESP_OK) {
+        ESP_LOGE(TAG, "No web assets, continuing without file serving");
         // Continue anyway - API endpoints will still work
     }
     
+    // Long requests run on worker tasks, so the server task stays free for short ones
+    esp_err_t async_err = http_async_start();
+    if (async_err != ESP_OK) {
+        ESP_LOGE(TAG, "No HTTP workers, firmware uploads and screen captures will be refused with 503: %s",
+                 esp_err_to_name(async_err));
+    }
+    
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = port;
-    config.max_uri_handlers = 30;  // Increased to support all relay endpoints (1+1+1+6+6=15 minimum, with buffer)
+    config.max_uri_handlers = 8;   // Pages, firmware upload, /api/* (GET and POST), /metrics and /ws
+    config.uri_match_fn = httpd_uri_match_wildcard;
     config.max_open_sockets = 7;
-    config.stack_size = 16384;  // Increased stack size for large firmware uploads (default is 4096, increased to 16KB)
+    // Networking core, away from the LVGL task; the HTTP workers run there too
+    const task_layout_entry_t *httpd_layout = task_layout_get(TASK_ROLE_HTTPD);
+    config.stack_size = httpd_layout->stack_size;
+    config.task_priority = httpd_layout->priority;
+    config.core_id = httpd_layout->core;
     
     ESP_LOGI(TAG, "Starting HTTP server on port %d with max_uri_handlers=%d", port, config.max_uri_handlers);
     
@@ -999,47 +1375,48 @@ esp_err_t http_server_start(uint16_t port)
             ESP_LOGE(TAG, "Failed to register update POST handler: %s", esp_err_to_name(reg_err));
         }
         
-        // Relay API endpoints - register for each relay (1-6)
-        // Use static strings to ensure they persist
-        static const char relay_uri_1[] = "/api/relay/1";
-        static const char relay_uri_2[] = "/api/relay/2";
-        static const char relay_uri_3[] = "/api/relay/3";
-        static const char relay_uri_4[] = "/api/relay/4";
-        static const char relay_uri_5[] = "/api/relay/5";
-        static const char relay_uri_6[] = "/api/relay/6";
-        
-        const char *relay_uris[] = {
-            relay_uri_1, relay_uri_2, relay_uri_3,
-            relay_uri_4, relay_uri_5, relay_uri_6
+        // Every /api/ request goes through the route table
+        httpd_uri_t api_get = {
+            .uri = API_ROUTER_PREFIX "*",
+            .method = HTTP_GET,
+            .handler = api_handler,
+            .user_ctx = NULL
         };
+        reg_err = httpd_register_uri_handler(server_handle, &api_get);
+        if (reg_err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register API GET handler: %s", esp_err_to_name(reg_err));
+        }
         
-        for (int i = 0; i < 6; i++) {
-            httpd_uri_t relay_get = {
-                .uri = relay_uris[i],
-                .method = HTTP_GET,
-                .handler = relay_get_handler,
-                .user_ctx = NULL
-            };
-            reg_err = httpd_register_uri_handler(server_handle, &relay_get);
-            if (reg_err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to register GET handler for %s: %s", relay_uris[i], esp_err_to_name(reg_err));
-            } else {
-                ESP_LOGI(TAG, "Registered GET handler for %s", relay_uris[i]);
-            }
-            
-            httpd_uri_t relay_post = {
-                .uri = relay_uris[i],
-                .method = HTTP_POST,
-                .handler = relay_post_handler,
-                .user_ctx = NULL
-            };
-            reg_err = httpd_register_uri_handler(server_handle, &relay_post);
-            if (reg_err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to register POST handler for %s: %s", relay_uris[i], esp_err_to_name(reg_err));
-            } else {
-                ESP_LOGI(TAG, "Registered POST handler for %s", relay_uris[i]);
-            }
+        httpd_uri_t api_post = {
+            .uri = API_ROUTER_PREFIX "*",
+            .method = HTTP_POST,
+            .handler = api_handler,
+            .user_ctx = NULL
+        };
+        reg_err = httpd_register_uri_handler(server_handle, &api_post);
+        if (reg_err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register API POST handler: %s", esp_err_to_name(reg_err));
+        }
+
+        // Prometheus scrape endpoint
+        httpd_uri_t metrics_get = {
+            .uri = "/metrics",
+            .method = HTTP_GET,
+            .handler = metrics_get_handler,
+            .user_ctx = NULL
+        };
+        reg_err = httpd_register_uri_handler(server_handle, &metrics_get);
+        if (reg_err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register metrics handler: %s", esp_err_to_name(reg_err));
+        }
+
+#if CONFIG_EXAMPLE_WS_PUSH
+        // Relay updates pushed to the web UI
+        reg_err = ws_push_register(server_handle);
+        if (reg_err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start WebSocket push: %s", esp_err_to_name(reg_err));
         }
+#endif
         
         server_running = true;
         ESP_LOGI(TAG, "HTTP server started successfully on port %d", port);
@@ -1059,6 +1436,9 @@ esp_err_t http_server_stop(void)
         return ESP_OK;
     }
     
+#if CONFIG_EXAMPLE_WS_PUSH
+    ws_push_unregister();
+#endif
     httpd_stop(server_handle);
     server_handle = NULL;
     server_running = false;
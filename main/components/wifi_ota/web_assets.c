@@ -0,0 +1,304 @@
+/*
+ * Web Assets Component
+ *
+ * The packed image in the "www" partition is mapped into the data address
+ * space once at boot and used in place: the index entries are looked up with
+ * a binary search over their URI hashes, and a response body is handed to the
+ * socket in WEB_ASSETS_SLICE_SIZE slices straight from the mapped address.
+ * A request first checks If-None-Match against the index, so a repeat visit
+ * costs a 304 and no asset data is read. The image holds only the gzip copy of
+ * a compressed asset, so a client that does not accept gzip gets 406.
+ */
+
+#include "web_assets.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+
+static const char *TAG = "web_assets";
+
+#define WEB_ASSETS_SLICE_SIZE  (16 * 1024)  // Bytes handed to the socket per send
+
+_Static_assert(sizeof(web_assets_image_header_t) == 16, "must match main/tools/web_assets.py");
+_Static_assert(sizeof(web_asset_t) == 116, "must match main/tools/web_assets.py");
+
+static const uint8_t *image_base = NULL;
+static const web_asset_t *asset_index = NULL;
+static uint32_t asset_count = 0;
+static esp_partition_mmap_handle_t image_map;
+
+/**
+ * @brief FNV-1a hash of the first len bytes of a string (as in web_assets.py)
+ */
+static uint32_t web_assets_hash(const char *s, size_t len)
+{
+    uint32_t hash = 0x811c9dc5;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t)s[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+/**
+ * @brief Check the index of a mapped image before it is trusted
+ */
+static bool web_assets_index_valid(const web_assets_image_header_t *header, const web_asset_t *index)
+{
+    for (uint32_t i = 0; i < header->count; i++) {
+        const web_asset_t *asset = &index[i];
+        if (asset->offset > header->image_size || asset->size > header->image_size - asset->offset) {
+            ESP_LOGE(TAG, "Asset %" PRIu32 " lies outside the image", i);
+            return false;
+        }
+        if (memchr(asset->uri, '\0', sizeof(asset->uri)) == NULL ||
+            memchr(asset->etag, '\0', sizeof(asset->etag)) == NULL ||
+            memchr(asset->mime, '\0', sizeof(asset->mime)) == NULL) {
+            ESP_LOGE(TAG, "Asset %" PRIu32 " has an unterminated string", i);
+            return false;
+        }
+        if (asset->hash != web_assets_hash(asset->uri, strlen(asset->uri))) {
+            ESP_LOGE(TAG, "Asset %s has a wrong hash", asset->uri);
+            return false;
+        }
+        if (i > 0 && asset->hash < index[i - 1].hash) {
+            ESP_LOGE(TAG, "Asset index is not sorted");
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Map the asset image and check its index
+ */
+esp_err_t web_assets_init(void)
+{
+    int64_t start_us = esp_timer_get_time();
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                           WEB_ASSETS_PARTITION);
+    if (part == NULL) {
+        ESP_LOGE(TAG, "No \"%s\" partition", WEB_ASSETS_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    web_assets_image_header_t header;
+    esp_err_t ret = esp_partition_read(part, 0, &header, sizeof(header));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (header.magic != WEB_ASSETS_MAGIC || header.image_size > part->size || header.count > header.image_size ||
+        header.image_size < sizeof(header) + header.count * sizeof(web_asset_t)) {
+        ESP_LOGE(TAG, "No asset image in the \"%s\" partition (flash it with idf.py flash)", WEB_ASSETS_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Only the image is mapped, not the whole partition
+    const void *base = NULL;
+    ret = esp_partition_mmap(part, 0, header.image_size, ESP_PARTITION_MMAP_DATA, &base, &image_map);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map the asset image: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    const web_asset_t *index = (const web_asset_t *)((const uint8_t *)base + sizeof(header));
+    if (!web_assets_index_valid(&header, index)) {
+        esp_partition_munmap(image_map);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    image_base = base;
+    asset_index = index;
+    asset_count = header.count;
+    ESP_LOGI(TAG, "%" PRIu32 " assets mapped from the \"%s\" partition (%" PRIu32 " bytes) in %" PRIu32 " us",
+             asset_count, WEB_ASSETS_PARTITION, header.image_size, (uint32_t)(esp_timer_get_time() - start_us));
+    return ESP_OK;
+}
+
+/**
+ * @brief Look up an asset by URI
+ */
+const web_asset_t *web_assets_find(const char *uri)
+{
+    if (uri == NULL || asset_index == NULL) {
+        return NULL;
+    }
+    size_t len = strcspn(uri, "?#");
+    uint32_t hash = web_assets_hash(uri, len);
+
+    // First entry with this hash
+    uint32_t lo = 0;
+    uint32_t hi = asset_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (asset_index[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (; lo < asset_count && asset_index[lo].hash == hash; lo++) {
+        const web_asset_t *asset = &asset_index[lo];
+        if (strncmp(asset->uri, uri, len) == 0 && asset->uri[len] == '\0') {
+            return asset;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Whether the request's If-None-Match lists the asset's ETag
+ */
+static bool web_assets_not_modified(httpd_req_t *req, const web_asset_t *asset)
+{
+    char value[96];
+    size_t len = httpd_req_get_hdr_value_len(req, "If-None-Match");
+    if (len == 0 || len >= sizeof(value)) {
+        return false;
+    }
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", value, sizeof(value)) != ESP_OK) {
+        return false;
+    }
+    return strcmp(value, "*") == 0 || strstr(value, asset->etag) != NULL;
+}
+
+/**
+ * @brief Whether one Accept-Encoding entry (e.g. "gzip;q=0.8") allows gzip
+ */
+static bool web_assets_coding_allows_gzip(const char *entry, size_t len)
+{
+    while (len > 0 && isspace((unsigned char)*entry)) {
+        entry++;
+        len--;
+    }
+    size_t name_len = 0;
+    while (name_len < len && entry[name_len] != ';' && !isspace((unsigned char)entry[name_len])) {
+        name_len++;
+    }
+    bool named = (name_len == 4 && strncasecmp(entry, "gzip", 4) == 0) ||
+                 (name_len == 1 && entry[0] == '*');
+    if (!named) {
+        return false;
+    }
+
+    // "q=0", "q=0.0" and so on refuse the coding; any other weight accepts it
+    const char *q = entry + name_len;
+    const char *end = entry + len;
+    while (q < end && (*q == ';' || isspace((unsigned char)*q))) {
+        q++;
+    }
+    if (end - q < 3 || (q[0] != 'q' && q[0] != 'Q') || q[1] != '=') {
+        return true;
+    }
+    for (q += 2; q < end && !isspace((unsigned char)*q); q++) {
+        if (*q != '0' && *q != '.') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Whether the request's Accept-Encoding allows a gzip body
+ *
+ * A missing header counts as no: the image has no identity copy to fall back
+ * to, and plain HTTP clients (curl without --compressed) send none.
+ */
+static bool web_assets_accepts_gzip(httpd_req_t *req)
+{
+    char value[128];
+    size_t len = httpd_req_get_hdr_value_len(req, "Accept-Encoding");
+    if (len == 0) {
+        return false;
+    }
+    if (len >= sizeof(value)) {
+        return true;  // Only browsers send lists this long, and they all take gzip
+    }
+    if (httpd_req_get_hdr_value_str(req, "Accept-Encoding", value, sizeof(value)) != ESP_OK) {
+        return false;
+    }
+
+    const char *entry = value;
+    while (true) {
+        const char *comma = strchr(entry, ',');
+        size_t entry_len = comma != NULL ? (size_t)(comma - entry) : strlen(entry);
+        if (web_assets_coding_allows_gzip(entry, entry_len)) {
+            return true;
+        }
+        if (comma == NULL) {
+            return false;
+        }
+        entry = comma + 1;
+    }
+}
+
+/**
+ * @brief Send the body straight from the mapped image
+ */
+static esp_err_t web_assets_send_body(httpd_req_t *req, const web_asset_t *asset)
+{
+    const char *data = (const char *)image_base + asset->offset;
+    if (asset->size <= WEB_ASSETS_SLICE_SIZE) {
+        // Headers with Content-Length and the whole body in one go
+        return httpd_resp_send(req, data, asset->size);
+    }
+    for (uint32_t sent = 0; sent < asset->size; sent += WEB_ASSETS_SLICE_SIZE) {
+        uint32_t len = asset->size - sent < WEB_ASSETS_SLICE_SIZE ? asset->size - sent : WEB_ASSETS_SLICE_SIZE;
+        if (httpd_resp_send_chunk(req, data + sent, len) != ESP_OK) {
+            ESP_LOGE(TAG, "File sending failed");
+            return ESP_FAIL;
+        }
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/**
+ * @brief Send an asset as the response to a GET request
+ */
+esp_err_t web_assets_send(httpd_req_t *req, const char *uri)
+{
+    int64_t start_us = esp_timer_get_time();
+    const web_asset_t *asset = web_assets_find(uri);
+    if (asset == NULL) {
+        ESP_LOGE(TAG, "No asset for %s", uri);
+        httpd_resp_set_status(req, "404 Not Found");
+        httpd_resp_send(req, "File not found", HTTPD_RESP_USE_STRLEN);
+        return ESP_FAIL;
+    }
+
+    // URIs are not versioned, so browsers revalidate every time; a match costs only the headers
+    httpd_resp_set_hdr(req, "ETag", asset->etag);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    if (asset->flags & WEB_ASSETS_FLAG_GZIP) {
+        // The response depends on Accept-Encoding, so caches must key on it
+        httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+    }
+    if (web_assets_not_modified(req, asset)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        esp_err_t ret = httpd_resp_send(req, NULL, 0);
+        ESP_LOGD(TAG, "%s not modified (%" PRIu32 " us)", asset->uri, (uint32_t)(esp_timer_get_time() - start_us));
+        return ret;
+    }
+
+    if (asset->flags & WEB_ASSETS_FLAG_GZIP) {
+        if (!web_assets_accepts_gzip(req)) {
+            // The image has no uncompressed copy to serve instead
+            ESP_LOGD(TAG, "%s needs gzip, not accepted by the client", asset->uri);
+            httpd_resp_set_status(req, "406 Not Acceptable");
+            httpd_resp_set_type(req, "text/plain");
+            return httpd_resp_send(req, "This asset is only available gzip-encoded", HTTPD_RESP_USE_STRLEN);
+        }
+        httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    }
+    httpd_resp_set_type(req, asset->mime);
+    esp_err_t ret = web_assets_send_body(req, asset);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ESP_LOGD(TAG, "Sent %s (%" PRIu32 " bytes%s) in %" PRIu32 " us", asset->uri, asset->size,
+             (asset->flags & WEB_ASSETS_FLAG_GZIP) ? ", gzip" : "", (uint32_t)(esp_timer_get_time() - start_us));
+    return ESP_OK;
+}
@@ -0,0 +1,86 @@
+/*
+ * Web Assets Component Header
+ *
+ * Serves the web UI from the read-only image in the "www" partition that the
+ * build packs from main/web (main/tools/web_assets.py): gzip-precompressed
+ * assets behind a hashed index with precomputed MIME type and ETag. The image
+ * is memory-mapped at boot, so there is no filesystem to mount. Responses carry
+ * Content-Encoding and a strong ETag, and conditional requests are answered
+ * from the index alone.
+ */
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WEB_ASSETS_PARTITION  "www"
+#define WEB_ASSETS_MAGIC      0x32575757  // "WWW2"
+#define WEB_ASSETS_FLAG_GZIP  0x1
+#define WEB_ASSETS_URI_LEN    48
+#define WEB_ASSETS_ETAG_LEN   20
+#define WEB_ASSETS_MIME_LEN   32
+
+/**
+ * @brief Header of the packed image (little endian)
+ */
+typedef struct {
+    uint32_t magic;                     // WEB_ASSETS_MAGIC
+    uint32_t count;                     // Index entries following the header
+    uint32_t image_size;                // Header, index and data
+    uint32_t reserved;
+} web_assets_image_header_t;
+
+/**
+ * @brief Index entry of the packed image, used in place in the mapped flash
+ */
+typedef struct {
+    uint32_t hash;                      // FNV-1a of the URI; the index is sorted by (hash, uri)
+    uint32_t offset;                    // Data offset from the start of the image, 4-byte aligned
+    uint32_t size;                      // Stored (compressed) size in bytes
+    uint32_t flags;                     // WEB_ASSETS_FLAG_*
+    char uri[WEB_ASSETS_URI_LEN];       // e.g. "/index.html"
+    char etag[WEB_ASSETS_ETAG_LEN];     // Quoted, e.g. "\"ebd8274db8bc055f\""
+    char mime[WEB_ASSETS_MIME_LEN];     // Content-Type
+} web_asset_t;
+
+/**
+ * @brief Map the asset image and check its index
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND without a valid image
+ */
+esp_err_t web_assets_init(void);
+
+/**
+ * @brief Look up an asset by URI (O(log n))
+ *
+ * @param uri Request path; a query string or fragment is ignored
+ * @return const web_asset_t* Asset, or NULL if the image has none for this URI
+ */
+const web_asset_t *web_assets_find(const char *uri);
+
+/**
+ * @brief Send an asset as the response to a GET request
+ *
+ * Answers 304 Not Modified without touching the asset data when If-None-Match
+ * holds the asset's ETag, 406 Not Acceptable for a gzip-stored asset when the
+ * request's Accept-Encoding does not allow gzip, and 404 for unknown URIs.
+ *
+ * @param req Request
+ * @param uri Asset to send, e.g. "/index.html"
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t web_assets_send(httpd_req_t *req, const char *uri);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEB_ASSETS_H
@@ -17,6 +17,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "metrics.h"
 
 static const char *TAG = "wifi_ota";
 
@@ -27,6 +28,7 @@ static const char *TAG = "wifi_ota";
 static EventGroupHandle_t s_wifi_event_group;
 static int s_retry_num = 0;
 static bool s_wifi_connected = false;
+static metrics_counter_t s_disconnects;
 
 /**
  * @brief WiFi event handler
@@ -37,6 +39,9 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
         esp_wifi_connect();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        if (s_wifi_connected) {
+            metrics_counter_inc(&s_disconnects);
+        }
         if (s_retry_num < WIFI_MAXIMUM_RETRY) {
             esp_wifi_connect();
             s_retry_num++;
@@ -249,6 +254,35 @@ esp_err_t wifi_ota_get_ip(char *ip_str, size_t len)
     return ESP_OK;
 }
 
+/**
+ * @brief Get the signal strength of the connected AP
+ */
+esp_err_t wifi_ota_get_rssi(int8_t *rssi)
+{
+    if (rssi == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_wifi_connected) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    wifi_ap_record_t ap_info;
+    esp_err_t err = esp_wifi_sta_get_ap_info(&ap_info);
+    if (err != ESP_OK) {
+        return err;
+    }
+    *rssi = ap_info.rssi;
+    return ESP_OK;
+}
+
+/**
+ * @brief Number of times an established connection was lost
+ */
+uint32_t wifi_ota_get_disconnect_count(void)
+{
+    return metrics_counter_read(&s_disconnects);
+}
+
 /**
  * @brief Start HTTP server for firmware uploads
  */
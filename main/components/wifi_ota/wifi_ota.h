@@ -66,6 +66,24 @@ bool wifi_ota_is_connected(void);
  */
 esp_err_t wifi_ota_get_ip(char *ip_str, size_t len);
 
+/**
+ * @brief Get the signal strength of the connected AP
+ * 
+ * @param rssi Output: RSSI in dBm
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE when not connected
+ */
+esp_err_t wifi_ota_get_rssi(int8_t *rssi);
+
+/**
+ * @brief Number of times an established connection was lost
+ * 
+ * Each loss is followed by reconnect attempts, so this counts reconnects
+ * (failed attempts while not connected are not counted).
+ * 
+ * @return uint32_t Count since boot
+ */
+uint32_t wifi_ota_get_disconnect_count(void);
+
 /**
  * @brief Start HTTP server for firmware uploads (optional)
  * 
@@ -0,0 +1,523 @@
+/*
+ * WebSocket Push Component
+ *
+ * One task compares the relay state store with the last values each client
+ * was sent and pushes only the relays that differ. Because the message is
+ * built from that difference, it naturally coalesces: a client rate-limited
+ * to CONFIG_EXAMPLE_WS_PUSH_MAX_RATE_HZ, or with WS_PUSH_QUEUE_DEPTH messages
+ * still queued on the httpd task, simply gets the newest state on its next
+ * turn. Nothing is ever queued without bound and no update is lost.
+ *
+ * The task wakes when relay_control_ui reports a state change and otherwise
+ * every telemetry sample period for countdown and current updates.
+ */
+
+#include "ws_push.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "relay_control_ui.h"
+#include "relay_telemetry.h"
+#include "ui_metrics.h"
+#include "task_layout.h"
+#include "json_stream.h"
+
+static const char *TAG = "ws_push";
+
+// Forward declaration
+extern relay_control_ui_t *example_lvgl_get_relay_ui(int index);
+
+#define WS_PUSH_RELAYS           6
+#define WS_PUSH_MIN_INTERVAL_US  (1000000 / CONFIG_EXAMPLE_WS_PUSH_MAX_RATE_HZ)
+
+typedef struct {
+    bool valid;             // false until the relay was sent (or when it must be resent)
+    bool state;
+    uint32_t remaining;
+    int32_t current_ca;
+} ws_relay_snapshot_t;
+
+typedef struct {
+    char data[WS_PUSH_MSG_SIZE];
+    size_t len;
+    httpd_handle_t server;  // Server the message was queued on
+    int fd;
+    uint32_t seq;
+    int64_t change_us;      // First state change the message carries, 0 for countdown/current only
+    int64_t sent_us;        // Handed to the socket
+    bool busy;              // Queued on the httpd task
+} ws_msg_t;
+
+typedef struct {
+    int fd;                 // -1 for a free slot
+    ws_relay_snapshot_t sent[WS_PUSH_RELAYS];
+    ws_msg_t msgs[WS_PUSH_QUEUE_DEPTH];
+    int64_t last_send_us;
+    int64_t dirty_since_us; // First state change not yet sent, 0 if none
+    uint32_t next_seq;
+    uint32_t deferred;      // Turns skipped because the client's queue was full
+} ws_client_t;
+
+static ws_client_t clients[WS_PUSH_MAX_CLIENTS];
+static SemaphoreHandle_t clients_lock = NULL;
+static httpd_handle_t ws_server = NULL;
+static TaskHandle_t push_task = NULL;
+static int64_t pending_change_us = 0;   // Set by the change listener, taken by the push task
+
+/**
+ * @brief Relay state store listener - runs in whichever task changed a relay
+ */
+static void ws_push_on_change(void)
+{
+    int64_t expected = 0;
+    int64_t now = esp_timer_get_time();
+    __atomic_compare_exchange_n(&pending_change_us, &expected, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    if (push_task != NULL) {
+        xTaskNotifyGive(push_task);
+    }
+}
+
+/**
+ * @brief Current values of every relay (invalid entries for relays not created yet)
+ */
+static void ws_push_read_store(ws_relay_snapshot_t *store)
+{
+    for (int i = 0; i < WS_PUSH_RELAYS; i++) {
+        relay_control_ui_t *relay = example_lvgl_get_relay_ui(i + 1);
+        store[i].valid = relay != NULL;
+        if (relay == NULL) {
+            continue;
+        }
+        store[i].state = relay_control_ui_get_state(relay);
+        store[i].remaining = relay_control_ui_get_time_remaining(relay);
+        store[i].current_ca = relay_telemetry_get_current_ca(relay->telemetry_channel);
+    }
+}
+
+/**
+ * @brief Whether a relay differs enough from what the client has to be pushed
+ */
+static bool ws_push_relay_changed(const ws_relay_snapshot_t *sent, const ws_relay_snapshot_t *now)
+{
+    if (!now->valid) {
+        return false;
+    }
+    if (!sent->valid || sent->state != now->state || sent->remaining != now->remaining) {
+        return true;
+    }
+    return abs(sent->current_ca - now->current_ca) >= WS_PUSH_CURRENT_DEADBAND_CA;
+}
+
+/**
+ * @brief httpd work item - send one queued message (httpd task)
+ */
+static void ws_push_send_work(void *arg)
+{
+    ws_msg_t *msg = (ws_msg_t *)arg;
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)msg->data,
+        .len = msg->len,
+    };
+
+    esp_err_t ret = httpd_ws_send_frame_async(msg->server, msg->fd, &frame);
+    if (ret != ESP_OK) {
+        ESP_LOGD(TAG, "Send to fd %d failed: %s", msg->fd, esp_err_to_name(ret));
+    }
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    msg->sent_us = esp_timer_get_time();
+    msg->busy = false;
+    xSemaphoreGive(clients_lock);
+}
+
+/**
+ * @brief Build and queue the delta for one client (clients_lock held)
+ */
+static void ws_push_client(ws_client_t *client, const ws_relay_snapshot_t *store, int64_t now_us)
+{
+    ws_msg_t *msg = NULL;
+    for (int i = 0; i < WS_PUSH_QUEUE_DEPTH; i++) {
+        if (!client->msgs[i].busy) {
+            msg = &client->msgs[i];
+            break;
+        }
+    }
+
+    bool changed[WS_PUSH_RELAYS];
+    bool any = false;
+    for (int i = 0; i < WS_PUSH_RELAYS; i++) {
+        changed[i] = ws_push_relay_changed(&client->sent[i], &store[i]);
+        any |= changed[i];
+    }
+    if (!any) {
+        client->dirty_since_us = 0;
+        return;
+    }
+    if (msg == NULL) {
+        // Slow client: keep the difference, the next turn sends the newest state
+        client->deferred++;
+        return;
+    }
+
+    uint32_t seq = client->next_seq++;
+    json_writer_t w;
+    json_writer_init(&w, msg->data, sizeof(msg->data), NULL, NULL);
+    json_obj_begin(&w);
+    json_kv_int(&w, "seq", seq);
+    json_kv_int(&w, "version", relay_control_ui_get_state_version());
+    json_key(&w, "relays");
+    json_arr_begin(&w);
+    for (int i = 0; i < WS_PUSH_RELAYS; i++) {
+        if (!changed[i]) {
+            continue;
+        }
+        json_obj_begin(&w);
+        json_kv_int(&w, "id", i + 1);
+        json_kv_bool(&w, "state", store[i].state);
+        json_kv_int(&w, "remaining", store[i].remaining);
+        json_kv_int(&w, "current_ca", store[i].current_ca);
+        json_obj_end(&w);
+    }
+    json_arr_end(&w);
+    json_obj_end(&w);
+    if (w.failed) {
+        ESP_LOGE(TAG, "Message does not fit %d bytes", WS_PUSH_MSG_SIZE);
+        return;
+    }
+
+    msg->len = w.len;
+    msg->server = ws_server;
+    msg->fd = client->fd;
+    msg->seq = seq;
+    msg->change_us = client->dirty_since_us;
+    msg->sent_us = 0;
+    msg->busy = true;
+    if (httpd_queue_work(ws_server, ws_push_send_work, msg) != ESP_OK) {
+        msg->busy = false;
+        return;  // Snapshot unchanged, retried on the next turn
+    }
+
+    for (int i = 0; i < WS_PUSH_RELAYS; i++) {
+        if (changed[i]) {
+            client->sent[i] = store[i];
+        }
+    }
+    client->last_send_us = now_us;
+    client->dirty_since_us = 0;
+}
+
+/**
+ * @brief One pass over all clients
+ *
+ * @return TickType_t How long the push task may sleep
+ */
+static TickType_t ws_push_round(void)
+{
+    ws_relay_snapshot_t store[WS_PUSH_RELAYS];
+    ws_push_read_store(store);
+
+    int64_t now_us = esp_timer_get_time();
+    int64_t change_us = __atomic_exchange_n(&pending_change_us, 0, __ATOMIC_RELAXED);
+    int64_t wait_us = (int64_t)RELAY_TELEMETRY_SAMPLE_PERIOD_MS * 1000;
+    bool any_client = false;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_PUSH_MAX_CLIENTS && ws_server != NULL; i++) {
+        ws_client_t *client = &clients[i];
+        if (client->fd < 0) {
+            continue;
+        }
+        if (httpd_ws_get_fd_info(ws_server, client->fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+            ESP_LOGI(TAG, "Client on fd %d left (%" PRIu32 " turns deferred)", client->fd, client->deferred);
+            client->fd = -1;
+            continue;
+        }
+        any_client = true;
+        if (change_us != 0 && client->dirty_since_us == 0) {
+            client->dirty_since_us = change_us;
+        }
+
+        int64_t due_us = client->last_send_us + WS_PUSH_MIN_INTERVAL_US - now_us;
+        if (due_us > 0) {
+            // Rate limited: changes pile up in the difference until the client's next turn
+            if (due_us < wait_us) {
+                wait_us = due_us;
+            }
+            continue;
+        }
+        ws_push_client(client, store, now_us);
+    }
+    xSemaphoreGive(clients_lock);
+
+    if (!any_client) {
+        return portMAX_DELAY;
+    }
+    TickType_t ticks = pdMS_TO_TICKS((wait_us + 999) / 1000);
+    return ticks > 0 ? ticks : 1;
+}
+
+static void ws_push_task_fn(void *arg)
+{
+    (void)arg;
+    while (1) {
+        TickType_t wait = ws_push_round();
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
+
+/**
+ * @brief Record the push latency of an acknowledged message
+ */
+static void ws_push_handle_ack(int fd, uint32_t seq)
+{
+    int64_t ack_us = esp_timer_get_time();
+    int64_t latency_us = -1;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_PUSH_MAX_CLIENTS && latency_us < 0; i++) {
+        if (clients[i].fd != fd) {
+            continue;
+        }
+        for (int m = 0; m < WS_PUSH_QUEUE_DEPTH; m++) {
+            ws_msg_t *msg = &clients[i].msgs[m];
+            if (msg->seq == seq && msg->change_us != 0 && msg->sent_us != 0) {
+                // Change to send, plus half the round trip for the way to the browser
+                latency_us = (msg->sent_us - msg->change_us) + (ack_us - msg->sent_us) / 2;
+                msg->change_us = 0;
+                break;
+            }
+        }
+    }
+    xSemaphoreGive(clients_lock);
+
+    if (latency_us >= 0) {
+        ui_metrics_record(UI_METRIC_PUSH_LATENCY_US, (uint32_t)latency_us);
+        ESP_LOGD(TAG, "Change reached the browser on fd %d in ~%" PRId64 " us", fd, latency_us);
+    }
+}
+
+/**
+ * @brief Push a relay to one client on its next turn even if it did not change
+ *
+ * A command that leaves the state as it was (already switched elsewhere, or a
+ * double click) makes no difference to push, yet the client waits for an answer.
+ */
+static void ws_push_resend_relay(int fd, int relay_id)
+{
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_PUSH_MAX_CLIENTS; i++) {
+        if (clients[i].fd == fd) {
+            clients[i].sent[relay_id - 1].valid = false;
+            break;
+        }
+    }
+    xSemaphoreGive(clients_lock);
+    xTaskNotifyGive(push_task);
+}
+
+/**
+ * @brief Send an error frame back to the client of a request (httpd task)
+ */
+static esp_err_t ws_push_reply_error(httpd_req_t *req, const char *error)
+{
+    char text[80];
+    json_writer_t w;
+    json_writer_init(&w, text, sizeof(text), NULL, NULL);
+    json_obj_begin(&w);
+    json_kv_str(&w, "error", error);
+    json_obj_end(&w);
+    if (w.failed) {
+        return ESP_FAIL;
+    }
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)text,
+        .len = w.len,
+    };
+    return httpd_ws_send_frame(req, &frame);
+}
+
+/**
+ * @brief Take a new client into the table (httpd task)
+ */
+static esp_err_t ws_push_add_client(int fd)
+{
+    ws_client_t *slot = NULL;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_PUSH_MAX_CLIENTS; i++) {
+        // A stale entry may still hold a reused descriptor
+        if (clients[i].fd == fd || (slot == NULL && clients[i].fd < 0)) {
+            slot = &clients[i];
+            if (clients[i].fd == fd) {
+                break;
+            }
+        }
+    }
+    if (slot != NULL) {
+        // Queued messages of a previous client may still be in flight, wait for them to go
+        for (int m = 0; m < WS_PUSH_QUEUE_DEPTH; m++) {
+            if (slot->msgs[m].busy) {
+                slot = NULL;
+                break;
+            }
+        }
+    }
+    if (slot != NULL) {
+        memset(slot, 0, sizeof(ws_client_t));
+        slot->fd = fd;
+        slot->next_seq = 1;
+    }
+    xSemaphoreGive(clients_lock);
+
+    if (slot == NULL) {
+        ESP_LOGW(TAG, "No room for another client on fd %d", fd);
+        return ESP_FAIL;  // Closes the socket
+    }
+    ESP_LOGI(TAG, "Client connected on fd %d", fd);
+    // First message lists every relay
+    xTaskNotifyGive(push_task);
+    return ESP_OK;
+}
+
+/**
+ * @brief WebSocket handler (GET /ws) - handshake, relay commands and acks
+ */
+static esp_err_t ws_push_handler(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+    if (req->method == HTTP_GET) {
+        // Handshake done
+        return ws_push_add_client(fd);
+    }
+
+    // The frame is received straight into the reader
+    json_reader_t reader;
+    size_t room;
+    json_reader_init(&reader);
+    httpd_ws_frame_t frame = {
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)json_reader_tail(&reader, &room),
+    };
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (frame.len > room) {
+        ESP_LOGW(TAG, "Dropping client on fd %d: %u byte frame", fd, (unsigned)frame.len);
+        return ESP_FAIL;  // The payload can't be skipped, close the socket
+    }
+    ret = httpd_ws_recv_frame(req, &frame, room);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (frame.type != HTTPD_WS_TYPE_TEXT) {
+        return ESP_OK;
+    }
+    if (json_reader_advance(&reader, frame.len) != JSON_OK) {
+        return ws_push_reply_error(req, "Invalid JSON");
+    }
+
+    int64_t value;
+    if (json_reader_get_int(&reader, json_reader_find(&reader, 0, "ack"), &value)) {
+        ws_push_handle_ack(fd, (uint32_t)value);
+        return ESP_OK;
+    }
+
+    int64_t relay_id = 0;
+    json_reader_get_int(&reader, json_reader_find(&reader, 0, "id"), &relay_id);
+    if (relay_id < 1 || relay_id > WS_PUSH_RELAYS) {
+        return ws_push_reply_error(req, "Invalid relay ID");
+    }
+    relay_control_ui_t *relay_ui = example_lvgl_get_relay_ui((int)relay_id);
+    if (relay_ui == NULL) {
+        return ws_push_reply_error(req, "Relay not initialized");
+    }
+
+    // The new state reaches every client through the push, this one included
+    int state_token = json_reader_find(&reader, 0, "state");
+    bool state;
+    if (state_token < 0) {
+        state = !relay_control_ui_get_state(relay_ui);
+    } else if (!json_reader_get_bool(&reader, state_token, &state)) {
+        return ws_push_reply_error(req, "Invalid state");
+    }
+    relay_control_ui_set_state(relay_ui, state);
+    ws_push_resend_relay(fd, (int)relay_id);
+    return ESP_OK;
+}
+
+/**
+ * @brief Register the /ws endpoint and start the push task
+ */
+esp_err_t ws_push_register(httpd_handle_t server)
+{
+    if (server == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (clients_lock == NULL) {
+        clients_lock = xSemaphoreCreateMutex();
+        if (clients_lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        for (int i = 0; i < WS_PUSH_MAX_CLIENTS; i++) {
+            clients[i].fd = -1;
+        }
+    }
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    ws_server = server;
+    xSemaphoreGive(clients_lock);
+
+    if (push_task == NULL) {
+        esp_err_t ret = task_layout_create(TASK_ROLE_WS_PUSH, ws_push_task_fn, NULL, &push_task);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        relay_control_ui_set_change_listener(ws_push_on_change);
+    }
+
+    httpd_uri_t ws_uri = {
+        .uri = "/ws",
+        .method = HTTP_GET,
+        .handler = ws_push_handler,
+        .user_ctx = NULL,
+        .is_websocket = true,
+    };
+    esp_err_t ret = httpd_register_uri_handler(server, &ws_uri);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register /ws: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "Pushing relay updates on /ws, up to %d clients at %d messages/s each",
+             WS_PUSH_MAX_CLIENTS, CONFIG_EXAMPLE_WS_PUSH_MAX_RATE_HZ);
+    return ESP_OK;
+}
+
+/**
+ * @brief Forget all clients and the server before it is stopped
+ */
+void ws_push_unregister(void)
+{
+    if (clients_lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    ws_server = NULL;
+    // Work still queued on the server is dropped with it, so the message slots are freed here
+    memset(clients, 0, sizeof(clients));
+    for (int i = 0; i < WS_PUSH_MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+    xSemaphoreGive(clients_lock);
+}
@@ -0,0 +1,50 @@
+/*
+ * WebSocket Push Component Header
+ *
+ * WebSocket endpoint (/ws) on the HTTP server that pushes relay state,
+ * countdown and current changes to the browser as they happen, and accepts
+ * relay commands on the same socket.
+ */
+
+#ifndef WS_PUSH_H
+#define WS_PUSH_H
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WS_PUSH_MAX_CLIENTS          4    // Each client holds one of the server's sockets
+#define WS_PUSH_QUEUE_DEPTH          2    // Messages per client queued on the httpd task at once
+#define WS_PUSH_MSG_SIZE             512  // One message with all six relays
+#define WS_PUSH_CURRENT_DEADBAND_CA  2    // Current changes below 0.02 A are not pushed on their own
+
+/**
+ * @brief Register the /ws endpoint and start the push task
+ *
+ * Messages are JSON text frames in the format of GET /api/relays, but only list
+ * the relays that changed since the client's previous message:
+ * {"seq":7,"version":12,"relays":[{"id":2,"state":true,"remaining":1799,"current_ca":0}]}
+ * The first message after connecting lists every relay. The client may send
+ * {"id":2,"state":false} to switch a relay (without "state" it toggles) and
+ * {"ack":7} to acknowledge a message, which is used to measure push latency.
+ *
+ * @param server Running HTTP server
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t ws_push_register(httpd_handle_t server);
+
+/**
+ * @brief Forget all clients and the server before it is stopped
+ *
+ * The push task stays alive and idles until ws_push_register() is called again.
+ */
+void ws_push_unregister(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WS_PUSH_H
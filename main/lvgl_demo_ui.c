@@ -9,7 +9,14 @@
 #include "relay_control_ui.h"
 #include "master_button_ui.h"
 #include "relay_hardware.h"
+#include "relay_theme.h"
+#include "relay_telemetry.h"
+#include "countdown_anim.h"
+#include "screen_manager.h"
+#include "display_idle.h"
+#include "font_subset.h"
 #include "driver/gpio.h"
+#include "esp_log.h"
 #include "hal/adc_types.h"
 #include "esp_adc/adc_oneshot.h"
 #include <string.h>
@@ -35,9 +42,28 @@ static relay_control_ui_t *relay_6_ui_obj = NULL;
 // Global pointer to IP address label
 static lv_obj_t *ip_label = NULL;
 
+static const char *TAG = "demo_ui";
+
+relay_control_ui_t *example_lvgl_get_relay_ui(int index);
+
+/**
+ * @brief Log LVGL heap usage (pool size is CONFIG_LV_MEM_SIZE_KILOBYTES)
+ */
+static void log_lvgl_heap(const char *when)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    ESP_LOGI(TAG, "LVGL heap %s: used %u of %u bytes (%u%%), max used %u, biggest free block %u, frag %u%%",
+             when, (unsigned)(mon.total_size - mon.free_size), (unsigned)mon.total_size, (unsigned)mon.used_pct,
+             (unsigned)mon.max_used, (unsigned)mon.free_biggest_size, (unsigned)mon.frag_pct);
+}
+
 /**
  * @brief Callback function called when any relay changes state
- * Updates the master button appearance based on controlled relays
+ * Schedules a master button appearance update based on controlled relays
+ * 
+ * Runs on whichever task switched the relay (LVGL, HTTP, WebSocket or the
+ * countdown timer), so the restyle itself is left to the LVGL task.
  */
 static void relay_state_changed_cb(relay_control_ui_t *relay, bool new_state)
 {
@@ -46,14 +72,39 @@ static void relay_state_changed_cb(relay_control_ui_t *relay, bool new_state)
     
     // Update master button appearance when any relay changes
     if (master_ui_obj != NULL) {
-        master_button_ui_update_appearance(master_ui_obj);
+        master_button_ui_request_update(master_ui_obj);
     }
 }
 
+/**
+ * @brief Display idle callback - stop redrawing the relay tiles while the screen is dark
+ */
+static void display_idle_suspend_cb(bool suspended, void *arg)
+{
+    (void)arg;  // Unused parameter
+
+    for (int i = 1; i <= 6; i++) {
+        relay_control_ui_t *relay = example_lvgl_get_relay_ui(i);
+        if (relay != NULL) {
+            relay_control_ui_set_suspended(relay, suspended);
+        }
+    }
+    countdown_anim_set_suspended(suspended);
+}
+
 void example_lvgl_demo_ui(lv_display_t *disp)
 {
     lv_obj_t *scr = lv_display_get_screen_active(disp);
 
+    // Shared styles are static, only the per-object style list entries come from the LVGL heap
+    relay_theme_init();
+    // Detail screens are created on demand and return to this one
+    screen_manager_init(scr);
+    // What the shared styles save per tile, measured on this build rather than estimated
+    relay_theme_log_heap_savings(scr, 6);
+    log_lvgl_heap("before dashboard");
+    font_subset_log_flash_usage();
+
     // Create the master button first
     // master_ui_obj = master_button_ui_create(scr, "master_ui", "Master", LV_ALIGN_TOP_LEFT, 20, 20);
     // if (master_ui_obj == NULL) {
@@ -85,6 +136,9 @@ void example_lvgl_demo_ui(lv_display_t *disp)
         return;
     }
     
+    // The relays registered their current sensors while being created, start sampling them
+    relay_telemetry_start();
+    
     // Set up controlled relays array for master button
     relay_control_ui_t *controlled_relays[6];
     controlled_relays[0] = relay_1_ui_obj;
@@ -104,14 +158,19 @@ void example_lvgl_demo_ui(lv_display_t *disp)
     relay_control_ui_set_state_change_callback(relay_6_ui_obj, relay_state_changed_cb, NULL);
     // Initialize master button appearance
     master_button_ui_update_appearance(master_ui_obj);
+
+    // Suspend the countdown animations and current readings while the display is dark
+    display_idle_set_suspend_callback(display_idle_suspend_cb, NULL);
     
     // Create IP address label at the bottom of the screen
     ip_label = lv_label_create(scr);
     lv_label_set_text(ip_label, "IP: --");
     lv_obj_set_style_text_color(ip_label, lv_color_hex(0x808080), LV_PART_MAIN); // Gray color
-    lv_obj_set_style_text_font(ip_label, &lv_font_montserrat_14, LV_PART_MAIN); // Small font
+    lv_obj_set_style_text_font(ip_label, font_subset_get(), LV_PART_MAIN); // Small numeric font
     lv_obj_align(ip_label, LV_ALIGN_BOTTOM_MID, 0, -5); // Center at bottom with 5px margin
     lv_obj_set_style_text_align(ip_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+
+    log_lvgl_heap("after dashboard");
 }
 
 /**
@@ -5,12 +5,18 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
 #include <unistd.h>
 #include <sys/lock.h>
 #include <sys/param.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
 #include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_panel_ops.h"
@@ -22,6 +28,16 @@
 #include "wifi_ota.h"
 #include "nvs_flash.h"
 #include "relay_control_ui.h"
+#include "rgb565_swap.h"
+#include "display_idle.h"
+#include "render_benchmark.h"
+#include "font_subset.h"
+#include "ui_metrics.h"
+#include "screen_capture.h"
+#include "countdown_anim.h"
+#include "screen_manager.h"
+#include "ui_binding.h"
+#include "task_layout.h"
 
 #if CONFIG_EXAMPLE_LCD_CONTROLLER_ILI9341
 #include "esp_lcd_ili9341.h"
@@ -52,6 +68,12 @@ static const char *TAG = "example";
 #define EXAMPLE_PIN_NUM_LCD_CS         15
 #define EXAMPLE_PIN_NUM_BK_LIGHT       3
 #define EXAMPLE_PIN_NUM_TOUCH_CS       9
+#if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_XPT2046 && CONFIG_EXAMPLE_LCD_TOUCH_IRQ_GPIO >= 0
+#define EXAMPLE_PIN_NUM_TOUCH_IRQ      CONFIG_EXAMPLE_LCD_TOUCH_IRQ_GPIO
+#define EXAMPLE_TOUCH_USE_IRQ          1 // read the touch controller only while PENIRQ reports a press
+#else
+#define EXAMPLE_TOUCH_USE_IRQ          0
+#endif
 
 // The pixel number in horizontal and vertical
 #if CONFIG_EXAMPLE_LCD_CONTROLLER_ILI9341
@@ -65,12 +87,11 @@ static const char *TAG = "example";
 #define EXAMPLE_LCD_CMD_BITS           8
 #define EXAMPLE_LCD_PARAM_BITS         8
 
-#define EXAMPLE_LVGL_DRAW_BUF_LINES    20 // number of display lines in each draw buffer
-#define EXAMPLE_LVGL_TICK_PERIOD_MS    2
-#define EXAMPLE_LVGL_TASK_MAX_DELAY_MS 500
+#define EXAMPLE_LVGL_DRAW_BUF_LINES    20 // number of display lines in each draw buffer (and each DMA bounce buffer)
 #define EXAMPLE_LVGL_TASK_MIN_DELAY_MS 1000 / CONFIG_FREERTOS_HZ
-#define EXAMPLE_LVGL_TASK_STACK_SIZE   (4 * 1024)
-#define EXAMPLE_LVGL_TASK_PRIORITY     2
+#define EXAMPLE_LVGL_TIMER_REQ_QUEUE_LEN 16 // pending "run this LVGL timer now" requests from other tasks
+#define EXAMPLE_LVGL_FLUSH_TIMEOUT_MS  100  // upper bound for one band transfer before we re-check the flag
+#define EXAMPLE_LVGL_STATS_PERIOD_MS   5000 // how often the flush statistics are logged
 
 // LVGL library is not thread-safe, this example will call LVGL APIs from different tasks, so use a mutex to protect it
 static _lock_t lvgl_api_lock;
@@ -78,20 +99,113 @@ static _lock_t lvgl_api_lock;
 extern void example_lvgl_demo_ui(lv_disp_t *disp);
 extern void example_lvgl_update_ip_address(const char *ip_str);
 extern relay_control_ui_t *example_lvgl_get_relay_ui(int index);
+void example_lvgl_port_request_timer(lv_timer_t *timer);
+
+static int64_t s_lvgl_lock_start_us = 0;
+
+/**
+ * @brief Take the LVGL API lock (records how long it is held)
+ */
+static void example_lvgl_lock(void)
+{
+    _lock_acquire(&lvgl_api_lock);
+    s_lvgl_lock_start_us = esp_timer_get_time();
+}
+
+/**
+ * @brief Release the LVGL API lock
+ */
+static void example_lvgl_unlock(void)
+{
+    ui_metrics_record(UI_METRIC_LOCK_HOLD_US, (uint32_t)(esp_timer_get_time() - s_lvgl_lock_start_us));
+    _lock_release(&lvgl_api_lock);
+}
+
+// LVGL task handle (woken by task notification) and timers other tasks asked it to run
+static TaskHandle_t s_lvgl_task = NULL;
+static QueueHandle_t s_lvgl_timer_req_queue = NULL;
+
+/**
+ * @brief Flush pipeline statistics (written from the LVGL task and the SPI done ISR)
+ */
+typedef struct {
+    volatile bool pending;          // a band is queued on the SPI bus and not finished yet
+    volatile int64_t start_us;      // when the pending band was handed to the panel IO
+    uint32_t flushes;               // bands flushed in the current report period
+    uint32_t frames;                // full refresh cycles in the current report period
+    uint64_t pixels;                // pixels sent in the current report period
+    int64_t swap_us;                // CPU time spent byte-swapping
+    int64_t transfer_us;            // SPI DMA time (queue to done interrupt)
+    volatile int64_t transfer_max_us;
+    int64_t wait_us;                // time LVGL blocked waiting for a free draw buffer
+    int64_t frame_us;               // refresh cycle time (render + flush)
+    int64_t frame_max_us;
+    int64_t frame_start_us;
+    int64_t report_start_us;
+    // per refresh cycle, exported through ui_metrics when the cycle ends
+    int64_t frame_flush_us;         // time inside the flush callback, excluding waits
+    int64_t frame_wait_us;          // time blocked on SPI DMA
+    uint32_t frame_px;              // pixels sent to the panel
+    uint32_t frame_inv_px;          // pixels invalidated since the previous cycle
+} example_flush_stats_t;
+
+static example_flush_stats_t s_flush_stats;
+static SemaphoreHandle_t s_flush_done_sem = NULL;
+// Rotation currently programmed into the panel, -1 until the first rotation is applied
+static int s_applied_rotation = -1;
+
+// Render buffers outside DMA-capable RAM (PSRAM) are flushed through two internal bounce buffers
+static bool s_flush_bounce = false;
+static uint16_t *s_bounce_buf[2];
+static size_t s_bounce_px = 0;
+static int s_bounce_next = 0;
+static SemaphoreHandle_t s_bounce_free_sem = NULL;
+
+#if CONFIG_EXAMPLE_LCD_TOUCH_ENABLED
+/**
+ * @brief Touch input statistics (written from the LVGL task and the PENIRQ ISR)
+ */
+typedef struct {
+    uint32_t irqs;                  // PENIRQ edges in the current report period
+    uint32_t reads;                 // touch controller reads over SPI in the current report period
+    int64_t bus_wait_us;            // time touch reads waited for a band to leave the bus
+    volatile int64_t irq_us;        // time of the PENIRQ edge not yet reported as a press, 0 if none
+} example_touch_stats_t;
+
+static example_touch_stats_t s_touch_stats;
+#endif
 
 static bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
 {
     lv_display_t *disp = (lv_display_t *)user_ctx;
+    int64_t transfer_us = esp_timer_get_time() - s_flush_stats.start_us;
+    s_flush_stats.transfer_us += transfer_us;
+    if (transfer_us > s_flush_stats.transfer_max_us) {
+        s_flush_stats.transfer_max_us = transfer_us;
+    }
+
+    BaseType_t high_task_wakeup = pdFALSE;
+    if (s_flush_bounce) {
+        // LVGL got its render buffer back in the flush callback, only a bounce buffer is free now
+        xSemaphoreGiveFromISR(s_bounce_free_sem, &high_task_wakeup);
+        return high_task_wakeup == pdTRUE;
+    }
+    s_flush_stats.pending = false;
     lv_display_flush_ready(disp);
-    return false;
+    xSemaphoreGiveFromISR(s_flush_done_sem, &high_task_wakeup);
+    return high_task_wakeup == pdTRUE;
 }
 
-/* Rotate display and touch, when rotated screen in LVGL. Called when driver parameters are updated. */
+/* Rotate display and touch, when rotated screen in LVGL. Only talks to the panel when the rotation really changed. */
 static void example_lvgl_port_update_callback(lv_display_t *disp)
 {
     esp_lcd_panel_handle_t panel_handle = lv_display_get_user_data(disp);
     lv_display_rotation_t rotation = lv_display_get_rotation(disp);
 
+    if ((int)rotation == s_applied_rotation) {
+        return;
+    }
+
     switch (rotation) {
     case LV_DISPLAY_ROTATION_0:
         // Rotate LCD display
@@ -114,23 +228,303 @@ static void example_lvgl_port_update_callback(lv_display_t *disp)
         esp_lcd_panel_mirror(panel_handle, false, false);
         break;
     }
+    s_applied_rotation = (int)rotation;
+    ESP_LOGI(TAG, "Panel rotation applied: %d", s_applied_rotation);
+}
+
+/**
+ * @brief Display event callback - applies rotation changes and collects per-frame timing
+ */
+static void example_lvgl_display_event_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_RESOLUTION_CHANGED) {
+        // Fired by lv_display_set_rotation(), the only place the panel orientation may change
+        example_lvgl_port_update_callback(disp);
+    } else if (code == LV_EVENT_INVALIDATE_AREA) {
+        const lv_area_t *area = lv_event_get_param(e);
+        if (area != NULL) {
+            s_flush_stats.frame_inv_px += lv_area_get_size(area);
+        }
+    } else if (code == LV_EVENT_REFR_START) {
+        s_flush_stats.frame_start_us = esp_timer_get_time();
+        s_flush_stats.frame_flush_us = 0;
+        s_flush_stats.frame_wait_us = 0;
+        s_flush_stats.frame_px = 0;
+    } else if (code == LV_EVENT_REFR_READY) {
+        int64_t now = esp_timer_get_time();
+        if (s_flush_stats.flushes == 0 && s_flush_stats.frames == 0) {
+            s_flush_stats.report_start_us = now;
+        }
+        if (s_flush_stats.frame_px > 0) {
+            int64_t frame_us = now - s_flush_stats.frame_start_us;
+            ui_metrics_record(UI_METRIC_FRAME_US, (uint32_t)frame_us);
+            ui_metrics_record(UI_METRIC_RENDER_US, (uint32_t)(frame_us - s_flush_stats.frame_flush_us - s_flush_stats.frame_wait_us));
+            ui_metrics_record(UI_METRIC_FLUSH_US, (uint32_t)s_flush_stats.frame_flush_us);
+            ui_metrics_record(UI_METRIC_SPI_WAIT_US, (uint32_t)s_flush_stats.frame_wait_us);
+            ui_metrics_record(UI_METRIC_FLUSH_BYTES, s_flush_stats.frame_px * sizeof(uint16_t));
+            ui_metrics_record(UI_METRIC_INVALID_AREA_PX, s_flush_stats.frame_inv_px);
+            s_flush_stats.frame_inv_px = 0;
+        }
+        // Only count refresh cycles that actually sent something to the panel
+        if (s_flush_stats.flushes > 0) {
+            int64_t frame_us = now - s_flush_stats.frame_start_us;
+            s_flush_stats.frames++;
+            s_flush_stats.frame_us += frame_us;
+            if (frame_us > s_flush_stats.frame_max_us) {
+                s_flush_stats.frame_max_us = frame_us;
+            }
+        }
+        if (s_flush_stats.frames > 0 && now - s_flush_stats.report_start_us >= EXAMPLE_LVGL_STATS_PERIOD_MS * 1000) {
+            ESP_LOGI(TAG, "flush: %"PRIu32" frames, %"PRIu32" bands, %"PRIu64" px | frame avg %"PRId64" us max %"PRId64" us | "
+                     "swap avg %"PRId64" us | dma avg %"PRId64" us max %"PRId64" us | buffer wait %"PRId64" us",
+                     s_flush_stats.frames, s_flush_stats.flushes, s_flush_stats.pixels,
+                     s_flush_stats.frame_us / s_flush_stats.frames, s_flush_stats.frame_max_us,
+                     s_flush_stats.swap_us / s_flush_stats.flushes,
+                     s_flush_stats.transfer_us / s_flush_stats.flushes, s_flush_stats.transfer_max_us,
+                     s_flush_stats.wait_us);
+            ui_binding_stats_t binding_stats;
+            ui_binding_get_stats(&binding_stats);
+            font_subset_stats_t font_stats;
+            font_subset_get_stats(&font_stats);
+            countdown_anim_stats_t countdown_stats;
+            countdown_anim_get_stats(&countdown_stats);
+#if CONFIG_EXAMPLE_LCD_TOUCH_ENABLED
+            // compare the flush line above between periods with and without touch reads
+            ESP_LOGI(TAG, "touch: %"PRIu32" PENIRQ edges, %"PRIu32" controller reads, %"PRId64" us waiting for the bus | dma %"PRIu64" KB/s",
+                     s_touch_stats.irqs, s_touch_stats.reads, s_touch_stats.bus_wait_us,
+                     s_flush_stats.transfer_us > 0 ? (s_flush_stats.pixels * sizeof(uint16_t) * 1000) / (uint64_t)s_flush_stats.transfer_us : 0);
+            s_touch_stats.irqs = 0;
+            s_touch_stats.reads = 0;
+            s_touch_stats.bus_wait_us = 0;
+#endif
+            ESP_LOGI(TAG, "widget updates: %"PRIu32" applied, %"PRIu32" skipped | glyph cache: %"PRIu32" hits, %"PRIu32" misses (total since boot)",
+                     binding_stats.applied, binding_stats.skipped, font_stats.hits, font_stats.misses);
+            ESP_LOGI(TAG, "countdown bars: %"PRIu32" frames, %"PRIu32" bar redraws, %"PRIu32" colour changes (total since boot)",
+                     countdown_stats.frames, countdown_stats.bar_updates, countdown_stats.color_changes);
+            screen_manager_stats_t screen_stats;
+            screen_manager_get_stats(&screen_stats);
+            ESP_LOGI(TAG, "screens: %"PRIu32" live, %"PRIu32" created, %"PRIu32" evicted, transition max %"PRIu32" us, LVGL heap peak %"PRIu32" bytes",
+                     screen_stats.live, screen_stats.created, screen_stats.evicted, screen_stats.max_transition_us, screen_stats.peak_heap_used);
+            s_flush_stats.flushes = 0;
+            s_flush_stats.frames = 0;
+            s_flush_stats.pixels = 0;
+            s_flush_stats.swap_us = 0;
+            s_flush_stats.transfer_us = 0;
+            s_flush_stats.transfer_max_us = 0;
+            s_flush_stats.wait_us = 0;
+            s_flush_stats.frame_us = 0;
+            s_flush_stats.frame_max_us = 0;
+            s_flush_stats.report_start_us = now;
+        }
+    }
+}
+
+/**
+ * @brief Block the LVGL task until the band on the bus is done
+ *
+ * LVGL renders the next band into the second buffer while the first one is on the bus,
+ * and only calls this when it needs that buffer back. Sleeping on a semaphore instead of
+ * spinning on the flushing flag leaves the CPU to the other tasks in the meantime.
+ */
+static void example_lvgl_flush_wait_cb(lv_display_t *disp)
+{
+    (void)disp;
+    int64_t wait_start = esp_timer_get_time();
+    while (s_flush_stats.pending) {
+        xSemaphoreTake(s_flush_done_sem, pdMS_TO_TICKS(EXAMPLE_LVGL_FLUSH_TIMEOUT_MS));
+    }
+    int64_t wait_us = esp_timer_get_time() - wait_start;
+    s_flush_stats.wait_us += wait_us;
+    s_flush_stats.frame_wait_us += wait_us;
+}
+
+/**
+ * @brief First pixel of a flushed area and the byte distance between its rows
+ *
+ * Decided from the display's render mode, not the Kconfig option: direct mode
+ * falls back to partial bands when the frame buffers cannot be allocated.
+ */
+static const uint8_t *example_lvgl_area_pixels(lv_display_t *disp, const lv_area_t *area, const uint8_t *px_map, size_t *stride)
+{
+    if (lv_display_get_render_mode(disp) == LV_DISPLAY_RENDER_MODE_DIRECT) {
+        // Direct mode passes the whole frame, the area is at its screen position
+        *stride = lv_draw_buf_width_to_stride(lv_display_get_horizontal_resolution(disp), LV_COLOR_FORMAT_RGB565);
+        return px_map + area->y1 * *stride + area->x1 * sizeof(uint16_t);
+    }
+    *stride = lv_area_get_width(area) * sizeof(uint16_t);
+    return px_map;
+}
+
+/**
+ * @brief Flush a PSRAM render buffer through the internal DMA bounce buffers
+ *
+ * Each band of the area is copied into whichever bounce buffer is free, byte-swapped there
+ * and queued. The render buffer is not touched by DMA, so LVGL gets it back on return.
+ */
+static void example_lvgl_flush_bounce(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    esp_lcd_panel_handle_t panel_handle = lv_display_get_user_data(disp);
+    int32_t width = lv_area_get_width(area);
+    size_t src_stride;
+    const uint8_t *src = example_lvgl_area_pixels(disp, area, px_map, &src_stride);
+    int32_t band_lines = MAX((int32_t)(s_bounce_px / width), 1);
+
+    for (int32_t y = area->y1; y <= area->y2; y += band_lines) {
+        int32_t lines = MIN(band_lines, area->y2 + 1 - y);
+        uint32_t px_count = width * lines;
+
+        int64_t wait_start = esp_timer_get_time();
+        xSemaphoreTake(s_bounce_free_sem, pdMS_TO_TICKS(EXAMPLE_LVGL_FLUSH_TIMEOUT_MS));
+        int64_t copy_start = esp_timer_get_time();
+        s_flush_stats.wait_us += copy_start - wait_start;
+        s_flush_stats.frame_wait_us += copy_start - wait_start;
+
+        uint16_t *dst = s_bounce_buf[s_bounce_next];
+        s_bounce_next ^= 1;
+        const uint8_t *row = src + (y - area->y1) * src_stride;
+        if (src_stride == width * sizeof(uint16_t)) {
+            memcpy(dst, row, px_count * sizeof(uint16_t));
+        } else {
+            for (int32_t i = 0; i < lines; i++) {
+                memcpy(dst + i * width, row + i * src_stride, width * sizeof(uint16_t));
+            }
+        }
+        // because SPI LCD is big-endian, we need to swap the RGB bytes order
+        rgb565_swap(dst, px_count);
+        int64_t queue_time = esp_timer_get_time();
+
+        s_flush_stats.swap_us += queue_time - copy_start;
+        s_flush_stats.frame_flush_us += queue_time - copy_start;
+        s_flush_stats.pixels += px_count;
+        s_flush_stats.frame_px += px_count;
+        s_flush_stats.flushes++;
+        s_flush_stats.start_us = queue_time;
+        if (esp_lcd_panel_draw_bitmap(panel_handle, area->x1, y, area->x2 + 1, y + lines, dst) != ESP_OK) {
+            xSemaphoreGive(s_bounce_free_sem);
+        }
+    }
+    lv_display_flush_ready(disp);
 }
 
 static void example_lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
 {
-    example_lvgl_port_update_callback(disp);
+    // A screen capture encodes the band while it is still in native byte order
+    if (screen_capture_is_active()) {
+        size_t stride;
+        const uint8_t *px = example_lvgl_area_pixels(disp, area, px_map, &stride);
+        screen_capture_add_rows(area, px, stride);
+    }
+
+    if (s_flush_bounce) {
+        example_lvgl_flush_bounce(disp, area, px_map);
+        return;
+    }
+
+    // Rotation is applied from LV_EVENT_RESOLUTION_CHANGED: sending swap_xy/mirror here would
+    // force the panel IO to drain the queued color transfer before every band
     esp_lcd_panel_handle_t panel_handle = lv_display_get_user_data(disp);
     int offsetx1 = area->x1;
     int offsetx2 = area->x2;
     int offsety1 = area->y1;
     int offsety2 = area->y2;
+    uint32_t px_count = (offsetx2 + 1 - offsetx1) * (offsety2 + 1 - offsety1);
+
+    int64_t swap_start = esp_timer_get_time();
     // because SPI LCD is big-endian, we need to swap the RGB bytes order
-    lv_draw_sw_rgb565_swap(px_map, (offsetx2 + 1 - offsetx1) * (offsety2 + 1 - offsety1));
-    // copy a buffer's content to a specific area of the display
-    esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, px_map);
+    rgb565_swap(px_map, px_count);
+    int64_t queue_time = esp_timer_get_time();
+
+    s_flush_stats.swap_us += queue_time - swap_start;
+    s_flush_stats.pixels += px_count;
+    s_flush_stats.frame_px += px_count;
+    s_flush_stats.flushes++;
+    s_flush_stats.start_us = queue_time;
+    s_flush_stats.pending = true;
+    // copy a buffer's content to a specific area of the display, returns once the transfer is queued
+    if (esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, px_map) != ESP_OK) {
+        s_flush_stats.pending = false;
+        lv_display_flush_ready(disp);
+    }
+    s_flush_stats.frame_flush_us += esp_timer_get_time() - swap_start;
 }
 
 #if CONFIG_EXAMPLE_LCD_TOUCH_ENABLED
+// Set while the touch that woke the display is still held down
+static bool s_touch_swallowed = false;
+
+/**
+ * @brief Wait until no pixel band is on the SPI bus (LVGL task only)
+ *
+ * The touch controller shares the bus with the panel. Without this, a touch read issued
+ * while a band is still transferring blocks inside the SPI driver until the band's DMA
+ * finishes. Waiting here on the flush-done signals instead keeps every band in one piece
+ * and places the touch read in the gap between bands. No new band can be queued while
+ * the touch read holds the bus, since both run in the LVGL task.
+ *
+ * @return int64_t Time spent waiting in microseconds
+ */
+static int64_t example_lvgl_wait_bus_idle(void)
+{
+    int64_t wait_start = esp_timer_get_time();
+    if (s_flush_bounce) {
+        // Both bounce buffers free means nothing is queued, hand them straight back
+        int taken = 0;
+        while (taken < 2 && xSemaphoreTake(s_bounce_free_sem, pdMS_TO_TICKS(EXAMPLE_LVGL_FLUSH_TIMEOUT_MS)) == pdTRUE) {
+            taken++;
+        }
+        while (taken-- > 0) {
+            xSemaphoreGive(s_bounce_free_sem);
+        }
+    } else {
+        while (s_flush_stats.pending) {
+            xSemaphoreTake(s_flush_done_sem, pdMS_TO_TICKS(EXAMPLE_LVGL_FLUSH_TIMEOUT_MS));
+        }
+    }
+    return esp_timer_get_time() - wait_start;
+}
+
+#if EXAMPLE_TOUCH_USE_IRQ
+// Input read timer of the touch indev, paused while the panel is not pressed
+static lv_timer_t *s_touch_read_timer = NULL;
+
+/**
+ * @brief PENIRQ falling edge - a press started, let the LVGL task read the controller
+ *
+ * The interrupt stays disabled while the panel is read: the XPT2046 pulls PENIRQ around
+ * its own conversions, which would otherwise retrigger it on every read.
+ */
+static void example_touch_irq_cb(esp_lcd_touch_handle_t tp)
+{
+    (void)tp;
+    gpio_intr_disable(EXAMPLE_PIN_NUM_TOUCH_IRQ);
+    s_touch_stats.irqs++;
+    s_touch_stats.irq_us = esp_timer_get_time();
+    example_lvgl_port_request_timer(s_touch_read_timer);
+}
+
+/**
+ * @brief Finger lifted - stop reading and wait for the next PENIRQ edge
+ */
+static void example_touch_irq_rearm(lv_indev_t *indev)
+{
+    // A scroll still coasting needs the input reads to finish its throw
+    if (lv_indev_get_scroll_obj(indev) != NULL) {
+        return;
+    }
+    s_touch_stats.irq_us = 0;
+    gpio_intr_enable(EXAMPLE_PIN_NUM_TOUCH_IRQ);
+    // A press that began before the interrupt was enabled has no edge left to report it
+    if (gpio_get_level(EXAMPLE_PIN_NUM_TOUCH_IRQ) == 0) {
+        gpio_intr_disable(EXAMPLE_PIN_NUM_TOUCH_IRQ);
+        return;
+    }
+    lv_timer_pause(s_touch_read_timer);
+}
+#endif
+
 static void example_lvgl_touch_cb(lv_indev_t *indev, lv_indev_data_t *data)
 {
     uint16_t touchpad_x[1] = {0};
@@ -138,39 +532,134 @@ static void example_lvgl_touch_cb(lv_indev_t *indev, lv_indev_data_t *data)
     uint8_t touchpad_cnt = 0;
 
     esp_lcd_touch_handle_t touch_pad = lv_indev_get_user_data(indev);
+    int64_t bus_wait_us = example_lvgl_wait_bus_idle();
+    s_touch_stats.bus_wait_us += bus_wait_us;
+    s_touch_stats.reads++;
+    ui_metrics_record(UI_METRIC_TOUCH_BUS_WAIT_US, (uint32_t)bus_wait_us);
     esp_lcd_touch_read_data(touch_pad);
     /* Get coordinates */
     bool touchpad_pressed = esp_lcd_touch_get_coordinates(touch_pad, touchpad_x, touchpad_y, NULL, &touchpad_cnt, 1);
 
     if (touchpad_pressed && touchpad_cnt > 0) {
+        // A touch on a dark display only wakes it; hide the press until the finger is lifted
+        if (display_idle_touch()) {
+            s_touch_swallowed = true;
+        }
         data->point.x = touchpad_x[0];
         data->point.y = touchpad_y[0];
-        data->state = LV_INDEV_STATE_PRESSED;
+        data->state = s_touch_swallowed ? LV_INDEV_STATE_RELEASED : LV_INDEV_STATE_PRESSED;
+#if EXAMPLE_TOUCH_USE_IRQ
+        // LVGL dispatches the press right after this callback returns
+        int64_t irq_us = s_touch_stats.irq_us;
+        if (irq_us != 0) {
+            ui_metrics_record(UI_METRIC_TOUCH_LATENCY_US, (uint32_t)(esp_timer_get_time() - irq_us));
+            s_touch_stats.irq_us = 0;
+        }
+#endif
     } else {
+        s_touch_swallowed = false;
         data->state = LV_INDEV_STATE_RELEASED;
+#if EXAMPLE_TOUCH_USE_IRQ
+        example_touch_irq_rearm(indev);
+#endif
     }
 }
 #endif
 
-static void example_increase_lvgl_tick(void *arg)
+static uint32_t example_lvgl_tick_get_cb(void)
+{
+    /* LVGL reads the time on demand, so no periodic tick interrupt is needed */
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief Wake the LVGL task so it re-evaluates its timers (task or ISR context)
+ */
+void example_lvgl_port_wake(void)
+{
+    if (s_lvgl_task == NULL) {
+        return;
+    }
+    if (xPortInIsrContext()) {
+        BaseType_t high_task_wakeup = pdFALSE;
+        vTaskNotifyGiveFromISR(s_lvgl_task, &high_task_wakeup);
+        portYIELD_FROM_ISR(high_task_wakeup);
+    } else {
+        xTaskNotifyGive(s_lvgl_task);
+    }
+}
+
+/**
+ * @brief Ask the LVGL task to resume and run an LVGL timer on its next pass
+ *
+ * LVGL timers must not be touched outside the LVGL lock, so the request is queued
+ * and applied by the LVGL task itself. Safe to call from any task or ISR.
+ */
+void example_lvgl_port_request_timer(lv_timer_t *timer)
 {
-    /* Tell LVGL how many milliseconds has elapsed */
-    lv_tick_inc(EXAMPLE_LVGL_TICK_PERIOD_MS);
+    if (timer == NULL || s_lvgl_timer_req_queue == NULL) {
+        return;
+    }
+    if (xPortInIsrContext()) {
+        // example_lvgl_port_wake() below does the yield
+        xQueueSendFromISR(s_lvgl_timer_req_queue, &timer, NULL);
+    } else if (xQueueSend(s_lvgl_timer_req_queue, &timer, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "LVGL timer request queue full");
+    }
+    example_lvgl_port_wake();
 }
 
 static void example_lvgl_port_task(void *arg)
 {
     ESP_LOGI(TAG, "Starting LVGL task");
     uint32_t time_till_next_ms = 0;
+    uint32_t wakeups = 0;
+    int64_t busy_us = 0;
+    int64_t report_start_us = esp_timer_get_time();
     while (1) {
-        _lock_acquire(&lvgl_api_lock);
+        int64_t start_us = esp_timer_get_time();
+        example_lvgl_lock();
+        lv_timer_t *timer = NULL;
+        while (xQueueReceive(s_lvgl_timer_req_queue, &timer, 0) == pdTRUE) {
+            lv_timer_resume(timer);
+            lv_timer_ready(timer);
+        }
+        int64_t handler_start_us = esp_timer_get_time();
         time_till_next_ms = lv_timer_handler();
-        _lock_release(&lvgl_api_lock);
-        // in case of triggering a task watch dog time out
-        time_till_next_ms = MAX(time_till_next_ms, EXAMPLE_LVGL_TASK_MIN_DELAY_MS);
-        // in case of lvgl display not ready yet
-        time_till_next_ms = MIN(time_till_next_ms, EXAMPLE_LVGL_TASK_MAX_DELAY_MS);
-        usleep(1000 * time_till_next_ms);
+        ui_metrics_record(UI_METRIC_TIMER_HANDLER_US, (uint32_t)(esp_timer_get_time() - handler_start_us));
+        example_lvgl_unlock();
+
+        int64_t now = esp_timer_get_time();
+        wakeups++;
+        busy_us += now - start_us;
+        if (now - report_start_us >= EXAMPLE_LVGL_STATS_PERIOD_MS * 1000) {
+            display_idle_stats_t idle_stats;
+            display_idle_get_stats(&idle_stats);
+            task_layout_window_t load;
+            task_layout_get_window(&load);
+            ESP_LOGI(TAG, "LVGL task: %"PRIu32" wakeups, busy %"PRId64" us in %"PRId64" ms | display %s, dark %"PRIu64" of %"PRIu64" s",
+                     wakeups, busy_us, (now - report_start_us) / 1000, idle_stats.dark ? "dark" : "on",
+                     idle_stats.dark_ms / 1000, idle_stats.uptime_ms / 1000);
+            ESP_LOGI(TAG, "cores: 0 busy %u%%, 1 busy %u%% | LVGL wake-up up to %"PRIu32" us late",
+                     load.busy_pct[0], load.busy_pct[1], load.ui_late_max_us);
+            wakeups = 0;
+            busy_us = 0;
+            report_start_us = now;
+        }
+
+        // Sleep until the next LVGL timer is due or someone has new work for us.
+        // LV_NO_TIMER_READY means every timer is paused (nothing animating, nothing dirty).
+        TickType_t wait_ticks = portMAX_DELAY;
+        if (time_till_next_ms != LV_NO_TIMER_READY) {
+            // in case of triggering a task watch dog time out
+            time_till_next_ms = MAX(time_till_next_ms, EXAMPLE_LVGL_TASK_MIN_DELAY_MS);
+            wait_ticks = pdMS_TO_TICKS(time_till_next_ms);
+        }
+        TickType_t due_tick = xTaskGetTickCount() + wait_ticks;
+        if (ulTaskNotifyTake(pdTRUE, wait_ticks) == 0 && wait_ticks != portMAX_DELAY) {
+            // Woke for an LVGL timer: anything past the tick that ended the sleep is UI jitter
+            task_layout_record_ui_wakeup(due_tick);
+        }
     }
 }
 
@@ -184,6 +673,9 @@ void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
 
+    // Log the task placement and start sampling per-core load before any of the tasks exist
+    ESP_ERROR_CHECK(task_layout_start());
+
     // Initialize WiFi and OTA (optional - configure with your WiFi credentials)
     // Uncomment and configure these lines to enable WiFi/OTA:
     
@@ -216,11 +708,8 @@ void app_main(void)
     
 
     ESP_LOGI(TAG, "Turn off LCD backlight");
-    gpio_config_t bk_gpio_config = {
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = 1ULL << EXAMPLE_PIN_NUM_BK_LIGHT
-    };
-    ESP_ERROR_CHECK(gpio_config(&bk_gpio_config));
+    // Backlight is driven by LEDC PWM so it can be dimmed and faded out when idle
+    ESP_ERROR_CHECK(display_idle_backlight_init(EXAMPLE_PIN_NUM_BK_LIGHT, EXAMPLE_LCD_BK_LIGHT_ON_LEVEL));
 
     ESP_LOGI(TAG, "Initialize SPI bus");
     spi_bus_config_t buscfg = {
@@ -272,44 +761,99 @@ void app_main(void)
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel_handle, true));
 
     ESP_LOGI(TAG, "Turn on LCD backlight");
-    gpio_set_level(EXAMPLE_PIN_NUM_BK_LIGHT, EXAMPLE_LCD_BK_LIGHT_ON_LEVEL);
+    display_idle_backlight_set(CONFIG_EXAMPLE_LCD_BACKLIGHT_DUTY_PCT);
 
     ESP_LOGI(TAG, "Initialize LVGL library");
     lv_init();
 
+    // pick the fastest bit-exact byte swap kernel for the flush path
+    rgb565_swap_init();
+
     // create a lvgl display
     lv_display_t *display = lv_display_create(EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES);
 
     // alloc draw buffers used by LVGL
     // it's recommended to choose the size of the draw buffer(s) to be at least 1/10 screen sized
     size_t draw_buffer_sz = EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_DRAW_BUF_LINES * sizeof(lv_color16_t);
-
-    void *buf1 = spi_bus_dma_memory_alloc(LCD_HOST, draw_buffer_sz, 0);
-    assert(buf1);
-    void *buf2 = spi_bus_dma_memory_alloc(LCD_HOST, draw_buffer_sz, 0);
-    assert(buf2);
+    void *buf1 = NULL;
+    void *buf2 = NULL;
+    lv_display_render_mode_t render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
+    const char *render_config = "partial, internal";
+#if CONFIG_EXAMPLE_LVGL_RENDER_DIRECT
+    // one full frame is enough: the flush copies it out before LVGL may draw into it again
+    size_t frame_sz = EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES * sizeof(lv_color16_t);
+    buf1 = heap_caps_malloc(frame_sz, MALLOC_CAP_SPIRAM);
+    if (buf1 != NULL) {
+        draw_buffer_sz = frame_sz;
+        render_mode = LV_DISPLAY_RENDER_MODE_DIRECT;
+        render_config = "direct, PSRAM frame";
+    }
+#elif CONFIG_EXAMPLE_LVGL_RENDER_PSRAM_PARTIAL
+    size_t band_sz = EXAMPLE_LCD_H_RES * CONFIG_EXAMPLE_LVGL_PSRAM_BUF_LINES * sizeof(lv_color16_t);
+    buf1 = heap_caps_malloc(band_sz, MALLOC_CAP_SPIRAM);
+    buf2 = heap_caps_malloc(band_sz, MALLOC_CAP_SPIRAM);
+    if (buf1 != NULL && buf2 != NULL) {
+        draw_buffer_sz = band_sz;
+        render_config = "partial, PSRAM bands";
+    } else {
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+        buf1 = NULL;
+        buf2 = NULL;
+    }
+#endif
+    if (buf1 == NULL) {
+#if !CONFIG_EXAMPLE_LVGL_RENDER_PARTIAL
+        ESP_LOGW(TAG, "PSRAM render buffers unavailable, falling back to internal partial bands");
+#endif
+        buf1 = spi_bus_dma_memory_alloc(LCD_HOST, draw_buffer_sz, 0);
+        assert(buf1);
+        buf2 = spi_bus_dma_memory_alloc(LCD_HOST, draw_buffer_sz, 0);
+        assert(buf2);
+    }
+    // buffers the SPI DMA can't read are copied into internal bounce buffers on flush
+    s_flush_bounce = !esp_ptr_dma_capable(buf1);
+    if (s_flush_bounce) {
+        s_bounce_px = EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_DRAW_BUF_LINES;
+        s_bounce_buf[0] = spi_bus_dma_memory_alloc(LCD_HOST, s_bounce_px * sizeof(uint16_t), 0);
+        assert(s_bounce_buf[0]);
+        s_bounce_buf[1] = spi_bus_dma_memory_alloc(LCD_HOST, s_bounce_px * sizeof(uint16_t), 0);
+        assert(s_bounce_buf[1]);
+        s_bounce_free_sem = xSemaphoreCreateCounting(2, 2);
+        assert(s_bounce_free_sem);
+    }
+    ESP_LOGI(TAG, "LVGL render buffers: %s, %u bytes each%s", render_config, (unsigned)draw_buffer_sz,
+             s_flush_bounce ? ", flushed via DMA bounce buffers" : "");
     // initialize LVGL draw buffers
-    lv_display_set_buffers(display, buf1, buf2, draw_buffer_sz, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_buffers(display, buf1, buf2, draw_buffer_sz, render_mode);
     // associate the mipi panel handle to the display
     lv_display_set_user_data(display, panel_handle);
     // set color depth
     lv_display_set_color_format(display, LV_COLOR_FORMAT_RGB565);
     // set the callback which can copy the rendered image to an area of the display
     lv_display_set_flush_cb(display, example_lvgl_flush_cb);
+    // sleep instead of spinning while both draw buffers are busy
+    s_flush_done_sem = xSemaphoreCreateBinary();
+    assert(s_flush_done_sem);
+    lv_display_set_flush_wait_cb(display, example_lvgl_flush_wait_cb);
+    // rotation changes and frame timing are handled from display events
+    lv_display_add_event_cb(display, example_lvgl_display_event_cb, LV_EVENT_ALL, NULL);
+    // go dark after the configured time without touch
+    display_idle_start(display);
+    // screen captures for the HTTP API are rendered by the LVGL task
+    ESP_ERROR_CHECK(screen_capture_init(display));
     
     // Set initial display rotation to 90 degrees
     lv_display_set_rotation(display, LV_DISPLAY_ROTATION_90);
     example_lvgl_port_update_callback(display);
+    if (render_mode == LV_DISPLAY_RENDER_MODE_DIRECT) {
+        // the frame buffer's stride follows the resolution, re-apply it for the rotated width
+        lv_display_set_buffers(display, buf1, buf2, draw_buffer_sz, render_mode);
+    }
 
-    ESP_LOGI(TAG, "Install LVGL tick timer");
-    // Tick interface for LVGL (using esp_timer to generate 2ms periodic event)
-    const esp_timer_create_args_t lvgl_tick_timer_args = {
-        .callback = &example_increase_lvgl_tick,
-        .name = "lvgl_tick"
-    };
-    esp_timer_handle_t lvgl_tick_timer = NULL;
-    ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000));
+    ESP_LOGI(TAG, "Install LVGL tick source");
+    // Tick interface for LVGL (read from esp_timer on demand, no periodic interrupt)
+    lv_tick_set_cb(example_lvgl_tick_get_cb);
 
     ESP_LOGI(TAG, "Register io panel event callback for LVGL flush ready notification");
     const esp_lcd_panel_io_callbacks_t cbs = {
@@ -333,7 +877,11 @@ void app_main(void)
         .x_max = EXAMPLE_LCD_H_RES,
         .y_max = EXAMPLE_LCD_V_RES,
         .rst_gpio_num = -1,
+#if EXAMPLE_TOUCH_USE_IRQ
+        .int_gpio_num = EXAMPLE_PIN_NUM_TOUCH_IRQ,
+#else
         .int_gpio_num = -1,
+#endif
         .flags = {
             .swap_xy = 0,
             .mirror_x = 0,
@@ -356,18 +904,40 @@ void app_main(void)
     lv_indev_set_display(indev, display);
     lv_indev_set_user_data(indev, tp);
     lv_indev_set_read_cb(indev, example_lvgl_touch_cb);
+#if EXAMPLE_TOUCH_USE_IRQ
+    // The indev only polls the controller between a PENIRQ edge and the release
+    s_touch_read_timer = lv_indev_get_read_timer(indev);
+    lv_timer_pause(s_touch_read_timer);
+    ESP_ERROR_CHECK(gpio_set_pull_mode(EXAMPLE_PIN_NUM_TOUCH_IRQ, GPIO_PULLUP_ONLY));
+    ESP_ERROR_CHECK(esp_lcd_touch_register_interrupt_callback(tp, example_touch_irq_cb));
+    ESP_LOGI(TAG, "Touch read on PENIRQ (GPIO %d)", EXAMPLE_PIN_NUM_TOUCH_IRQ);
+#endif
 #endif
 
     ESP_LOGI(TAG, "Create LVGL task");
-    xTaskCreate(example_lvgl_port_task, "LVGL", EXAMPLE_LVGL_TASK_STACK_SIZE, NULL, EXAMPLE_LVGL_TASK_PRIORITY, NULL);
+    s_lvgl_timer_req_queue = xQueueCreate(EXAMPLE_LVGL_TIMER_REQ_QUEUE_LEN, sizeof(lv_timer_t *));
+    assert(s_lvgl_timer_req_queue);
+    // UI core, away from WiFi and firmware uploads
+    ESP_ERROR_CHECK(task_layout_create(TASK_ROLE_LVGL, example_lvgl_port_task, NULL, &s_lvgl_task));
 
     ESP_LOGI(TAG, "Display LVGL Meter Widget");
     // Lock the mutex due to the LVGL APIs are not thread-safe
     // fill the screen with black
+#if CONFIG_EXAMPLE_LVGL_RENDER_BENCHMARK
+    // time full and incremental redraws with the selected render buffers, leave the results up for a moment
+    example_lvgl_lock();
+    render_benchmark_run(display, render_config);
+    example_lvgl_unlock();
+    vTaskDelay(pdMS_TO_TICKS(RENDER_BENCHMARK_SHOW_MS));
+    example_lvgl_lock();
+    render_benchmark_close();
+    example_lvgl_unlock();
+#endif
+
     lv_obj_t *scr = lv_disp_get_scr_act(display);
     lv_obj_set_style_bg_color(scr, lv_color_black(), LV_PART_MAIN);
     lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, LV_PART_MAIN);
-    _lock_acquire(&lvgl_api_lock);
+    example_lvgl_lock();
     example_lvgl_demo_ui(display);
     
     // Update IP address on screen if WiFi is connected
@@ -382,5 +952,7 @@ void app_main(void)
         example_lvgl_update_ip_address(NULL);
     }
     
-    _lock_release(&lvgl_api_lock);
+    example_lvgl_unlock();
+    // The LVGL task may be sleeping indefinitely, let it render the new screen
+    example_lvgl_port_wake();
 }
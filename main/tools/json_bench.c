@@ -0,0 +1,197 @@
+/*
+ * Host benchmark of the API JSON reader and writer (components/json_stream)
+ *
+ * Build and run from the repository root:
+ *
+ *     cc -O2 -Imain/components/json_stream main/tools/json_bench.c \
+ *        main/components/json_stream/json_stream.c -o json_bench && ./json_bench
+ *
+ * Parses the request bodies the API and /ws receive, whole and split into
+ * small receives, and writes the /api/relays response into one buffer and in
+ * small chunks, next to the snprintf code it replaced. Numbers from a desktop
+ * CPU only compare the variants; the ESP32-S3 is one to two orders slower.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "json_stream.h"
+
+#define BENCH_ROUNDS  200000
+
+static const char *bodies[] = {
+    "{\"state\":true}",
+    "{\"state\": false}",
+    "{\"ack\":123456}",
+    "{ \"id\" : 4, \"state\" : true, \"note\" : \"from \\\"the\\\" web UI\", \"tags\": [1, 2, 3] }",
+};
+
+// Must not parse: root primitives and strings, trailing garbage, unclosed containers
+static const char *rejected[] = {
+    "\"x\"",
+    "1",
+    "true",
+    "{\"state\":true} x",
+    "{\"state\":true}{}",
+    "{\"state\":true",
+    "[1,]",
+};
+
+static volatile size_t sink_bytes;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, double elapsed, size_t bytes)
+{
+    printf("%-40s %8.1f ns/doc %8.1f MB/s\n", name, elapsed / BENCH_ROUNDS * 1e9, bytes / elapsed / 1e6);
+}
+
+/**
+ * @brief Parse one body, fed in receives of at most chunk bytes
+ *
+ * Like api_read_json(), the whole body is fed, so trailing whitespace is checked too.
+ */
+static json_status_t parse(const char *body, size_t len, size_t chunk, json_reader_t *reader)
+{
+    json_reader_init(reader);
+    json_status_t status = JSON_PARTIAL;
+    for (size_t off = 0; off < len && (status == JSON_PARTIAL || status == JSON_OK); off += chunk) {
+        status = json_reader_feed(reader, body + off, len - off < chunk ? len - off : chunk);
+    }
+    return status;
+}
+
+static void bench_parse(const char *body, size_t chunk)
+{
+    size_t len = strlen(body);
+    json_reader_t reader;
+    if (parse(body, len, chunk, &reader) != JSON_OK) {
+        printf("parse failed: %s\n", body);
+        return;
+    }
+
+    double start = now_s();
+    int64_t sum = 0;
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        parse(body, len, chunk, &reader);
+        bool state = false;
+        int64_t value = 0;
+        json_reader_get_bool(&reader, json_reader_find(&reader, 0, "state"), &state);
+        json_reader_get_int(&reader, json_reader_find(&reader, 0, "ack"), &value);
+        sum += state + value;
+    }
+    double elapsed = now_s() - start;
+
+    char name[64];
+    snprintf(name, sizeof(name), "parse %zu B, %s", len, chunk >= len ? "whole" : "8 B receives");
+    report(name, elapsed, len * BENCH_ROUNDS);
+    sink_bytes += (size_t)sum;
+}
+
+static bool count_sink(void *ctx, const char *data, size_t len)
+{
+    (void)ctx;
+    (void)data;
+    sink_bytes += len;
+    return true;
+}
+
+/**
+ * @brief The /api/relays response as http_server.c writes it
+ */
+static size_t write_relays(char *buf, size_t size, json_sink_t sink)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size, sink, NULL);
+    json_obj_begin(&w);
+    json_kv_bool(&w, "success", true);
+    json_kv_int(&w, "version", 4711);
+    json_key(&w, "relays");
+    json_arr_begin(&w);
+    for (int id = 1; id <= 6; id++) {
+        json_obj_begin(&w);
+        json_kv_int(&w, "id", id);
+        json_kv_bool(&w, "state", id & 1);
+        json_kv_int(&w, "remaining", id * 97);
+        json_kv_int(&w, "current_ca", id * 131);
+        json_obj_end(&w);
+    }
+    json_arr_end(&w);
+    json_obj_end(&w);
+    size_t len = w.len;
+    json_writer_flush(&w);
+    return w.failed ? 0 : len;
+}
+
+/**
+ * @brief The same response with the snprintf code the writer replaced
+ */
+static size_t snprintf_relays(char *buf, size_t size)
+{
+    int len = snprintf(buf, size, "{\"success\":true,\"version\":%" PRIu32 ",\"relays\":[", (uint32_t)4711);
+    for (int id = 1; id <= 6; id++) {
+        len += snprintf(buf + len, size - len, "%s{\"id\":%d,\"state\":%s,\"remaining\":%" PRIu32 ",\"current_ca\":%" PRId32 "}",
+                        id > 1 ? "," : "", id, (id & 1) ? "true" : "false", (uint32_t)(id * 97), (int32_t)(id * 131));
+    }
+    len += snprintf(buf + len, size - len, "]}");
+    return len;
+}
+
+int main(void)
+{
+    json_reader_t reader;
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+        for (size_t chunk = 1; chunk <= strlen(rejected[i]); chunk++) {
+            if (parse(rejected[i], strlen(rejected[i]), chunk, &reader) == JSON_OK) {
+                printf("accepted invalid body %s in %zu B receives\n", rejected[i], chunk);
+                return 1;
+            }
+        }
+    }
+    // The closing bracket and the trailing whitespace arriving in separate receives
+    static const char spaced[] = "{\"state\":true} \r\n";
+    if (parse(spaced, strlen(spaced), strlen(spaced) - 3, &reader) != JSON_OK) {
+        printf("rejected trailing whitespace in a later receive\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(bodies) / sizeof(bodies[0]); i++) {
+        bench_parse(bodies[i], SIZE_MAX);
+        bench_parse(bodies[i], 8);
+    }
+
+    char buf[512];
+    char reference[512];
+    size_t len = write_relays(buf, sizeof(buf), NULL);
+    size_t ref_len = snprintf_relays(reference, sizeof(reference));
+    if (len != ref_len || memcmp(buf, reference, len) != 0) {
+        printf("writer output differs from snprintf:\n%.*s\n%.*s\n", (int)len, buf, (int)ref_len, reference);
+        return 1;
+    }
+
+    double start = now_s();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        sink_bytes += write_relays(buf, sizeof(buf), NULL);
+    }
+    report("write /api/relays, 512 B buffer", now_s() - start, len * BENCH_ROUNDS);
+
+    start = now_s();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        write_relays(buf, 64, count_sink);
+    }
+    report("write /api/relays, 64 B chunks", now_s() - start, len * BENCH_ROUNDS);
+
+    start = now_s();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        sink_bytes += snprintf_relays(buf, sizeof(buf));
+    }
+    report("snprintf /api/relays (previous code)", now_s() - start, len * BENCH_ROUNDS);
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Host check and benchmark of the portable RGB565 swap kernel (components/display_port)
+ *
+ * Build and run from the repository root:
+ *
+ *     cc -O2 -Imain/components/display_port main/tools/rgb565_swap_bench.c \
+ *        main/components/display_port/rgb565_swap_portable.c -o rgb565_swap_bench && ./rgb565_swap_bench
+ *
+ * Checks the kernel bit-for-bit against a pixel-at-a-time swap (what
+ * lv_draw_sw_rgb565_swap() computes) for every length up to a few words at
+ * every start offset, then over full bands, and times both on 240x20 and
+ * 320x20 bands. The PIE kernel only runs on the ESP32-S3 and is checked there
+ * at boot by rgb565_swap_init(). Numbers from a desktop CPU only compare the
+ * variants.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "rgb565_swap_portable.h"
+
+#define BENCH_ROUNDS    20000
+#define CHECK_MAX_PX    (320 * 20 + 7)  // Largest band plus an odd tail
+#define CHECK_OFFSETS   8
+
+static uint16_t test[CHECK_MAX_PX + CHECK_OFFSETS] __attribute__((aligned(16)));
+static uint16_t ref[CHECK_MAX_PX + CHECK_OFFSETS] __attribute__((aligned(16)));
+static volatile uint16_t sink_px;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Reference: one pixel at a time
+ */
+static void swap_reference(void *buf, uint32_t px_count)
+{
+    uint16_t *buf16 = (uint16_t *)buf;
+    for (uint32_t i = 0; i < px_count; i++) {
+        buf16[i] = (uint16_t)((buf16[i] >> 8) | (buf16[i] << 8));
+    }
+}
+
+/**
+ * @brief Compare the kernel with the reference for one length and start offset
+ *
+ * The whole buffer is compared, so writes before or after the range fail too.
+ */
+static int check(uint32_t offset, uint32_t px_count)
+{
+    size_t total = offset + px_count + CHECK_OFFSETS;
+    for (size_t i = 0; i < total; i++) {
+        test[i] = (uint16_t)(i * 2654435761u >> 7);
+    }
+    memcpy(ref, test, total * sizeof(uint16_t));
+    swap_reference(ref + offset, px_count);
+    rgb565_swap_portable(test + offset, px_count);
+    if (memcmp(test, ref, total * sizeof(uint16_t)) != 0) {
+        printf("mismatch at start offset %" PRIu32 ", %" PRIu32 " px\n", offset, px_count);
+        return 1;
+    }
+    return 0;
+}
+
+static void bench(const char *name, void (*kernel)(void *, uint32_t), uint32_t width, uint32_t lines)
+{
+    uint32_t px_count = width * lines;
+    double start = now_s();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        kernel(test, px_count);
+        sink_px += test[i % px_count];
+    }
+    double elapsed = now_s() - start;
+    printf("%-10s %3" PRIu32 "x%-2" PRIu32 " band %8.1f ns/band %6.3f ns/px\n",
+           name, width, lines, elapsed / BENCH_ROUNDS * 1e9, elapsed / BENCH_ROUNDS / px_count * 1e9);
+}
+
+int main(void)
+{
+    int failures = 0;
+    for (uint32_t offset = 0; offset < CHECK_OFFSETS; offset++) {
+        for (uint32_t px_count = 0; px_count <= 64; px_count++) {
+            failures += check(offset, px_count);
+        }
+        failures += check(offset, 240 * 20);
+        failures += check(offset, CHECK_MAX_PX - offset);
+    }
+    if (failures > 0) {
+        printf("%d mismatches\n", failures);
+        return 1;
+    }
+    printf("portable kernel is bit-exact\n");
+
+    static const uint32_t band_widths[] = {240, 320};
+    for (size_t i = 0; i < sizeof(band_widths) / sizeof(band_widths[0]); i++) {
+        bench("reference", swap_reference, band_widths[i], 20);
+        bench("portable", rgb565_swap_portable, band_widths[i], 20);
+    }
+    return 0;
+}
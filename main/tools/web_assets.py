@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Pack the web UI into the read-only image of the "www" partition.
+
+Every file under the source directory is gzip-compressed at build time (kept
+as is when compression does not pay off) and packed, together with a
+precomputed index, into one image that the server memory-maps at boot:
+
+    header   magic "WWW2", u32 count, u32 image size, u32 reserved
+    entries  count x { u32 uri hash, u32 offset, u32 size, u32 flags (bit 0: gzip),
+                       char uri[48], char etag[20] (quoted), char mime[32] }
+    data     each asset at a 4-byte aligned offset from the image start
+
+Entries are sorted by (hash, uri), where hash is the 32-bit FNV-1a of the
+URI, so the server finds a request path with a binary search over integers
+and one string compare. The ETag is derived from the uncompressed content,
+so it only changes when the asset does. All integers are little endian; the
+layout must match web_assets.h.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import struct
+import sys
+
+IMAGE_MAGIC = b'WWW2'
+IMAGE_HEADER = struct.Struct('<4sIII')
+IMAGE_ENTRY = struct.Struct('<IIII48s20s32s')
+IMAGE_FLAG_GZIP = 0x1
+MAX_URI_LEN = 47        # web_asset_t.uri holds 48 bytes
+
+MIME_TYPES = {
+    '.html': 'text/html',
+    '.htm': 'text/html',
+    '.css': 'text/css',
+    '.js': 'application/javascript',
+    '.json': 'application/json',
+    '.png': 'image/png',
+    '.jpg': 'image/jpeg',
+    '.jpeg': 'image/jpeg',
+    '.gif': 'image/gif',
+    '.svg': 'image/svg+xml',
+    '.ico': 'image/x-icon',
+}
+
+# Already compressed formats are stored as they are
+STORE_EXTENSIONS = {'.png', '.jpg', '.jpeg', '.gif', '.ico', '.gz', '.woff', '.woff2'}
+
+
+def fnv1a(data):
+    h = 0x811c9dc5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xffffffff
+    return h
+
+
+def align4(n):
+    return (n + 3) & ~3
+
+
+def collect(src):
+    for root, _, files in os.walk(src):
+        for name in sorted(files):
+            path = os.path.join(root, name)
+            rel = os.path.relpath(path, src).replace(os.sep, '/')
+            yield '/' + rel, path
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--src', required=True, help='web source directory')
+    parser.add_argument('--image', required=True, help='image file to write')
+    parser.add_argument('--image-max-size', type=lambda s: int(s, 0), default=0, help='size of the target partition')
+    args = parser.parse_args()
+
+    assets = []
+    raw_total = 0
+    for uri, path in collect(args.src):
+        if len(uri) > MAX_URI_LEN:
+            sys.exit('web_assets: path too long for the asset index: ' + uri)
+        with open(path, 'rb') as f:
+            data = f.read()
+        ext = os.path.splitext(uri)[1].lower()
+
+        stored = data
+        compressed = False
+        if ext not in STORE_EXTENSIONS:
+            # mtime=0 keeps the output, and the flashed image, reproducible
+            packed = gzip.compress(data, compresslevel=9, mtime=0)
+            if len(packed) < len(data):
+                stored = packed
+                compressed = True
+
+        etag = '"%s"' % hashlib.sha256(data).hexdigest()[:16]
+        mime = MIME_TYPES.get(ext, 'application/octet-stream')
+        assets.append((fnv1a(uri.encode()), uri, etag, mime, compressed, stored))
+        raw_total += len(data)
+        print('web_assets: %-24s %6d -> %6d bytes%s' % (uri, len(data), len(stored), ' (gzip)' if compressed else ''))
+
+    assets.sort(key=lambda a: (a[0], a[1]))
+    for prev, cur in zip(assets, assets[1:]):
+        if prev[0] == cur[0]:
+            print('web_assets: %s and %s share hash %08x' % (prev[1], cur[1], cur[0]))
+
+    offset = align4(IMAGE_HEADER.size + IMAGE_ENTRY.size * len(assets))
+    entries = b''
+    data = b''
+    for uri_hash, uri, etag, mime, compressed, stored in assets:
+        entries += IMAGE_ENTRY.pack(uri_hash, offset + len(data), len(stored),
+                                    IMAGE_FLAG_GZIP if compressed else 0,
+                                    uri.encode(), etag.encode(), mime.encode())
+        data += stored + b'\0' * (align4(len(stored)) - len(stored))
+    size = offset + len(data)
+    if args.image_max_size and size > args.image_max_size:
+        sys.exit('web_assets: image is %d bytes, the partition holds %d' % (size, args.image_max_size))
+
+    header = IMAGE_HEADER.pack(IMAGE_MAGIC, len(assets), size, 0)
+    pad = b'\0' * (offset - IMAGE_HEADER.size - len(entries))
+    with open(args.image, 'wb') as f:
+        f.write(header + entries + pad + data)
+    print('web_assets: %d assets, %d bytes of sources, %d byte image' % (len(assets), raw_total, size))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Load the device's web UI from several clients at once and report throughput.
+
+Run it against two firmware builds to compare how they serve the UI:
+
+    python main/tools/web_bench.py 192.168.1.50 --clients 4 --requests 50
+
+Each client keeps one connection open and fetches the path repeatedly with
+Accept-Encoding: gzip. With --revalidate the ETag of the first response is
+sent back in If-None-Match, which measures repeat visits (304) instead.
+
+With --upload the file is POSTed to /update while the clients run, to see how
+the API responds during a firmware upload:
+
+    python main/tools/web_bench.py 192.168.1.50 --path /api/relay/1 --upload build/SmartSocket.bin
+
+A valid image reboots the device once it is written; any other file is
+received in full and then rejected, which measures the same upload without
+the reboot. The device's own view is "api_during_ota_us" in /api/ui/metrics.
+"""
+
+import argparse
+import http.client
+import statistics
+import threading
+import time
+
+
+def client(host, port, path, requests, revalidate, results):
+    conn = http.client.HTTPConnection(host, port, timeout=10)
+    etag = None
+    for _ in range(requests):
+        headers = {'Accept-Encoding': 'gzip'}
+        if revalidate and etag:
+            headers['If-None-Match'] = etag
+        start = time.perf_counter()
+        try:
+            conn.request('GET', path, headers=headers)
+            resp = conn.getresponse()
+            first_byte = time.perf_counter()
+            body = resp.read()
+        except (OSError, http.client.HTTPException) as e:
+            results.append(('error', str(e), 0, 0, 0))
+            conn.close()
+            conn = http.client.HTTPConnection(host, port, timeout=10)
+            continue
+        done = time.perf_counter()
+        etag = resp.getheader('ETag') or etag
+        results.append((resp.status, None, len(body), first_byte - start, done - start))
+    conn.close()
+
+
+def upload(host, port, path, results):
+    with open(path, 'rb') as f:
+        image = f.read()
+    conn = http.client.HTTPConnection(host, port, timeout=120)
+    start = time.perf_counter()
+    try:
+        conn.request('POST', '/update', body=image, headers={'Content-Type': 'application/octet-stream'})
+        resp = conn.getresponse()
+        results.append((resp.status, resp.read().decode(errors='replace').strip(), time.perf_counter() - start))
+    except (OSError, http.client.HTTPException) as e:
+        results.append(('error', str(e), time.perf_counter() - start))
+    conn.close()
+
+
+def percentile(values, pct):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * pct / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('host', help='device address')
+    parser.add_argument('--port', type=int, default=80)
+    parser.add_argument('--path', default='/')
+    parser.add_argument('--clients', type=int, default=4, help='concurrent connections (the server allows 7 sockets)')
+    parser.add_argument('--requests', type=int, default=20, help='requests per client')
+    parser.add_argument('--revalidate', action='store_true', help='send If-None-Match after the first response')
+    parser.add_argument('--upload', metavar='FILE', help='POST this file to /update during the run')
+    args = parser.parse_args()
+
+    results = []
+    upload_results = []
+    threads = [threading.Thread(target=client, args=(args.host, args.port, args.path, args.requests,
+                                                     args.revalidate, results))
+               for _ in range(args.clients)]
+    if args.upload:
+        threads.insert(0, threading.Thread(target=upload, args=(args.host, args.port, args.upload, upload_results)))
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.perf_counter() - start
+
+    ok = [r for r in results if r[0] in (200, 304)]
+    errors = len(results) - len(ok)
+    if not ok:
+        print('no successful responses (%d errors)' % errors)
+        return
+    total_bytes = sum(r[2] for r in ok)
+    ttfb_ms = [r[3] * 1000 for r in ok]
+    total_ms = [r[4] * 1000 for r in ok]
+    statuses = sorted(set(r[0] for r in ok))
+
+    print('%d clients x %d requests of %s: %d ok (status %s), %d errors in %.2f s' %
+          (args.clients, args.requests, args.path, len(ok), ','.join(map(str, statuses)), errors, elapsed))
+    print('throughput  %.1f req/s, %.1f KB/s' % (len(ok) / elapsed, total_bytes / elapsed / 1024))
+    print('first byte  p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, max %.1f ms' %
+          (statistics.median(ttfb_ms), percentile(ttfb_ms, 95), percentile(ttfb_ms, 99), max(ttfb_ms)))
+    print('complete    p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, max %.1f ms' %
+          (statistics.median(total_ms), percentile(total_ms, 95), percentile(total_ms, 99), max(total_ms)))
+    for status, text, seconds in upload_results:
+        print('upload      %s in %.1f s: %s' % (status, seconds, text))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,65 @@
+/*
+ * LVGL configuration of the host simulator
+ *
+ * Mirrors the LVGL options of the firmware's sdkconfig (CONFIG_LV_*), so the
+ * simulator lays out and renders the dashboard the way the panel shows it.
+ * Everything not listed keeps LVGL's default, as it does on the device.
+ */
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+// Colour and memory
+#define LV_COLOR_DEPTH                  16
+#define LV_USE_STDLIB_MALLOC            LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_STRING            LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_SPRINTF           LV_STDLIB_BUILTIN
+#define LV_MEM_SIZE                     (64 * 1024U)
+#define LV_MEM_POOL_EXPAND_SIZE         0
+
+// Refresh and timing (the simulator's main loop plays the LVGL task)
+#define LV_DEF_REFR_PERIOD              33
+#define LV_DPI_DEF                      130
+#define LV_USE_OS                       LV_OS_NONE
+
+// Rendering
+#define LV_DRAW_BUF_STRIDE_ALIGN        1
+#define LV_DRAW_BUF_ALIGN               4
+#define LV_DRAW_LAYER_SIMPLE_BUF_SIZE   (24 * 1024)
+#define LV_USE_DRAW_SW                  1
+#define LV_DRAW_SW_DRAW_UNIT_CNT        1
+#define LV_DRAW_SW_COMPLEX              1
+#define LV_DRAW_SW_SHADOW_CACHE_SIZE    0
+#define LV_DRAW_SW_CIRCLE_CACHE_SIZE    4
+#define LV_USE_DRAW_SW_ASM              LV_DRAW_SW_ASM_NONE
+#define LV_CACHE_DEF_SIZE               0
+#define LV_IMAGE_HEADER_CACHE_DEF_CNT   0
+#define LV_GRADIENT_MAX_STOPS           2
+#define LV_COLOR_MIX_ROUND_OFS          128
+
+// Logging and asserts
+#define LV_USE_LOG                      0
+#define LV_USE_ASSERT_NULL              1
+#define LV_USE_ASSERT_MALLOC            1
+#define LV_USE_ASSERT_STYLE             0
+#define LV_USE_ASSERT_MEM_INTEGRITY     0
+#define LV_USE_ASSERT_OBJ               0
+
+// Fonts and text
+#define LV_FONT_MONTSERRAT_14           1
+#define LV_FONT_DEFAULT                 &lv_font_montserrat_14
+#define LV_USE_FONT_PLACEHOLDER         1
+#define LV_TXT_ENC                      LV_TXT_ENC_UTF8
+
+// Themes, layouts and others
+#define LV_USE_THEME_DEFAULT            1
+#define LV_THEME_DEFAULT_GROW           1
+#define LV_THEME_DEFAULT_TRANSITION_TIME 80
+#define LV_USE_THEME_SIMPLE             1
+#define LV_USE_FLEX                     1
+#define LV_USE_GRID                     1
+#define LV_USE_OBSERVER                 1
+#define LV_USE_SYSMON                   0       // On in sdkconfig, but no monitor uses it
+#define LV_BUILD_EXAMPLES               0
+
+#endif // LV_CONF_H
@@ -0,0 +1,13 @@
+/*
+ * Host simulator shim: esp_adc/adc_oneshot.h
+ *
+ * relay_hardware.h only needs the ADC types; the simulated backend reads no ADC.
+ */
+
+#ifndef SIM_ESP_ADC_ADC_ONESHOT_H
+#define SIM_ESP_ADC_ADC_ONESHOT_H
+
+#include "esp_err.h"
+#include "hal/adc_types.h"
+
+#endif // SIM_ESP_ADC_ADC_ONESHOT_H
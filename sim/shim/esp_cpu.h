@@ -0,0 +1,14 @@
+/*
+ * Host simulator shim: esp_cpu.h
+ */
+
+#ifndef SIM_ESP_CPU_H
+#define SIM_ESP_CPU_H
+
+// The simulator runs one task at a time, all of them count as core 0
+static inline int esp_cpu_get_core_id(void)
+{
+    return 0;
+}
+
+#endif // SIM_ESP_CPU_H
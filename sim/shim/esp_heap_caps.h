@@ -0,0 +1,35 @@
+/*
+ * Host simulator shim: esp_heap_caps.h
+ *
+ * The host heap has no capabilities to report; every query answers 0.
+ */
+
+#ifndef SIM_ESP_HEAP_CAPS_H
+#define SIM_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_DEFAULT      (1 << 12)
+
+static inline size_t heap_caps_get_free_size(uint32_t caps)
+{
+    (void)caps;
+    return 0;
+}
+
+static inline size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    (void)caps;
+    return 0;
+}
+
+static inline size_t heap_caps_get_total_size(uint32_t caps)
+{
+    (void)caps;
+    return 0;
+}
+
+#endif // SIM_ESP_HEAP_CAPS_H
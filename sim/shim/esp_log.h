@@ -0,0 +1,30 @@
+/*
+ * Host simulator shim: esp_log.h
+ *
+ * Log lines go to stderr in the ESP-IDF format, stamped with the simulated
+ * clock, so stdout only carries the simulator's report.
+ */
+
+#ifndef SIM_ESP_LOG_H
+#define SIM_ESP_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Print one log line: "<level> (<simulated ms>) <tag>: <message>"
+ */
+void sim_log_write(char level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, format, ...) sim_log_write('E', tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) sim_log_write('W', tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) sim_log_write('I', tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) do { (void)(tag); } while (0)
+#define ESP_LOGV(tag, format, ...) do { (void)(tag); } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_ESP_LOG_H
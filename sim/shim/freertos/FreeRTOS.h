@@ -0,0 +1,43 @@
+/*
+ * Host simulator shim: freertos/FreeRTOS.h
+ *
+ * Tasks are host threads that run in lockstep with the simulated clock (see
+ * sim_port.c), so only one of them, or the LVGL loop, runs at a time. A
+ * critical section is a mutex.
+ */
+
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE     0
+#define pdTRUE      1
+#define pdPASS      pdTRUE
+#define pdFAIL      pdFALSE
+
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS      (1000 / CONFIG_FREERTOS_HZ)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * CONFIG_FREERTOS_HZ) / 1000))
+
+typedef pthread_mutex_t portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    PTHREAD_MUTEX_INITIALIZER
+#define taskENTER_CRITICAL(mux)         pthread_mutex_lock(mux)
+#define taskEXIT_CRITICAL(mux)          pthread_mutex_unlock(mux)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_FREERTOS_H
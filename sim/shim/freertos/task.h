@@ -0,0 +1,31 @@
+/*
+ * Host simulator shim: freertos/task.h
+ */
+
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define tskNO_AFFINITY  ((BaseType_t)0x7fffffff)
+
+typedef struct sim_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+TickType_t xTaskGetTickCount(void);
+
+/**
+ * @brief Sleep until the simulated clock reaches *previous_wake + increment
+ */
+void vTaskDelayUntil(TickType_t *previous_wake, TickType_t increment);
+void vTaskDelay(TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_FREERTOS_TASK_H
@@ -0,0 +1,26 @@
+/*
+ * Host simulator shim: hal/adc_types.h
+ */
+
+#ifndef SIM_HAL_ADC_TYPES_H
+#define SIM_HAL_ADC_TYPES_H
+
+typedef enum {
+    ADC_UNIT_1,
+    ADC_UNIT_2,
+} adc_unit_t;
+
+typedef enum {
+    ADC_CHANNEL_0,
+    ADC_CHANNEL_1,
+    ADC_CHANNEL_2,
+    ADC_CHANNEL_3,
+    ADC_CHANNEL_4,
+    ADC_CHANNEL_5,
+    ADC_CHANNEL_6,
+    ADC_CHANNEL_7,
+    ADC_CHANNEL_8,
+    ADC_CHANNEL_9,
+} adc_channel_t;
+
+#endif // SIM_HAL_ADC_TYPES_H
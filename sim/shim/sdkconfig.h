@@ -0,0 +1,23 @@
+/*
+ * Host simulator configuration
+ *
+ * The Kconfig defaults of the options the dashboard sources read, for the
+ * ILI9341 board with touch. Options that are off stay undefined, as in the
+ * generated sdkconfig.h. The generated font subset needs lv_font_conv at build
+ * time, so the simulator always renders with the full Montserrat 14.
+ */
+
+#ifndef SIM_SDKCONFIG_H
+#define SIM_SDKCONFIG_H
+
+#define CONFIG_FREERTOS_HZ                      100
+#define CONFIG_SOC_CPU_CORES_NUM                2
+#define CONFIG_LV_MEM_SIZE_KILOBYTES            64
+#define CONFIG_EXAMPLE_LCD_TOUCH_ENABLED        1
+#define CONFIG_EXAMPLE_LCD_BACKLIGHT_DUTY_PCT   100
+#define CONFIG_EXAMPLE_LCD_IDLE_TIMEOUT_S       60
+#define CONFIG_EXAMPLE_LCD_IDLE_FADE_MS         1000
+#define CONFIG_EXAMPLE_COUNTDOWN_ANIM_FPS       10
+#define CONFIG_EXAMPLE_UI_MAX_LIVE_SCREENS      2
+
+#endif // SIM_SDKCONFIG_H
@@ -0,0 +1,658 @@
+/*
+ * Host Simulator of the Relay Dashboard
+ *
+ * Runs the real dashboard (example_lvgl_demo_ui(), relay_control_ui_create()
+ * and everything they use) on the host against a software framebuffer, the
+ * simulated relay backend and scripted touch input. The main loop plays the
+ * LVGL task of the firmware on a simulated clock, so a script gives the same
+ * frames on every run, while the time LVGL spends rendering each frame is
+ * measured on the host's clock.
+ *
+ * Usage: smartsocket_sim [--out DIR] [--frames] [--csv FILE] [--metrics FILE] [SCRIPT]
+ *
+ *   --out DIR       Where PNG files go (default: sim_out)
+ *   --frames        Also dump every frame that changed the screen as frame_NNNNN.png
+ *   --csv FILE      One line per frame: simulated time, render time, pixels
+ *   --metrics FILE  The UI metrics as JSON, the same document as GET /api/ui/metrics
+ *   SCRIPT          Touch script (default: a tour of the dashboard, see below)
+ *
+ * Script commands, one per line ('#' starts a comment):
+ *
+ *   wait MS                 Let MS milliseconds of simulated time pass
+ *   tap TARGET              Press for 100 ms and release
+ *   hold TARGET MS          Press for MS milliseconds and release (long press)
+ *   press TARGET            Put the finger down and leave it there
+ *   release                 Lift the finger
+ *   set N on|off            Switch relay N from outside LVGL, as the HTTP API does
+ *   ip ADDRESS|none         Show an IP address in the status label
+ *   shot NAME               Dump the screen as NAME.png
+ *
+ *   TARGET is "X Y" in screen pixels, "relay N" for the button of relay N or
+ *   "current N" for its current reading, which opens the chart.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "lvgl.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "relay_control_ui.h"
+#include "display_idle.h"
+#include "ui_metrics.h"
+#include "json_stream.h"
+#include "sim_port.h"
+#include "sim_png.h"
+
+// Logical resolution of the ILI9341 after the firmware's 90 degree rotation
+#define SIM_H_RES                   320
+#define SIM_V_RES                   240
+#define SIM_DRAW_BUF_LINES          20      // Same bands as EXAMPLE_LVGL_DRAW_BUF_LINES
+#define SIM_MIN_DELAY_MS            (1000 / CONFIG_FREERTOS_HZ)    // Shortest LVGL task sleep
+#define SIM_TIMER_REQ_QUEUE_LEN     16
+#define SIM_TAP_MS                  100
+#define SIM_PIN_NUM_BK_LIGHT        3
+#define SIM_PATH_MAX                512
+#define SIM_SCRIPT_DELIMS           " \t\r"
+
+extern void example_lvgl_demo_ui(lv_display_t *disp);
+extern void example_lvgl_update_ip_address(const char *ip_str);
+extern relay_control_ui_t *example_lvgl_get_relay_ui(int index);
+
+static const char *TAG = "sim";
+
+static const char *default_script =
+    "# Dashboard after boot\n"
+    "shot boot\n"
+    "# Relay 1 on with its countdown; current readings arrive every 500 ms\n"
+    "tap relay 1\n"
+    "wait 2000\n"
+    "shot relay1_on\n"
+    "# Long press: relay 2 on without a countdown\n"
+    "hold relay 2 800\n"
+    "# Relay 3 switched through the API path\n"
+    "set 3 on\n"
+    "wait 3000\n"
+    "shot three_on\n"
+    "# Current chart of relay 1, then back\n"
+    "tap current 1\n"
+    "wait 5000\n"
+    "shot chart\n"
+    "tap 20 20\n"
+    "wait 1000\n"
+    "shot back\n"
+    "# Idle timeout: the backlight fades out, the next touch only wakes the display\n"
+    "wait 62000\n"
+    "shot dark\n"
+    "tap 160 120\n"
+    "wait 500\n"
+    "shot awake\n";
+
+static uint16_t s_frame[SIM_H_RES * SIM_V_RES];
+static lv_display_t *s_display = NULL;
+
+// Scripted finger
+static struct {
+    bool pressed;
+    bool swallowed;     // Press that woke the display, hidden until released
+    int32_t x;
+    int32_t y;
+} s_touch;
+
+// Timers other tasks asked the LVGL loop to run (example_lvgl_port_request_timer)
+static pthread_mutex_t s_req_lock = PTHREAD_MUTEX_INITIALIZER;
+static lv_timer_t *s_req_queue[SIM_TIMER_REQ_QUEUE_LEN];
+static int s_req_count = 0;
+
+// Output options
+static const char *s_out_dir = "sim_out";
+static bool s_dump_frames = false;
+static FILE *s_csv = NULL;
+
+// Current refresh cycle and the collected frame times
+static struct {
+    int64_t start_ns;
+    int64_t flush_ns;
+    uint32_t px;
+    uint32_t inv_px;
+    uint32_t frames;
+    uint32_t capacity;
+    int64_t *render_ns;     // Per frame that flushed pixels
+} s_frame_stats;
+
+static int64_t sim_wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Ask the LVGL loop to resume and run an LVGL timer on its next pass (any task)
+ */
+void example_lvgl_port_request_timer(lv_timer_t *timer)
+{
+    if (timer == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&s_req_lock);
+    if (s_req_count < SIM_TIMER_REQ_QUEUE_LEN) {
+        s_req_queue[s_req_count++] = timer;
+    } else {
+        ESP_LOGW(TAG, "LVGL timer request queue full");
+    }
+    pthread_mutex_unlock(&s_req_lock);
+}
+
+static bool sim_requests_pending(void)
+{
+    pthread_mutex_lock(&s_req_lock);
+    bool pending = s_req_count > 0;
+    pthread_mutex_unlock(&s_req_lock);
+    return pending;
+}
+
+/**
+ * @brief One pass of the LVGL task: apply timer requests, then run lv_timer_handler()
+ *
+ * @return uint32_t Milliseconds until LVGL needs the next pass, or LV_NO_TIMER_READY
+ */
+static uint32_t sim_lvgl_pass(void)
+{
+    lv_timer_t *timers[SIM_TIMER_REQ_QUEUE_LEN];
+    pthread_mutex_lock(&s_req_lock);
+    int count = s_req_count;
+    memcpy(timers, s_req_queue, sizeof(lv_timer_t *) * count);
+    s_req_count = 0;
+    pthread_mutex_unlock(&s_req_lock);
+    for (int i = 0; i < count; i++) {
+        lv_timer_resume(timers[i]);
+        lv_timer_ready(timers[i]);
+    }
+
+    int64_t start_ns = sim_wall_ns();
+    uint32_t time_till_next_ms = lv_timer_handler();
+    ui_metrics_record(UI_METRIC_TIMER_HANDLER_US, (uint32_t)((sim_wall_ns() - start_ns) / 1000));
+    return time_till_next_ms;
+}
+
+/**
+ * @brief Run the LVGL loop, timers and tasks until the simulated clock reaches end_us
+ */
+static void sim_run_until(int64_t end_us)
+{
+    for (;;) {
+        uint32_t time_till_next_ms = sim_lvgl_pass();
+        int64_t now = esp_timer_get_time();
+        if (now >= end_us) {
+            return;
+        }
+
+        // Sleep like the LVGL task: until LVGL needs a pass or another task wakes it with a request
+        int64_t lvgl_due_us = end_us;
+        if (time_till_next_ms != LV_NO_TIMER_READY) {
+            if (time_till_next_ms < SIM_MIN_DELAY_MS) {
+                time_till_next_ms = SIM_MIN_DELAY_MS;
+            }
+            if (now + (int64_t)time_till_next_ms * 1000 < end_us) {
+                lvgl_due_us = now + (int64_t)time_till_next_ms * 1000;
+            }
+        }
+        while (!sim_requests_pending() && esp_timer_get_time() < lvgl_due_us) {
+            int64_t next_us = sim_clock_next_event_us();
+            sim_clock_advance_to(next_us < lvgl_due_us ? next_us : lvgl_due_us);
+        }
+    }
+}
+
+static void sim_run_for(uint32_t ms)
+{
+    sim_run_until(esp_timer_get_time() + (int64_t)ms * 1000);
+}
+
+/**
+ * @brief Write the framebuffer as OUT_DIR/NAME.png, dimmed by the backlight
+ */
+static bool sim_dump_png(const char *name)
+{
+    char path[SIM_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s.png", s_out_dir, name);
+    if (!sim_png_write_rgb565(path, s_frame, SIM_H_RES, SIM_V_RES, sim_backlight_get_permille())) {
+        ESP_LOGE(TAG, "Failed to write %s", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Flush callback - copies a rendered band into the framebuffer
+ */
+static void sim_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    int64_t start_ns = sim_wall_ns();
+    int32_t width = lv_area_get_width(area);
+    const uint16_t *src = (const uint16_t *)px_map;
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&s_frame[y * SIM_H_RES + area->x1], src, (size_t)width * sizeof(uint16_t));
+        src += width;
+    }
+    s_frame_stats.px += (uint32_t)lv_area_get_size(area);
+    s_frame_stats.flush_ns += sim_wall_ns() - start_ns;
+    lv_display_flush_ready(disp);
+}
+
+/**
+ * @brief Display event callback - per-frame timing, as the firmware collects it
+ */
+static void sim_display_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_INVALIDATE_AREA) {
+        const lv_area_t *area = lv_event_get_param(e);
+        if (area != NULL) {
+            s_frame_stats.inv_px += (uint32_t)lv_area_get_size(area);
+        }
+    } else if (code == LV_EVENT_REFR_START) {
+        s_frame_stats.start_ns = sim_wall_ns();
+        s_frame_stats.flush_ns = 0;
+        s_frame_stats.px = 0;
+    } else if (code == LV_EVENT_REFR_READY) {
+        if (s_frame_stats.px == 0) {
+            return;
+        }
+        int64_t frame_ns = sim_wall_ns() - s_frame_stats.start_ns;
+        int64_t render_ns = frame_ns - s_frame_stats.flush_ns;
+        ui_metrics_record(UI_METRIC_FRAME_US, (uint32_t)(frame_ns / 1000));
+        ui_metrics_record(UI_METRIC_RENDER_US, (uint32_t)(render_ns / 1000));
+        ui_metrics_record(UI_METRIC_FLUSH_US, (uint32_t)(s_frame_stats.flush_ns / 1000));
+        ui_metrics_record(UI_METRIC_FLUSH_BYTES, s_frame_stats.px * sizeof(uint16_t));
+        ui_metrics_record(UI_METRIC_INVALID_AREA_PX, s_frame_stats.inv_px);
+
+        if (s_frame_stats.frames == s_frame_stats.capacity) {
+            uint32_t capacity = s_frame_stats.capacity ? s_frame_stats.capacity * 2 : 1024;
+            int64_t *grown = realloc(s_frame_stats.render_ns, capacity * sizeof(int64_t));
+            if (grown == NULL) {
+                ESP_LOGE(TAG, "Out of memory for frame times");
+                abort();
+            }
+            s_frame_stats.render_ns = grown;
+            s_frame_stats.capacity = capacity;
+        }
+        s_frame_stats.render_ns[s_frame_stats.frames] = render_ns;
+
+        if (s_csv != NULL) {
+            fprintf(s_csv, "%" PRIu32 ",%.3f,%.1f,%.1f,%" PRIu32 ",%" PRIu32 "\n", s_frame_stats.frames,
+                    esp_timer_get_time() / 1000.0, render_ns / 1000.0, s_frame_stats.flush_ns / 1000.0,
+                    s_frame_stats.px, s_frame_stats.inv_px);
+        }
+        if (s_dump_frames) {
+            char name[32];
+            snprintf(name, sizeof(name), "frame_%05" PRIu32, s_frame_stats.frames);
+            sim_dump_png(name);
+        }
+        s_frame_stats.frames++;
+        s_frame_stats.inv_px = 0;
+    }
+}
+
+/**
+ * @brief Touch read callback - reports the scripted finger, a press on a dark display only wakes it
+ */
+static void sim_touch_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    (void)indev;
+    if (s_touch.pressed) {
+        if (display_idle_touch()) {
+            s_touch.swallowed = true;
+        }
+        data->point.x = s_touch.x;
+        data->point.y = s_touch.y;
+        data->state = s_touch.swallowed ? LV_INDEV_STATE_RELEASED : LV_INDEV_STATE_PRESSED;
+    } else {
+        s_touch.swallowed = false;
+        data->state = LV_INDEV_STATE_RELEASED;
+    }
+}
+
+/**
+ * @brief Relay UI by its 1-based number as the script writes it
+ */
+static relay_control_ui_t *sim_relay(const char *arg)
+{
+    if (arg == NULL) {
+        return NULL;
+    }
+    return example_lvgl_get_relay_ui(atoi(arg));
+}
+
+/**
+ * @brief Resolve a TARGET ("X Y", "relay N" or "current N") to screen coordinates
+ *
+ * Consumes its tokens from strtok().
+ */
+static bool sim_parse_target(int32_t *x, int32_t *y)
+{
+    const char *first = strtok(NULL, SIM_SCRIPT_DELIMS);
+    const char *second = strtok(NULL, SIM_SCRIPT_DELIMS);
+    if (first == NULL || second == NULL) {
+        return false;
+    }
+
+    lv_obj_t *obj = NULL;
+    if (strcmp(first, "relay") == 0) {
+        relay_control_ui_t *ui = sim_relay(second);
+        obj = ui != NULL ? relay_control_ui_get_button(ui) : NULL;
+    } else if (strcmp(first, "current") == 0) {
+        relay_control_ui_t *ui = sim_relay(second);
+        obj = ui != NULL ? ui->current_container : NULL;
+    } else {
+        *x = atoi(first);
+        *y = atoi(second);
+        return true;
+    }
+    if (obj == NULL) {
+        return false;
+    }
+
+    // Objects are laid out lazily; make sure the coordinates are current
+    lv_obj_update_layout(obj);
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    *x = coords.x1 + lv_area_get_width(&coords) / 2;
+    *y = coords.y1 + lv_area_get_height(&coords) / 2;
+    return true;
+}
+
+static void sim_press(int32_t x, int32_t y)
+{
+    s_touch.x = x;
+    s_touch.y = y;
+    s_touch.pressed = true;
+}
+
+/**
+ * @brief Run one script line
+ *
+ * @return bool false on a line that could not be parsed
+ */
+static bool sim_run_command(char *line)
+{
+    char *comment = strchr(line, '#');
+    if (comment != NULL) {
+        *comment = '\0';
+    }
+    const char *cmd = strtok(line, SIM_SCRIPT_DELIMS);
+    if (cmd == NULL) {
+        return true;
+    }
+
+    int32_t x = 0;
+    int32_t y = 0;
+    if (strcmp(cmd, "wait") == 0) {
+        const char *ms = strtok(NULL, SIM_SCRIPT_DELIMS);
+        if (ms == NULL) {
+            return false;
+        }
+        sim_run_for((uint32_t)atoi(ms));
+    } else if (strcmp(cmd, "tap") == 0) {
+        if (!sim_parse_target(&x, &y)) {
+            return false;
+        }
+        sim_press(x, y);
+        sim_run_for(SIM_TAP_MS);
+        s_touch.pressed = false;
+        sim_run_for(SIM_TAP_MS);
+    } else if (strcmp(cmd, "hold") == 0) {
+        if (!sim_parse_target(&x, &y)) {
+            return false;
+        }
+        const char *ms = strtok(NULL, SIM_SCRIPT_DELIMS);
+        if (ms == NULL) {
+            return false;
+        }
+        sim_press(x, y);
+        sim_run_for((uint32_t)atoi(ms));
+        s_touch.pressed = false;
+        sim_run_for(SIM_TAP_MS);
+    } else if (strcmp(cmd, "press") == 0) {
+        if (!sim_parse_target(&x, &y)) {
+            return false;
+        }
+        sim_press(x, y);
+    } else if (strcmp(cmd, "release") == 0) {
+        s_touch.pressed = false;
+    } else if (strcmp(cmd, "set") == 0) {
+        relay_control_ui_t *ui = sim_relay(strtok(NULL, SIM_SCRIPT_DELIMS));
+        const char *state = strtok(NULL, SIM_SCRIPT_DELIMS);
+        if (ui == NULL || state == NULL) {
+            return false;
+        }
+        relay_control_ui_set_state(ui, strcmp(state, "on") == 0);
+    } else if (strcmp(cmd, "ip") == 0) {
+        const char *ip = strtok(NULL, SIM_SCRIPT_DELIMS);
+        example_lvgl_update_ip_address(ip != NULL && strcmp(ip, "none") != 0 ? ip : NULL);
+    } else if (strcmp(cmd, "shot") == 0) {
+        const char *name = strtok(NULL, SIM_SCRIPT_DELIMS);
+        if (name == NULL) {
+            return false;
+        }
+        // Draw what is still invalid, so the shot shows the state the script reached
+        lv_refr_now(s_display);
+        return sim_dump_png(name);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static int compare_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Print the frame time summary to stdout
+ */
+static void sim_report(void)
+{
+    uint32_t n = s_frame_stats.frames;
+    printf("frames: %" PRIu32 " in %.1f s simulated\n", n, esp_timer_get_time() / 1000000.0);
+    if (n == 0) {
+        return;
+    }
+    qsort(s_frame_stats.render_ns, n, sizeof(int64_t), compare_i64);
+    int64_t sum_ns = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sum_ns += s_frame_stats.render_ns[i];
+    }
+    printf("render us: avg %.1f, p50 %.1f, p95 %.1f, max %.1f\n",
+           sum_ns / 1000.0 / n, s_frame_stats.render_ns[n / 2] / 1000.0,
+           s_frame_stats.render_ns[(n * 95) / 100] / 1000.0, s_frame_stats.render_ns[n - 1] / 1000.0);
+}
+
+static bool sim_file_sink(void *ctx, const char *data, size_t len)
+{
+    return fwrite(data, 1, len, (FILE *)ctx) == len;
+}
+
+/**
+ * @brief Write every UI metric as JSON, the document GET /api/ui/metrics serves
+ */
+static bool sim_write_metrics(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        return false;
+    }
+    char buf[512];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), sim_file_sink, f);
+    json_obj_begin(&w);
+    for (int i = 0; i < UI_METRIC_COUNT; i++) {
+        ui_metrics_write_json((ui_metric_t)i, &w);
+    }
+    json_obj_end(&w);
+    bool ok = json_writer_flush(&w);
+    fputc('\n', f);
+    return fclose(f) == 0 && ok;
+}
+
+static uint32_t sim_tick_get_cb(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief Bring up LVGL and the dashboard the way app_main() does on the device
+ */
+static void sim_start_dashboard(void)
+{
+    ESP_ERROR_CHECK(display_idle_backlight_init(SIM_PIN_NUM_BK_LIGHT, 1));
+    display_idle_backlight_set(CONFIG_EXAMPLE_LCD_BACKLIGHT_DUTY_PCT);
+
+    lv_init();
+    lv_tick_set_cb(sim_tick_get_cb);
+
+    s_display = lv_display_create(SIM_H_RES, SIM_V_RES);
+    size_t draw_buffer_sz = SIM_H_RES * SIM_DRAW_BUF_LINES * sizeof(lv_color16_t);
+    void *buf1 = malloc(draw_buffer_sz);
+    void *buf2 = malloc(draw_buffer_sz);
+    if (buf1 == NULL || buf2 == NULL) {
+        ESP_LOGE(TAG, "No memory for the draw buffers");
+        abort();
+    }
+    lv_display_set_buffers(s_display, buf1, buf2, draw_buffer_sz, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_color_format(s_display, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_flush_cb(s_display, sim_flush_cb);
+    lv_display_add_event_cb(s_display, sim_display_event_cb, LV_EVENT_ALL, NULL);
+    display_idle_start(s_display);
+
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_display(indev, s_display);
+    lv_indev_set_read_cb(indev, sim_touch_cb);
+
+    lv_obj_t *scr = lv_display_get_screen_active(s_display);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, LV_PART_MAIN);
+    example_lvgl_demo_ui(s_display);
+    example_lvgl_update_ip_address(NULL);
+}
+
+static char *sim_read_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return NULL;
+    }
+    size_t size = 0;
+    size_t capacity = 4096;
+    char *text = malloc(capacity);
+    size_t n;
+    while (text != NULL && (n = fread(text + size, 1, capacity - size - 1, f)) > 0) {
+        size += n;
+        if (size + 1 == capacity) {
+            capacity *= 2;
+            char *grown = realloc(text, capacity);
+            if (grown == NULL) {
+                free(text);
+            }
+            text = grown;
+        }
+    }
+    fclose(f);
+    if (text != NULL) {
+        text[size] = '\0';
+    }
+    return text;
+}
+
+static void sim_usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--out DIR] [--frames] [--csv FILE] [--metrics FILE] [SCRIPT]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    const char *script_path = NULL;
+    const char *csv_path = NULL;
+    const char *metrics_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            s_out_dir = argv[++i];
+        } else if (strcmp(argv[i], "--frames") == 0) {
+            s_dump_frames = true;
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metrics_path = argv[++i];
+        } else if (argv[i][0] != '-' && script_path == NULL) {
+            script_path = argv[i];
+        } else {
+            sim_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    char *script = script_path != NULL ? sim_read_file(script_path) : strdup(default_script);
+    if (script == NULL) {
+        fprintf(stderr, "cannot read %s\n", script_path != NULL ? script_path : "the default script");
+        return 1;
+    }
+    if (mkdir(s_out_dir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "cannot create %s: %s\n", s_out_dir, strerror(errno));
+        return 1;
+    }
+    if (csv_path != NULL) {
+        s_csv = fopen(csv_path, "w");
+        if (s_csv == NULL) {
+            fprintf(stderr, "cannot write %s\n", csv_path);
+            return 1;
+        }
+        fprintf(s_csv, "frame,time_ms,render_us,flush_us,flush_px,invalid_px\n");
+    }
+
+    sim_start_dashboard();
+    // Let the first frame and the first current readings through before the script starts
+    sim_run_for(100);
+
+    bool ok = true;
+    int line_no = 0;
+    for (char *line = script; line != NULL && *line != '\0';) {
+        char *end = strchr(line, '\n');
+        if (end != NULL) {
+            *end = '\0';
+        }
+        line_no++;
+        bool line_ok = sim_run_command(line);
+        line = end != NULL ? end + 1 : NULL;
+        if (!line_ok) {
+            ESP_LOGE(TAG, "Script line %d failed", line_no);
+            ok = false;
+            break;
+        }
+    }
+
+    sim_report();
+    if (s_csv != NULL) {
+        fclose(s_csv);
+    }
+    if (metrics_path != NULL && !sim_write_metrics(metrics_path)) {
+        fprintf(stderr, "cannot write %s\n", metrics_path);
+        ok = false;
+    }
+    free(script);
+    return ok ? 0 : 1;
+}
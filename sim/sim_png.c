@@ -0,0 +1,154 @@
+/*
+ * PNG Frame Writer
+ *
+ * A PNG is a signature and three chunks here: IHDR, one IDAT holding a zlib
+ * stream of stored deflate blocks, and IEND. Each scanline is filter type 0
+ * followed by the RGB bytes, expanded from RGB565 by bit replication.
+ */
+
+#include "sim_png.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PNG_STORED_BLOCK_MAX    65535   // Largest payload of a stored deflate block
+
+static uint32_t crc_table[256];
+
+static void png_crc_init(void)
+{
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        crc_table[n] = c;
+    }
+}
+
+static uint32_t png_crc(uint32_t crc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+/**
+ * @brief Write one chunk: length, type, data, CRC over type and data
+ */
+static bool png_write_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len)
+{
+    uint8_t head[8];
+    put_be32(head, len);
+    memcpy(head + 4, type, 4);
+    uint32_t crc = png_crc(0xFFFFFFFFu, head + 4, 4);
+    crc = png_crc(crc, data, len) ^ 0xFFFFFFFFu;
+    uint8_t tail[4];
+    put_be32(tail, crc);
+    return fwrite(head, 1, sizeof(head), f) == sizeof(head) &&
+           (len == 0 || fwrite(data, 1, len, f) == len) &&
+           fwrite(tail, 1, sizeof(tail), f) == sizeof(tail);
+}
+
+/**
+ * @brief Scale an 8-bit channel by the backlight level
+ */
+static uint8_t png_dim(uint32_t value, uint32_t brightness_permille)
+{
+    return (uint8_t)((value * brightness_permille + 500) / 1000);
+}
+
+bool sim_png_write_rgb565(const char *path, const uint16_t *pixels, uint32_t width, uint32_t height,
+                          uint32_t brightness_permille)
+{
+    if (crc_table[1] == 0) {
+        png_crc_init();
+    }
+    if (brightness_permille > 1000) {
+        brightness_permille = 1000;
+    }
+
+    size_t row_len = 1 + (size_t)width * 3;
+    size_t raw_len = row_len * height;
+    size_t blocks = (raw_len + PNG_STORED_BLOCK_MAX - 1) / PNG_STORED_BLOCK_MAX;
+    size_t zlib_len = 2 + blocks * 5 + raw_len + 4;
+    uint8_t *raw = malloc(raw_len);
+    uint8_t *zlib = malloc(zlib_len);
+    if (raw == NULL || zlib == NULL) {
+        free(raw);
+        free(zlib);
+        return false;
+    }
+
+    uint8_t *out = raw;
+    for (uint32_t y = 0; y < height; y++) {
+        *out++ = 0;     // Filter: none
+        for (uint32_t x = 0; x < width; x++) {
+            uint16_t px = pixels[(size_t)y * width + x];
+            uint32_t r = (px >> 11) & 0x1F;
+            uint32_t g = (px >> 5) & 0x3F;
+            uint32_t b = px & 0x1F;
+            *out++ = png_dim((r << 3) | (r >> 2), brightness_permille);
+            *out++ = png_dim((g << 2) | (g >> 4), brightness_permille);
+            *out++ = png_dim((b << 3) | (b >> 2), brightness_permille);
+        }
+    }
+
+    // zlib header (deflate, 32K window, no dictionary), stored blocks, Adler-32 of the raw data
+    uint8_t *z = zlib;
+    *z++ = 0x78;
+    *z++ = 0x01;
+    uint32_t adler_a = 1;
+    uint32_t adler_b = 0;
+    for (size_t done = 0; done < raw_len;) {
+        size_t n = raw_len - done;
+        if (n > PNG_STORED_BLOCK_MAX) {
+            n = PNG_STORED_BLOCK_MAX;
+        }
+        *z++ = (done + n == raw_len) ? 1 : 0;    // BFINAL on the last block, BTYPE 00
+        *z++ = (uint8_t)n;
+        *z++ = (uint8_t)(n >> 8);
+        *z++ = (uint8_t)~n;
+        *z++ = (uint8_t)(~n >> 8);
+        memcpy(z, raw + done, n);
+        for (size_t i = 0; i < n; i++) {
+            adler_a = (adler_a + raw[done + i]) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+        z += n;
+        done += n;
+    }
+    put_be32(z, (adler_b << 16) | adler_a);
+    free(raw);
+
+    uint8_t ihdr[13];
+    put_be32(ihdr, width);
+    put_be32(ihdr + 4, height);
+    ihdr[8] = 8;    // Bit depth
+    ihdr[9] = 2;    // Colour type: RGB
+    ihdr[10] = 0;   // Compression: deflate
+    ihdr[11] = 0;   // Filter method
+    ihdr[12] = 0;   // No interlace
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        free(zlib);
+        return false;
+    }
+    bool ok = fwrite(signature, 1, sizeof(signature), f) == sizeof(signature) &&
+              png_write_chunk(f, "IHDR", ihdr, sizeof(ihdr)) &&
+              png_write_chunk(f, "IDAT", zlib, (uint32_t)zlib_len) &&
+              png_write_chunk(f, "IEND", NULL, 0);
+    free(zlib);
+    return fclose(f) == 0 && ok;
+}
@@ -0,0 +1,36 @@
+/*
+ * PNG Frame Writer Header
+ *
+ * Writes an RGB565 frame as an 8-bit RGB PNG. The image data is stored, not
+ * compressed, so the writer needs no zlib and a dump is byte-for-byte the
+ * same for the same frame, which is what a regression diff wants.
+ */
+
+#ifndef SIM_PNG_H
+#define SIM_PNG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Write an RGB565 frame to a PNG file
+ *
+ * @param path Output file
+ * @param pixels Frame, row after row, no padding
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param brightness_permille Backlight level applied to every pixel, 0 to 1000
+ * @return bool true on success
+ */
+bool sim_png_write_rgb565(const char *path, const uint16_t *pixels, uint32_t width, uint32_t height,
+                          uint32_t brightness_permille);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_PNG_H
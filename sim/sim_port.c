@@ -0,0 +1,501 @@
+/*
+ * Host Simulator Port
+ *
+ * Implements the ESP-IDF and FreeRTOS calls of the dashboard sources on the
+ * simulated clock. Timers live in a list in creation order and the next one
+ * due is found by a scan, which is plenty for the handful the dashboard
+ * creates. Tasks are host threads that hand control back and forth
+ * with the main loop: a task only runs while the main loop waits for it, and
+ * the main loop only continues once every task sleeps again.
+ */
+
+#include "sim_port.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/ledc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "task_layout.h"
+
+#define SIM_TICK_US     (1000000 / CONFIG_FREERTOS_HZ)
+
+static const char *TAG = "sim_port";
+
+// The clock is only written by the main loop while every task sleeps
+static _Atomic int64_t s_now_us = 0;
+
+// Guards the timer list, the task list and the task states
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+    bool active;
+    int64_t deadline_us;
+    int64_t period_us;          // 0 for a one-shot timer
+    struct esp_timer *next;
+};
+
+static struct esp_timer *s_timers = NULL;
+
+typedef enum {
+    SIM_TASK_RUNNING = 0,       // Owns the CPU; the main loop waits for it
+    SIM_TASK_BLOCKED,           // Sleeps until wake_us
+    SIM_TASK_EXITED,
+} sim_task_state_t;
+
+struct sim_task {
+    TaskFunction_t fn;
+    void *arg;
+    const char *name;
+    sim_task_state_t state;
+    int64_t wake_us;
+    pthread_t thread;
+    struct sim_task *next;
+};
+
+static struct sim_task *s_tasks = NULL;
+static _Thread_local struct sim_task *s_current_task = NULL;
+
+static const char *const task_role_names[TASK_ROLE_COUNT] = {
+    [TASK_ROLE_LVGL]        = "lvgl",
+    [TASK_ROLE_TELEMETRY]   = "telemetry",
+    [TASK_ROLE_HTTPD]       = "httpd",
+    [TASK_ROLE_WS_PUSH]     = "ws_push",
+    [TASK_ROLE_HTTP_WORKER] = "http_worker",
+};
+
+/**
+ * @brief Print one log line in the ESP-IDF format, stamped with the simulated clock
+ */
+void sim_log_write(char level, const char *tag, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "%c (%lld) %s: ", level, (long long)(atomic_load(&s_now_us) / 1000), tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+/**
+ * @brief Name of an error code
+ */
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                return "ESP_OK";
+    case ESP_FAIL:              return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+    default:                    return "UNKNOWN ERROR";
+    }
+}
+
+/**
+ * @brief Simulated time since the simulator started
+ */
+int64_t esp_timer_get_time(void)
+{
+    return atomic_load(&s_now_us);
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct esp_timer *timer = calloc(1, sizeof(struct esp_timer));
+    if (timer == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+    timer->name = create_args->name;
+
+    // Appended, so timers due at the same time fire in creation order
+    pthread_mutex_lock(&s_lock);
+    struct esp_timer **link = &s_timers;
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+    *link = timer;
+    pthread_mutex_unlock(&s_lock);
+
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t sim_timer_start(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&s_lock);
+    if (timer->active) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = true;
+    timer->deadline_us = atomic_load(&s_now_us) + (int64_t)timeout_us;
+    timer->period_us = (int64_t)period_us;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return sim_timer_start(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return sim_timer_start(timer, period, period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&s_lock);
+    bool was_active = timer->active;
+    timer->active = false;
+    pthread_mutex_unlock(&s_lock);
+    return was_active ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&s_lock);
+    if (timer->active) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (struct esp_timer **link = &s_timers; *link != NULL; link = &(*link)->next) {
+        if (*link == timer) {
+            *link = timer->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    free(timer);
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return false;
+    }
+    pthread_mutex_lock(&s_lock);
+    bool active = timer->active;
+    pthread_mutex_unlock(&s_lock);
+    return active;
+}
+
+/**
+ * @brief Task thread - runs the task function once the creator hands over
+ */
+static void *sim_task_thread(void *arg)
+{
+    struct sim_task *task = (struct sim_task *)arg;
+    s_current_task = task;
+    task->fn(task->arg);
+
+    // FreeRTOS tasks never return; treat it as vTaskDelete(NULL)
+    pthread_mutex_lock(&s_lock);
+    task->state = SIM_TASK_EXITED;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+    return NULL;
+}
+
+/**
+ * @brief Wait until no task runs (s_lock held)
+ */
+static void sim_wait_tasks_idle_locked(void)
+{
+    for (;;) {
+        bool running = false;
+        for (struct sim_task *task = s_tasks; task != NULL; task = task->next) {
+            if (task->state == SIM_TASK_RUNNING) {
+                running = true;
+                break;
+            }
+        }
+        if (!running) {
+            return;
+        }
+        pthread_cond_wait(&s_cond, &s_lock);
+    }
+}
+
+/**
+ * @brief Create the task of a role and let it run until it first sleeps
+ */
+esp_err_t task_layout_create(task_role_t role, TaskFunction_t fn, void *arg, TaskHandle_t *handle)
+{
+    if (role >= TASK_ROLE_COUNT || fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct sim_task *task = calloc(1, sizeof(struct sim_task));
+    if (task == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    task->name = task_role_names[role];
+    task->state = SIM_TASK_RUNNING;
+
+    pthread_mutex_lock(&s_lock);
+    task->next = s_tasks;
+    s_tasks = task;
+    if (pthread_create(&task->thread, NULL, sim_task_thread, task) != 0) {
+        s_tasks = task->next;
+        pthread_mutex_unlock(&s_lock);
+        free(task);
+        ESP_LOGE(TAG, "Failed to create %s task", task_role_names[role]);
+        return ESP_ERR_NO_MEM;
+    }
+    pthread_detach(task->thread);
+    sim_wait_tasks_idle_locked();
+    pthread_mutex_unlock(&s_lock);
+
+    if (handle != NULL) {
+        *handle = task;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Put the calling task to sleep until the simulated clock reaches wake_us
+ */
+static void sim_task_sleep_until(int64_t wake_us)
+{
+    struct sim_task *task = s_current_task;
+    if (task == NULL) {
+        // Only tasks may sleep; the main loop moves the clock itself
+        ESP_LOGE(TAG, "Task delay outside a task");
+        abort();
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (wake_us > atomic_load(&s_now_us)) {
+        task->wake_us = wake_us;
+        task->state = SIM_TASK_BLOCKED;
+        pthread_cond_broadcast(&s_cond);
+        // The main loop sets RUNNING again when the clock gets there
+        while (task->state == SIM_TASK_BLOCKED) {
+            pthread_cond_wait(&s_cond, &s_lock);
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(atomic_load(&s_now_us) / SIM_TICK_US);
+}
+
+void vTaskDelayUntil(TickType_t *previous_wake, TickType_t increment)
+{
+    *previous_wake += increment;
+    sim_task_sleep_until((int64_t)*previous_wake * SIM_TICK_US);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    sim_task_sleep_until((xTaskGetTickCount() + (int64_t)ticks) * SIM_TICK_US);
+}
+
+/**
+ * @brief Earliest timer deadline or task wakeup (s_lock held)
+ */
+static int64_t sim_next_event_locked(void)
+{
+    int64_t next = SIM_CLOCK_NEVER;
+    for (struct esp_timer *timer = s_timers; timer != NULL; timer = timer->next) {
+        if (timer->active && timer->deadline_us < next) {
+            next = timer->deadline_us;
+        }
+    }
+    for (struct sim_task *task = s_tasks; task != NULL; task = task->next) {
+        if (task->state == SIM_TASK_BLOCKED && task->wake_us < next) {
+            next = task->wake_us;
+        }
+    }
+    return next;
+}
+
+int64_t sim_clock_next_event_us(void)
+{
+    pthread_mutex_lock(&s_lock);
+    int64_t next = sim_next_event_locked();
+    pthread_mutex_unlock(&s_lock);
+    return next;
+}
+
+void sim_clock_advance_to(int64_t target_us)
+{
+    pthread_mutex_lock(&s_lock);
+    for (;;) {
+        int64_t next = sim_next_event_locked();
+        if (next > target_us) {
+            break;
+        }
+        if (next > atomic_load(&s_now_us)) {
+            atomic_store(&s_now_us, next);
+        }
+        int64_t now = atomic_load(&s_now_us);
+
+        // Timers first, one at a time: a callback may stop, start or delete timers
+        struct esp_timer *due = NULL;
+        for (struct esp_timer *timer = s_timers; timer != NULL; timer = timer->next) {
+            if (timer->active && timer->deadline_us <= now && (due == NULL || timer->deadline_us < due->deadline_us)) {
+                due = timer;
+            }
+        }
+        if (due != NULL) {
+            if (due->period_us > 0) {
+                due->deadline_us += due->period_us;
+            } else {
+                due->active = false;
+            }
+            esp_timer_cb_t callback = due->callback;
+            void *arg = due->arg;
+            pthread_mutex_unlock(&s_lock);
+            callback(arg);
+            pthread_mutex_lock(&s_lock);
+            continue;
+        }
+
+        // Then every task whose sleep ended, until all of them sleep again
+        for (struct sim_task *task = s_tasks; task != NULL; task = task->next) {
+            if (task->state == SIM_TASK_BLOCKED && task->wake_us <= now) {
+                task->state = SIM_TASK_RUNNING;
+            }
+        }
+        pthread_cond_broadcast(&s_cond);
+        sim_wait_tasks_idle_locked();
+    }
+    if (target_us > atomic_load(&s_now_us)) {
+        atomic_store(&s_now_us, target_us);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+// Backlight channel (one channel, the one display_idle.c configures)
+static uint32_t s_duty_max = 1;
+static uint32_t s_duty = 0;
+static uint32_t s_fade_target = 0;
+static int s_fade_time_ms = 0;
+static bool s_fading = false;
+static uint32_t s_fade_from = 0;
+static int64_t s_fade_start_us = 0;
+
+/**
+ * @brief Duty output right now, following a running fade
+ */
+static uint32_t sim_ledc_current_duty(void)
+{
+    if (!s_fading) {
+        return s_duty;
+    }
+    int64_t elapsed_us = atomic_load(&s_now_us) - s_fade_start_us;
+    int64_t fade_us = (int64_t)s_fade_time_ms * 1000;
+    if (elapsed_us >= fade_us) {
+        s_fading = false;
+        s_duty = s_fade_target;
+        return s_duty;
+    }
+    int64_t delta = (int64_t)s_fade_target - (int64_t)s_fade_from;
+    return (uint32_t)((int64_t)s_fade_from + delta * elapsed_us / fade_us);
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf)
+{
+    if (timer_conf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_duty_max = (1u << timer_conf->duty_resolution) - 1;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf)
+{
+    if (ledc_conf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_duty = ledc_conf->duty;
+    s_fading = false;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_stop(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    (void)speed_mode;
+    (void)channel;
+    s_duty = sim_ledc_current_duty();
+    s_fading = false;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint)
+{
+    (void)speed_mode;
+    (void)channel;
+    (void)hpoint;
+    s_duty = duty;
+    s_fading = false;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty, int max_fade_time_ms)
+{
+    (void)speed_mode;
+    (void)channel;
+    s_fade_target = target_duty;
+    s_fade_time_ms = max_fade_time_ms;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_fade_mode_t fade_mode)
+{
+    (void)speed_mode;
+    (void)channel;
+    (void)fade_mode;
+    s_fade_from = sim_ledc_current_duty();
+    s_fade_start_us = atomic_load(&s_now_us);
+    s_fading = true;
+    return ESP_OK;
+}
+
+uint32_t sim_backlight_get_permille(void)
+{
+    return (uint32_t)(((uint64_t)sim_ledc_current_duty() * 1000) / s_duty_max);
+}
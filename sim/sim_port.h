@@ -0,0 +1,47 @@
+/*
+ * Host Simulator Port Header
+ *
+ * The simulated clock and what runs on it: esp_timer callbacks, the tasks
+ * created through task_layout_create() and the backlight fade. Time only moves
+ * when the main loop calls sim_clock_advance_to(), which runs every timer and
+ * task that falls due on the way, one at a time and in a fixed order, so a
+ * script produces the same frames on every run.
+ */
+
+#ifndef SIM_PORT_H
+#define SIM_PORT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_CLOCK_NEVER     INT64_MAX
+
+/**
+ * @brief Simulated time of the next timer or task wakeup (SIM_CLOCK_NEVER if none)
+ */
+int64_t sim_clock_next_event_us(void);
+
+/**
+ * @brief Move the simulated clock forward, running every timer and task due on the way
+ *
+ * Returns once all tasks are blocked again. Call from the main loop only.
+ *
+ * @param target_us Simulated time to stop at (no effect if not in the future)
+ */
+void sim_clock_advance_to(int64_t target_us);
+
+/**
+ * @brief Backlight level the LEDC channel outputs right now, including a running fade
+ *
+ * @return uint32_t 0 (dark) to 1000 (full brightness)
+ */
+uint32_t sim_backlight_get_permille(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_PORT_H